@@ -0,0 +1,297 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "JobSystem.h"
+#include <deque>
+#include <chrono>
+#include <Core/Util.h>
+#include <Concurrency/Locks/SpinLock.h>
+#include <Concurrency/Locks/ScopedLock.h>
+
+struct JobSystem::GlobalQueue
+{
+    Relic::SpinLock lock;
+    std::deque<Job *> jobs;
+
+    //Lets threads skip the lock entirely while the queue is empty, which is almost always.
+    std::atomic<uint32_t> size{0};
+};
+
+static thread_local JobSystem *currentJobSystem = nullptr;
+static thread_local uint32_t currentThreadIndex = JobSystem::INVALID_THREAD;
+
+JobSystem::JobSystem(uint32_t workerCount) : globalQueue(new GlobalQueue()), sleepingWorkers(0), shuttingDown(false)
+{
+    if (workerCount == DEFAULT_WORKER_COUNT)
+    {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    for (uint32_t i = 0; i < workerCount + 1; i++)
+    {
+        threads.emplace_back(new ThreadData());
+        threads[i]->randomState = i * 2654435761u + 1;
+    }
+
+    //The creating thread is thread 0, unless it's already part of another job system. Taking it over would change its
+    //index under the other one.
+    if (currentJobSystem == nullptr)
+    {
+        currentJobSystem = this;
+        currentThreadIndex = 0;
+    }
+
+    for (uint32_t i = 1; i < workerCount + 1; i++)
+    {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+
+    if (instance == nullptr) instance = this;
+}
+
+JobSystem::~JobSystem()
+{
+    shuttingDown.store(true);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_all();
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    if (currentJobSystem == this)
+    {
+        currentJobSystem = nullptr;
+        currentThreadIndex = INVALID_THREAD;
+    }
+
+    if (instance == this) instance = nullptr;
+}
+
+JobSystem *JobSystem::GetInstance()
+{
+    return instance;
+}
+
+uint32_t JobSystem::ThreadCount() const
+{
+    return (uint32_t) threads.size();
+}
+
+uint32_t JobSystem::ThreadIndex() const
+{
+    return currentJobSystem == this ? currentThreadIndex : INVALID_THREAD;
+}
+
+Job *JobSystem::AllocateJob()
+{
+    uint32_t index = ThreadIndex();
+
+    if (index != INVALID_THREAD)
+    {
+        ThreadData &data = *threads[index];
+        Job *job = &data.jobs[data.nextJob++ & (JOB_POOL_SIZE - 1)];
+
+        //Only fall back to the heap if the ring has wrapped around onto a job that is still pending.
+        if (job->inUse.load(std::memory_order_acquire) == 0)
+        {
+            job->inUse.store(1, std::memory_order_relaxed);
+            job->flags = 0;
+            return job;
+        }
+    }
+
+    Job *job = new Job();
+    job->inUse.store(1, std::memory_order_relaxed);
+    job->flags = Job::FLAG_HEAP_ALLOCATED;
+    return job;
+}
+
+void JobSystem::Submit(Job *job)
+{
+    uint32_t index = ThreadIndex();
+
+    if (index != INVALID_THREAD)
+    {
+        if (!threads[index]->queue.Push(job))
+        {
+            //Queue is full, running the job right away is the only way to make progress.
+            Execute(job);
+            return;
+        }
+    } else
+    {
+        Relic::ScopedLock<Relic::SpinLock> lock(globalQueue->lock);
+        globalQueue->jobs.push_back(job);
+        globalQueue->size.fetch_add(1, std::memory_order_release);
+    }
+
+    if (sleepingWorkers.load(std::memory_order_relaxed) > 0)
+    {
+        sleepCondition.notify_one();
+    }
+}
+
+Job *JobSystem::FindJob(uint32_t threadIndex)
+{
+    if (threadIndex != INVALID_THREAD)
+    {
+        Job *job = threads[threadIndex]->queue.Pop();
+        if (job) return job;
+    }
+
+    if (globalQueue->size.load(std::memory_order_acquire) > 0)
+    {
+        Relic::ScopedLock<Relic::SpinLock> lock(globalQueue->lock);
+        if (!globalQueue->jobs.empty())
+        {
+            Job *job = globalQueue->jobs.front();
+            globalQueue->jobs.pop_front();
+            globalQueue->size.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    //Start stealing at a random victim so thieves don't all pile onto the same queue.
+    uint32_t start = 0;
+    if (threadIndex != INVALID_THREAD)
+    {
+        uint32_t &state = threads[threadIndex]->randomState;
+        state ^= state << 13u;
+        state ^= state >> 17u;
+        state ^= state << 5u;
+        start = state;
+    }
+
+    uint32_t count = ThreadCount();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t victim = (start + i) % count;
+        if (victim == threadIndex) continue;
+
+        Job *job = threads[victim]->queue.Steal();
+        if (job) return job;
+    }
+
+    return nullptr;
+}
+
+void JobSystem::Execute(Job *job)
+{
+    std::exception_ptr exception;
+    try
+    {
+        job->function(*job);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    JobCounter *counter = job->counter;
+
+    if (job->flags & Job::FLAG_HEAP_ALLOCATED)
+    {
+        delete job;
+    } else
+    {
+        job->inUse.store(0, std::memory_order_release);
+    }
+
+    if (exception)
+    {
+        if (counter == nullptr) std::rethrow_exception(exception);
+
+        //Only the first one is kept, the decrement below publishes it to the waiter.
+        if (!counter->failed.exchange(true, std::memory_order_relaxed)) counter->exception = exception;
+    }
+
+    //Decrement last, waiters are free to destroy the counter as soon as it hits zero.
+    if (counter) counter->count.fetch_sub(1, std::memory_order_release);
+}
+
+bool JobSystem::RunPendingJob()
+{
+    Job *job = FindJob(ThreadIndex());
+    if (!job) return false;
+
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Wait(JobCounter &counter)
+{
+    uint32_t idle = 0;
+
+    while (!counter.IsDone())
+    {
+        if (RunPendingJob())
+        {
+            idle = 0;
+        } else if (++idle < YIELD_COUNT)
+        {
+            PAUSE();
+        } else
+        {
+            //The remaining jobs are running on other threads, give them the core.
+            std::this_thread::yield();
+        }
+    }
+
+    if (counter.failed.load(std::memory_order_relaxed))
+    {
+        //Reset, so the counter can be used again.
+        std::exception_ptr exception = std::move(counter.exception);
+        counter.exception = nullptr;
+        counter.failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(exception);
+    }
+}
+
+void JobSystem::WorkerLoop(uint32_t threadIndex)
+{
+    currentJobSystem = this;
+    currentThreadIndex = threadIndex;
+
+    uint32_t idle = 0;
+
+    while (!shuttingDown.load(std::memory_order_relaxed))
+    {
+        Job *job = FindJob(threadIndex);
+        if (job)
+        {
+            Execute(job);
+            idle = 0;
+            continue;
+        }
+
+        //Back off gradually: spin, then yield, then sleep until new work shows up.
+        idle++;
+        if (idle < SPIN_COUNT)
+        {
+            PAUSE();
+        } else if (idle < YIELD_COUNT)
+        {
+            std::this_thread::yield();
+        } else
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (shuttingDown.load(std::memory_order_relaxed)) break;
+
+            sleepingWorkers.fetch_add(1, std::memory_order_relaxed);
+            //Submitters notify without taking the lock, the timeout covers a wake up slipping through.
+            sleepCondition.wait_for(lock, std::chrono::milliseconds(1));
+            sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    currentJobSystem = nullptr;
+    currentThreadIndex = INVALID_THREAD;
+}
+
+JobSystem *JobSystem::instance = nullptr;
@@ -0,0 +1,195 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_JOBSYSTEM_H
+#define RELIC_JOBSYSTEM_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "WorkStealingQueue.h"
+
+/// Wait handle for a group of jobs. Every job started with a counter increments it, and decrements it once it has
+/// finished running. If a job throws, the first exception is kept and rethrown by JobSystem::Wait.
+class JobCounter
+{
+public:
+    JobCounter() : count(0)
+    {}
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    /// Whether every job attached to this counter has completed.
+    [[nodiscard]] bool IsDone() const
+    {
+        return count.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int32_t> count;
+
+    //Set by the first job that throws, before it decrements the count.
+    std::atomic<bool> failed{false};
+    std::exception_ptr exception;
+};
+
+/// A single unit of work. Jobs are exactly one cache line, small callables are stored inline so spawning a job never
+/// has to touch the heap.
+struct alignas(64) Job
+{
+    typedef void (*Function)(Job &job);
+
+    static constexpr uint32_t FLAG_HEAP_ALLOCATED = 1u << 0u;
+    static constexpr size_t PAYLOAD_SIZE = 40;
+
+    Function function;
+    JobCounter *counter;
+
+    //Non-zero while the job is queued or running, ring allocated jobs can't be reused until this is cleared.
+    std::atomic<uint32_t> inUse;
+    uint32_t flags;
+
+    alignas(8) unsigned char payload[PAYLOAD_SIZE];
+};
+
+static_assert(sizeof(Job) == 64, "Job should fit in a single cache line.");
+
+/// Work stealing job system. Each thread owns a lock-free deque, threads pop their own jobs and steal from the others
+/// when they run dry. The thread that creates the job system becomes thread 0 and takes part by helping while it waits,
+/// unless it already belongs to another job system. It then submits through the global queue like any outside thread.
+class JobSystem
+{
+public:
+    /// Create a job system.
+    /// \param workerCount Number of worker threads to spawn, by default one per hardware thread (excluding the caller).
+    explicit JobSystem(uint32_t workerCount = DEFAULT_WORKER_COUNT);
+
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    static JobSystem *GetInstance();
+
+    /// Queue a callable to run on any thread.
+    /// \param function The callable to run, it must be invocable without arguments.
+    /// \param counter Optional counter to track the job with, it must outlive the job. Exceptions thrown by the job are
+    /// passed on to whoever waits on it. Without a counter there's nobody to pass them to, so they propagate from
+    /// whichever thread ran the job, which terminates if that's a worker.
+    template<typename F>
+    void Run(F &&function, JobCounter *counter = nullptr);
+
+    /// Block until every job attached to the counter has finished, running other jobs in the meantime.
+    /// \param counter The counter to wait on.
+    /// \throws The first exception thrown by one of the counter's jobs, once all of them have finished.
+    void Wait(JobCounter &counter);
+
+    /// Run a single pending job on the calling thread, for threads that need to wait on something other than a counter.
+    /// \return True if a job was run.
+    bool RunPendingJob();
+
+    /// Number of threads that execute jobs, including the thread that created the job system.
+    [[nodiscard]] uint32_t ThreadCount() const;
+
+    /// Index of the calling thread in this job system, 0 is the owning thread.
+    /// \return The index, or INVALID_THREAD if the calling thread doesn't belong to this job system.
+    [[nodiscard]] uint32_t ThreadIndex() const;
+
+    static constexpr uint32_t INVALID_THREAD = UINT32_MAX;
+    static constexpr uint32_t DEFAULT_WORKER_COUNT = UINT32_MAX;
+
+private:
+    static constexpr size_t JOB_POOL_SIZE = 4096;
+    static constexpr uint32_t SPIN_COUNT = 64;
+    static constexpr uint32_t YIELD_COUNT = 128;
+
+    struct ThreadData
+    {
+        WorkStealingQueue<Job> queue;
+        Job jobs[JOB_POOL_SIZE];
+        uint32_t nextJob = 0;
+        uint32_t randomState = 0;
+    };
+
+    struct GlobalQueue;
+
+    Job *AllocateJob();
+
+    void Submit(Job *job);
+
+    Job *FindJob(uint32_t threadIndex);
+
+    void Execute(Job *job);
+
+    void WorkerLoop(uint32_t threadIndex);
+
+    std::vector<std::unique_ptr<ThreadData>> threads;
+    std::vector<std::thread> workers;
+
+    //Jobs submitted from threads that don't belong to the job system.
+    std::unique_ptr<GlobalQueue> globalQueue;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<uint32_t> sleepingWorkers;
+    std::atomic<bool> shuttingDown;
+
+    static JobSystem *instance;
+};
+
+template<typename F>
+void JobSystem::Run(F &&function, JobCounter *counter)
+{
+    using Functor = std::decay_t<F>;
+
+    Job *job = AllocateJob();
+    job->counter = counter;
+
+    if constexpr (sizeof(Functor) <= Job::PAYLOAD_SIZE && alignof(Functor) <= 8)
+    {
+        new(job->payload) Functor(std::forward<F>(function));
+        job->function = [](Job &job)
+        {
+            //Destroyed even if the call throws.
+            struct Destroy
+            {
+                Functor *functor;
+
+                ~Destroy()
+                { functor->~Functor(); }
+            } destroy{std::launder(reinterpret_cast<Functor *>(job.payload))};
+
+            (*destroy.functor)();
+        };
+    } else
+    {
+        //Too big to store inline, keep a pointer to a heap copy instead.
+        auto *functor = new Functor(std::forward<F>(function));
+        std::memcpy(job->payload, &functor, sizeof(functor));
+        job->function = [](Job &job)
+        {
+            Functor *functor;
+            std::memcpy(&functor, job.payload, sizeof(functor));
+            std::unique_ptr<Functor> owned(functor);
+            (*owned)();
+        };
+    }
+
+    if (counter) counter->count.fetch_add(1, std::memory_order_relaxed);
+    Submit(job);
+}
+
+#endif //RELIC_JOBSYSTEM_H
@@ -0,0 +1,106 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include <string>
+#include <cmath>
+#include "JobSystem.h"
+#include <Debugging/Benchmark.h>
+#include <Debugging/Logger.h>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static const uint32_t OVERHEAD_JOB_COUNT = 1000000;
+static const uint32_t SCALING_JOB_COUNT = 4096;
+static const uint32_t SCALING_JOB_ITERATIONS = 20000;
+
+static std::atomic<uint64_t> benchmarkSink(0);
+
+/// Cost of spawning and running an empty job without any other threads involved.
+static void MeasureSpawnOverhead()
+{
+    JobSystem jobSystem(0);
+    JobCounter counter;
+
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < OVERHEAD_JOB_COUNT; i++)
+    {
+        jobSystem.Run([]()
+                      {}, &counter);
+
+        //Drain as we go, the deque only holds so many jobs.
+        if ((i & 1023u) == 1023u) jobSystem.Wait(counter);
+    }
+    jobSystem.Wait(counter);
+    double seconds = Benchmark::SecondsSince(start);
+
+    Logger::Log("Spawn + run (single thread): %sns/job", std::to_string(seconds * 1e9 / OVERHEAD_JOB_COUNT).c_str());
+}
+
+/// Cost of a job that has to be stolen by a worker, the owning thread never helps.
+static void MeasureStealOverhead()
+{
+    JobSystem jobSystem(1);
+    JobCounter counter;
+
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < OVERHEAD_JOB_COUNT; i += 1024)
+    {
+        for (uint32_t j = 0; j < 1024; j++)
+        {
+            jobSystem.Run([]()
+                          {}, &counter);
+        }
+
+        while (!counter.IsDone())
+        {
+            std::this_thread::yield();
+        }
+    }
+    double seconds = Benchmark::SecondsSince(start);
+
+    Logger::Log("Spawn + steal (1 worker): %sns/job", std::to_string(seconds * 1e9 / OVERHEAD_JOB_COUNT).c_str());
+}
+
+/// Time a fixed amount of ALU bound work spread over an increasing number of threads.
+static void MeasureScaling()
+{
+    uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    double baseline = 0.0;
+
+    for (uint32_t threadCount = 1; threadCount <= hardwareThreads; threadCount++)
+    {
+        JobSystem jobSystem(threadCount - 1);
+        JobCounter counter;
+
+        auto start = Clock::now();
+        for (uint32_t i = 0; i < SCALING_JOB_COUNT; i++)
+        {
+            jobSystem.Run([i]()
+                          {
+                              float value = (float) i;
+                              for (uint32_t j = 0; j < SCALING_JOB_ITERATIONS; j++)
+                              {
+                                  value = std::sqrt(value * value + 1.0f);
+                              }
+                              benchmarkSink.fetch_add((uint64_t) value, std::memory_order_relaxed);
+                          }, &counter);
+        }
+        jobSystem.Wait(counter);
+        double seconds = Benchmark::SecondsSince(start);
+
+        if (threadCount == 1) baseline = seconds;
+
+        Logger::Log("%i thread(s): %sms, %sx speedup", threadCount, std::to_string(seconds * 1000.0).c_str(),
+                    std::to_string(baseline / seconds).c_str());
+    }
+}
+
+static void RunJobSystemBenchmark()
+{
+    MeasureSpawnOverhead();
+    MeasureStealOverhead();
+    MeasureScaling();
+}
+
+static BenchmarkRegistrar registrar("jobs", &RunJobSystemBenchmark);
@@ -0,0 +1,142 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_PARALLELFOR_H
+#define RELIC_PARALLELFOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <Libraries/entt/entt.hpp>
+#include "JobSystem.h"
+
+static constexpr size_t PARALLEL_CACHE_LINE_SIZE = 64;
+
+//Spawning a job costs about as much as a few hundred trivial iterations, so never split work finer than this.
+static constexpr size_t PARALLEL_MIN_GRAIN = 256;
+
+//Split into a few chunks per thread, so stealing can even out chunks that take longer than others.
+static constexpr size_t PARALLEL_CHUNKS_PER_THREAD = 4;
+
+/// Pick the number of elements processed per job.
+/// \param count Total number of elements.
+/// \param elementSize Size of a single element, chunks are rounded to whole cache lines of these.
+/// \param grain Requested chunk size, 0 picks one based on the element count and number of threads.
+/// \return The chunk size.
+inline size_t ParallelGrain(size_t count, size_t elementSize, size_t grain = 0)
+{
+    if (grain == 0)
+    {
+        JobSystem *jobSystem = JobSystem::GetInstance();
+        size_t threads = jobSystem ? jobSystem->ThreadCount() : 1;
+        grain = std::max(PARALLEL_MIN_GRAIN, count / (threads * PARALLEL_CHUNKS_PER_THREAD));
+    }
+
+    //Chunks that start on a cache line boundary never write to the same line as their neighbours.
+    size_t elementsPerLine = std::max<size_t>(1, PARALLEL_CACHE_LINE_SIZE / std::max<size_t>(1, elementSize));
+    return (grain + elementsPerLine - 1) / elementsPerLine * elementsPerLine;
+}
+
+/// Run a function over the range [0, count) split into chunks across the job system. The calling thread processes a
+/// chunk itself and helps out until every chunk has finished.
+/// \param count Number of elements.
+/// \param function Callable taking (size_t begin, size_t end).
+/// \param grain Elements per chunk, 0 picks one automatically.
+/// \param elementSize Size of the elements being written, used to keep chunks cache line aligned.
+template<typename F>
+void ParallelFor(size_t count, F &&function, size_t grain = 0, size_t elementSize = 1)
+{
+    if (count == 0) return;
+
+    JobSystem *jobSystem = JobSystem::GetInstance();
+    grain = ParallelGrain(count, elementSize, grain);
+
+    //Not worth the overhead, just run it here.
+    if (jobSystem == nullptr || jobSystem->ThreadCount() == 1 || count <= grain)
+    {
+        function((size_t) 0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = grain; begin < count; begin += grain)
+    {
+        size_t end = std::min(begin + grain, count);
+        jobSystem->Run([&function, begin, end]()
+                       {
+                           function(begin, end);
+                       }, &counter);
+    }
+
+    function((size_t) 0, grain);
+    jobSystem->Wait(counter);
+}
+
+/// Size of the largest component of a view or group, the element size ParallelEach rounds chunks to when it isn't
+/// given one. Anything else falls back to the size of an entity.
+template<typename>
+struct ParallelComponentSize
+{
+    static constexpr size_t value = sizeof(entt::entity);
+};
+
+template<typename Entity, typename... Exclude, typename... Component>
+struct ParallelComponentSize<entt::basic_view<Entity, entt::exclude_t<Exclude...>, Component...>>
+{
+    static constexpr size_t value = std::max({sizeof(Component)...});
+};
+
+template<typename Entity, typename... Exclude, typename... Get, typename... Owned>
+struct ParallelComponentSize<entt::basic_group<Entity, entt::exclude_t<Exclude...>, entt::get_t<Get...>, Owned...>>
+{
+    static constexpr size_t value = std::max({sizeof(Get)..., sizeof(Owned)...});
+};
+
+/// Run a function for every entity in an owning group, non-owning group or single component view, in parallel.
+/// Entities must not be created or destroyed, and components of the iterated types must not be added or removed,
+/// until this returns.
+/// \param view The group or view to iterate.
+/// \param function Callable taking the entity.
+/// \param grain Entities per chunk, 0 picks one automatically.
+/// \param elementSize Size of the component being written, 0 uses the largest component of the view.
+template<typename View, typename F>
+void ParallelEach(const View &view, F &&function, size_t grain = 0, size_t elementSize = 0)
+{
+    const auto *entities = view.data();
+
+    ParallelFor(view.size(), [entities, &function](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            function(entities[i]);
+        }
+    }, grain, elementSize != 0 ? elementSize : ParallelComponentSize<View>::value);
+}
+
+/// Run a function for every entity in a multi component view, in parallel. The smallest pool of the view is split
+/// into chunks, and entities that aren't part of the view are skipped.
+/// \param elementSize Size of the component being written, 0 uses the largest component of the view.
+template<typename Entity, typename... Exclude, typename... Component, typename F,
+        typename = std::enable_if_t<(sizeof...(Component) > 1)>>
+void ParallelEach(const entt::basic_view<Entity, entt::exclude_t<Exclude...>, Component...> &view, F &&function,
+                  size_t grain = 0, size_t elementSize = 0)
+{
+    const Entity *entities = nullptr;
+    size_t count = SIZE_MAX;
+
+    ((view.template size<Component>() < count
+      ? (count = view.template size<Component>(), entities = view.template data<Component>(), 0)
+      : 0), ...);
+
+    ParallelFor(count, [&view, entities, &function](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (view.contains(entities[i])) function(entities[i]);
+        }
+    }, grain, elementSize != 0 ? elementSize : std::max({sizeof(Component)...}));
+}
+
+#endif //RELIC_PARALLELFOR_H
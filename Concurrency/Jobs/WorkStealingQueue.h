@@ -0,0 +1,107 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_WORKSTEALINGQUEUE_H
+#define RELIC_WORKSTEALINGQUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/// Fixed size lock-free Chase-Lev deque. The owning thread pushes and pops from the bottom, any other thread can steal
+/// from the top.
+template<typename T, size_t CAPACITY = 4096>
+class WorkStealingQueue
+{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "WorkStealingQueue capacity must be a power of two.");
+
+private:
+    static constexpr int64_t MASK = CAPACITY - 1;
+
+    //Keep the ends on separate cache lines, the owner hammers bottom while thieves hammer top.
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    alignas(64) std::atomic<T *> items[CAPACITY];
+
+public:
+    WorkStealingQueue() : top(0), bottom(0)
+    {
+        for (auto &item : items) item.store(nullptr, std::memory_order_relaxed);
+    }
+
+    /// Push an item onto the bottom of the queue. [Owner only]
+    /// \param item The item to push.
+    /// \return False if the queue is full.
+    bool Push(T *item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+
+        if (b - t >= (int64_t) CAPACITY) return false;
+
+        items[b & MASK].store(item, std::memory_order_relaxed);
+        //Publishes the item (and whatever it points to) to thieves.
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pop the most recently pushed item. [Owner only]
+    /// \return The item, or nullptr if the queue is empty.
+    T *Pop()
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            //Already empty.
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *item = items[b & MASK].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            //Last item, race any thieves for it.
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    /// Steal the oldest item. [Any thread]
+    /// \return The item, or nullptr if the queue was empty or another thread got there first.
+    T *Steal()
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) return nullptr;
+
+        T *item = items[t & MASK].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+
+        return item;
+    }
+
+    /// Approximate number of items in the queue.
+    [[nodiscard]] size_t Size() const
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? (size_t) (b - t) : 0;
+    }
+};
+
+#endif //RELIC_WORKSTEALINGQUEUE_H
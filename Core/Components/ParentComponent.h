@@ -0,0 +1,18 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_PARENTCOMPONENT_H
+#define RELIC_PARENTCOMPONENT_H
+
+#include <Libraries/entt/entt.hpp>
+
+/// Attaches an entity's transform to another entity, so its TransformComponent is relative to the parent's world
+/// transform. Change the parent through emplace, replace or patch so TransformHierarchy sees the change, writing to
+/// the component directly isn't picked up. If the parent is destroyed the entity becomes a root.
+struct ParentComponent
+{
+    entt::entity parent;
+};
+
+#endif //RELIC_PARENTCOMPONENT_H
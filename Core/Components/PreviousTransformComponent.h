@@ -0,0 +1,18 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_PREVIOUSTRANSFORMCOMPONENT_H
+#define RELIC_PREVIOUSTRANSFORMCOMPONENT_H
+
+#include "TransformComponent.h"
+
+/// Opts an entity into render interpolation. Holds the transform from before the latest tick, TransformHierarchy
+/// blends between it and the current transform using SingletonTime::alpha. Only add this to entities moved from Tick, anything
+/// moved from FrameTick is already up to date.
+struct PreviousTransformComponent
+{
+    TransformComponent transform;
+};
+
+#endif //RELIC_PREVIOUSTRANSFORMCOMPONENT_H
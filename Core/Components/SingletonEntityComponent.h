@@ -0,0 +1,14 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_SINGLETONENTITYCOMPONENT_H
+#define RELIC_SINGLETONENTITYCOMPONENT_H
+
+/// Marks an entity that holds singleton components. These entities belong to the systems that created them, so world
+/// snapshots leave them out when capturing and keep them alive when restoring.
+struct SingletonEntityComponent
+{
+};
+
+#endif //RELIC_SINGLETONENTITYCOMPONENT_H
@@ -5,15 +5,36 @@
 #ifndef RELIC_SINGLETONTIME_H
 #define RELIC_SINGLETONTIME_H
 
+#include <cstdint>
+
 struct SingletonTime
 {
+    //Seconds since startup, sampled once at the start of every frame.
     float currentTime;
     float lastFrameTime;
     float lastTickTime;
 
+    //Length of a single simulation step, every Tick advances the simulation by exactly this much.
+    float tickLength = 1.0f / 30.0f;
+
+    //Cap on catch up ticks per frame, so one slow frame can't make every following frame slower.
+    uint32_t maxTicksPerFrame = 5;
+
+    //Elapsed time that hasn't been simulated yet.
+    float accumulator;
+
+    //How far the current frame is between the previous and the latest tick, in [0, 1). Used to interpolate rendering.
+    float alpha;
+
+    uint32_t ticksThisFrame;
+    uint64_t tickCount;
+
+    //Total time thrown away because the tick cap was hit.
+    float droppedTime;
+
     float TickDelta()
     {
-        return currentTime - lastTickTime;
+        return tickLength;
     }
 
     float FrameDelta()
@@ -22,4 +43,4 @@ struct SingletonTime
     }
 };
 
-#endif //RELIC_SINGLETONTIME_H
+#endif //RELIC_SINGLETONTIME_H
\ No newline at end of file
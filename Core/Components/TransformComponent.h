@@ -6,8 +6,13 @@
 #define RELIC_TRANSFORMCOMPONENT_H
 
 #include <glm/vec3.hpp>
+#include <glm/common.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
+/// Position, scale and rotation of an entity, relative to its parent if it has a ParentComponent. Change it through
+/// patch or replace so TransformHierarchy sees the change, writing to the component directly isn't picked up.
 struct TransformComponent
 {
     glm::vec3 position;
@@ -15,4 +20,30 @@ struct TransformComponent
     glm::quat rotation;
 };
 
+/// Blend between two transforms.
+/// \param from The transform at alpha 0.
+/// \param to The transform at alpha 1.
+/// \param alpha Blend factor.
+/// \return The blended transform.
+inline TransformComponent Interpolate(const TransformComponent &from, const TransformComponent &to, float alpha)
+{
+    return {glm::mix(from.position, to.position, alpha),
+            glm::mix(from.scale, to.scale, alpha),
+            glm::slerp(from.rotation, to.rotation, alpha)};
+}
+
+/// Build the matrix that takes a point from the transform's local space to its parent's space. Scales, then rotates,
+/// then translates.
+/// \param transform The transform.
+/// \return The matrix.
+inline glm::mat4 ToMatrix(const TransformComponent &transform)
+{
+    glm::mat4 matrix = glm::mat4_cast(transform.rotation);
+    matrix[0] *= transform.scale.x;
+    matrix[1] *= transform.scale.y;
+    matrix[2] *= transform.scale.z;
+    matrix[3] = glm::vec4(transform.position, 1.0f);
+    return matrix;
+}
+
 #endif //RELIC_TRANSFORMCOMPONENT_H
@@ -0,0 +1,23 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_WORLDBOUNDSCOMPONENT_H
+#define RELIC_WORLDBOUNDSCOMPONENT_H
+
+#include <Graphics/Model.h>
+
+/// World space bounds of an entity's mesh, maintained by the WorldBounds system for every entity with a MeshComponent.
+/// Read only outside of WorldBounds.
+struct WorldBoundsComponent
+{
+    Bounds bounds;
+
+    //Needs recalculating even if the world transform hasn't changed, set when the mesh changes.
+    bool dirty = true;
+
+    //Whether the bounds changed during the last update.
+    bool changed = false;
+};
+
+#endif //RELIC_WORLDBOUNDSCOMPONENT_H
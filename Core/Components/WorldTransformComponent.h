@@ -0,0 +1,35 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_WORLDTRANSFORMCOMPONENT_H
+#define RELIC_WORLDTRANSFORMCOMPONENT_H
+
+#include <Libraries/entt/entt.hpp>
+#include <glm/mat4x4.hpp>
+#include "TransformComponent.h"
+
+/// Cached world matrix of an entity, maintained by TransformHierarchy for every entity with a TransformComponent. Read
+/// only outside of TransformHierarchy.
+struct WorldTransformComponent
+{
+    glm::mat4 matrix;
+
+    //The local transform the matrix was last built from, an interpolated entity that came to rest is skipped.
+    TransformComponent local;
+
+    //Resolved parent, null for roots. Only valid while the hierarchy hasn't changed.
+    entt::entity parent = entt::null;
+    uint32_t depth = 0;
+
+    //Needs rebuilding regardless of whether the local transform changed.
+    bool dirty = true;
+
+    //Queued for the current update.
+    bool queued = false;
+
+    //Whether the matrix changed during the last update, children of a changed entity are rebuilt too.
+    bool changed = false;
+};
+
+#endif //RELIC_WORLDTRANSFORMCOMPONENT_H
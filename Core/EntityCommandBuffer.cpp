@@ -0,0 +1,184 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "EntityCommandBuffer.h"
+#include <algorithm>
+#include <tuple>
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+    Reset();
+}
+
+DeferredEntity EntityCommandBuffer::Create()
+{
+    return DeferredEntity{createCount++};
+}
+
+void EntityCommandBuffer::Destroy(entt::entity entity)
+{
+    commands.push_back({Phase::Destroy, false, 0, entity, 0, nullptr, nullptr, nullptr});
+}
+
+bool EntityCommandBuffer::Empty() const
+{
+    return commands.empty() && createCount == 0;
+}
+
+void *EntityCommandBuffer::AllocatePayload(size_t size, size_t alignment)
+{
+    while (currentChunk < chunks.size())
+    {
+        PayloadChunk &chunk = chunks[currentChunk];
+        size_t offset = (chunk.used + alignment - 1) & ~(alignment - 1);
+
+        if (offset + size <= chunk.size)
+        {
+            chunk.used = offset + size;
+            return chunk.data.get() + offset;
+        }
+
+        currentChunk++;
+    }
+
+    //new[] only guarantees fundamental alignment, over allocate so the first payload can always be aligned.
+    size_t chunkSize = std::max(PAYLOAD_CHUNK_SIZE, size + alignment);
+    chunks.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[chunkSize]), chunkSize, 0});
+    currentChunk = chunks.size() - 1;
+
+    PayloadChunk &chunk = chunks.back();
+    size_t address = reinterpret_cast<size_t>(chunk.data.get());
+    size_t offset = ((address + alignment - 1) & ~(alignment - 1)) - address;
+    chunk.used = offset + size;
+    return chunk.data.get() + offset;
+}
+
+void EntityCommandBuffer::Reset()
+{
+    //Payloads that were played back have been moved from, but still need destroying.
+    for (auto &command : commands)
+    {
+        if (command.destroy) command.destroy(command.payload);
+    }
+
+    commands.clear();
+    createCount = 0;
+
+    for (auto &chunk : chunks)
+    {
+        chunk.used = 0;
+    }
+    currentChunk = 0;
+}
+
+void EntityCommandBuffer::Swap(EntityCommandBuffer &other)
+{
+    std::swap(commands, other.commands);
+    std::swap(chunks, other.chunks);
+    std::swap(currentChunk, other.currentChunk);
+    std::swap(createCount, other.createCount);
+}
+
+void EntityCommandBuffer::Playback(entt::registry &registry, const std::vector<std::unique_ptr<EntityCommandBuffer>> &buffers)
+{
+    //Applying commands fires signals, and listeners may record through World::Commands() into these same buffers. So
+    //each round takes what has been recorded out of them first, new commands then go into the (already cleared)
+    //storage of the previous round and get applied by the next one.
+    std::vector<std::unique_ptr<EntityCommandBuffer>> recorded;
+    recorded.reserve(buffers.size());
+    for (size_t i = 0; i < buffers.size(); i++)
+    {
+        recorded.emplace_back(new EntityCommandBuffer());
+    }
+
+    while (true)
+    {
+        bool empty = true;
+        for (size_t i = 0; i < buffers.size(); i++)
+        {
+            empty = empty && buffers[i]->Empty();
+            buffers[i]->Swap(*recorded[i]);
+        }
+
+        if (empty) break;
+
+        Apply(registry, recorded);
+
+        for (auto &buffer : recorded)
+        {
+            buffer->Reset();
+        }
+    }
+}
+
+void EntityCommandBuffer::Apply(entt::registry &registry, const std::vector<std::unique_ptr<EntityCommandBuffer>> &buffers)
+{
+    struct PendingCommand
+    {
+        Phase phase;
+        entt::id_type component;
+        entt::entity entity;
+        uint64_t sequence;
+        const Command *command;
+    };
+
+    //Create every deferred entity in one batch.
+    uint32_t totalCreates = 0;
+    size_t totalCommands = 0;
+    for (auto &buffer : buffers)
+    {
+        totalCreates += buffer->createCount;
+        totalCommands += buffer->commands.size();
+    }
+
+    if (totalCreates == 0 && totalCommands == 0) return;
+
+    std::vector<entt::entity> created(totalCreates);
+    registry.create(created.begin(), created.end());
+
+    std::vector<PendingCommand> pending;
+    pending.reserve(totalCommands);
+
+    uint32_t createBase = 0;
+    for (size_t b = 0; b < buffers.size(); b++)
+    {
+        auto &buffer = *buffers[b];
+        for (size_t c = 0; c < buffer.commands.size(); c++)
+        {
+            const Command &command = buffer.commands[c];
+            entt::entity entity = command.deferred ? created[createBase + command.deferredIndex] : command.entity;
+            pending.push_back({command.phase, command.component, entity, ((uint64_t) b << 32u) | c, &command});
+        }
+        createBase += buffer.createCount;
+    }
+
+    //The recording order breaks ties, so the last write to a component wins.
+    std::sort(pending.begin(), pending.end(), [](const PendingCommand &lhs, const PendingCommand &rhs)
+    {
+        return std::tie(lhs.phase, lhs.component, lhs.entity, lhs.sequence) <
+               std::tie(rhs.phase, rhs.component, rhs.entity, rhs.sequence);
+    });
+
+    std::vector<entt::entity> destroyed;
+
+    for (auto &command : pending)
+    {
+        if (command.phase == Phase::Destroy)
+        {
+            //Sorted by entity, so duplicate destroys sit next to each other.
+            if (registry.valid(command.entity) && (destroyed.empty() || destroyed.back() != command.entity))
+            {
+                destroyed.push_back(command.entity);
+            }
+            continue;
+        }
+
+        //The entity may have been destroyed directly since the command was recorded.
+        if (!registry.valid(command.entity)) continue;
+
+        command.command->apply(registry, command.entity, command.command->payload);
+    }
+
+    registry.destroy(destroyed.begin(), destroyed.end());
+}
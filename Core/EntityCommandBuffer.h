@@ -0,0 +1,179 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_ENTITYCOMMANDBUFFER_H
+#define RELIC_ENTITYCOMMANDBUFFER_H
+
+#include <Libraries/entt/entt.hpp>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Handle to an entity that will be created when the command buffer that recorded it is played back. Only valid with
+/// the command buffer that created it.
+struct DeferredEntity
+{
+    uint32_t index;
+};
+
+/// Records structural changes (creating and destroying entities, adding and removing components) so they can be made
+/// at a sync point instead of while systems are iterating. Every thread gets its own buffer through World::Commands(),
+/// so recording never needs a lock.
+///
+/// Playback merges the buffers of a world and applies changes in phase order: creates, then emplaces, then removes,
+/// then destroys. Within a phase commands are sorted by component type and entity, so each pool is touched in one go.
+class EntityCommandBuffer
+{
+public:
+    EntityCommandBuffer() = default;
+
+    EntityCommandBuffer(const EntityCommandBuffer &) = delete;
+    EntityCommandBuffer &operator=(const EntityCommandBuffer &) = delete;
+
+    ~EntityCommandBuffer();
+
+    /// Queue the creation of an entity.
+    /// \return A handle that can be used to add components to the entity before it exists.
+    DeferredEntity Create();
+
+    /// Queue adding a component to an entity, replacing it if the entity already has one.
+    /// \param entity The entity to add the component to.
+    /// \param args Arguments to construct the component with.
+    template<typename T, typename... Args>
+    void Emplace(entt::entity entity, Args &&... args);
+
+    /// Queue adding a component to an entity created by this buffer.
+    template<typename T, typename... Args>
+    void Emplace(DeferredEntity entity, Args &&... args);
+
+    /// Queue removing a component from an entity, if it has one.
+    template<typename T>
+    void Remove(entt::entity entity);
+
+    /// Queue destroying an entity.
+    void Destroy(entt::entity entity);
+
+    [[nodiscard]] bool Empty() const;
+
+    /// Apply every command recorded in a set of buffers, then clear them. Signal listeners may record more commands into
+    /// the same buffers while this runs, those are applied before it returns.
+    /// \param registry The registry to apply the commands to.
+    /// \param buffers The buffers to play back, in a fixed order so playback is deterministic.
+    static void Playback(entt::registry &registry, const std::vector<std::unique_ptr<EntityCommandBuffer>> &buffers);
+
+private:
+    enum class Phase : uint8_t
+    {
+        Emplace,
+        Remove,
+        Destroy
+    };
+
+    typedef void (*ApplyFunction)(entt::registry &registry, entt::entity entity, void *payload);
+    typedef void (*DestroyFunction)(void *payload);
+
+    struct Command
+    {
+        Phase phase;
+        bool deferred;
+        entt::id_type component;
+        entt::entity entity;
+        uint32_t deferredIndex;
+        void *payload;
+        ApplyFunction apply;
+        DestroyFunction destroy;
+    };
+
+    //Component payloads are packed into large chunks, so recording a command doesn't allocate per component.
+    struct PayloadChunk
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+        size_t used;
+    };
+
+    static constexpr size_t PAYLOAD_CHUNK_SIZE = 64 * 1024;
+
+    void *AllocatePayload(size_t size, size_t alignment);
+
+    template<typename T, typename... Args>
+    void RecordEmplace(entt::entity entity, bool deferred, uint32_t deferredIndex, Args &&... args);
+
+    void Reset();
+
+    //Exchange everything recorded with another buffer.
+    void Swap(EntityCommandBuffer &other);
+
+    static void Apply(entt::registry &registry, const std::vector<std::unique_ptr<EntityCommandBuffer>> &buffers);
+
+    std::vector<Command> commands;
+    std::vector<PayloadChunk> chunks;
+    size_t currentChunk = 0;
+    uint32_t createCount = 0;
+};
+
+template<typename T, typename... Args>
+void EntityCommandBuffer::Emplace(entt::entity entity, Args &&... args)
+{
+    RecordEmplace<T>(entity, false, 0, std::forward<Args>(args)...);
+}
+
+template<typename T, typename... Args>
+void EntityCommandBuffer::Emplace(DeferredEntity entity, Args &&... args)
+{
+    RecordEmplace<T>(entt::null, true, entity.index, std::forward<Args>(args)...);
+}
+
+template<typename T, typename... Args>
+void EntityCommandBuffer::RecordEmplace(entt::entity entity, bool deferred, uint32_t deferredIndex, Args &&... args)
+{
+    Command command{Phase::Emplace, deferred, entt::type_info<T>::id(), entity, deferredIndex, nullptr, nullptr, nullptr};
+
+    if constexpr (std::is_empty_v<T>)
+    {
+        //Tag components have no storage, there's nothing to carry over.
+        command.apply = [](entt::registry &registry, entt::entity entity, void *)
+        {
+            if (!registry.has<T>(entity)) registry.emplace<T>(entity);
+        };
+    } else
+    {
+        void *payload = AllocatePayload(sizeof(T), alignof(T));
+        if constexpr (std::is_aggregate_v<T>)
+        {
+            new(payload) T{std::forward<Args>(args)...};
+        } else
+        {
+            new(payload) T(std::forward<Args>(args)...);
+        }
+
+        command.payload = payload;
+        command.apply = [](entt::registry &registry, entt::entity entity, void *payload)
+        {
+            registry.emplace_or_replace<T>(entity, std::move(*static_cast<T *>(payload)));
+        };
+        command.destroy = [](void *payload)
+        {
+            static_cast<T *>(payload)->~T();
+        };
+    }
+
+    commands.push_back(command);
+}
+
+template<typename T>
+void EntityCommandBuffer::Remove(entt::entity entity)
+{
+    Command command{Phase::Remove, false, entt::type_info<T>::id(), entity, 0, nullptr, nullptr, nullptr};
+    command.apply = [](entt::registry &registry, entt::entity entity, void *)
+    {
+        registry.remove_if_exists<T>(entity);
+    };
+
+    commands.push_back(command);
+}
+
+#endif //RELIC_ENTITYCOMMANDBUFFER_H
@@ -0,0 +1,137 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include <string>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+#include "World.h"
+#include <Concurrency/Jobs/JobSystem.h>
+#include <Debugging/Benchmark.h>
+#include <Debugging/Logger.h>
+
+static const uint32_t COMMAND_ENTITY_COUNT = 100000;
+static const uint32_t RECORDING_THREADS = 2;
+
+struct CommandValue
+{
+    uint32_t thread;
+    uint32_t write;
+};
+
+struct CommandRemoved
+{
+    uint32_t value;
+};
+
+struct CommandCreated
+{
+};
+
+struct CommandFollowUp
+{
+};
+
+/// Records a follow up component from inside playback, which has to be applied by the same flush.
+static void OnCommandCreated(World &world, entt::registry &, entt::entity entity)
+{
+    world.Commands().Emplace<CommandFollowUp>(entity);
+}
+
+static void Check(bool condition, const char *message)
+{
+    if (condition) return;
+
+    Logger::Log("Command buffer check failed: %s", message);
+    throw std::runtime_error(message);
+}
+
+/// Record from several job threads at once and check that playback applies creates, emplaces, removes and destroys in
+/// that order, that the last write to a component wins, and that commands recorded by listeners aren't lost.
+static void RunEntityCommandBufferBenchmark()
+{
+    JobSystem jobSystem;
+    World world;
+    auto registry = world.Registry();
+    registry->on_construct<CommandCreated>().connect<&OnCommandCreated>(world);
+
+    std::vector<entt::entity> shared(COMMAND_ENTITY_COUNT);
+    std::vector<entt::entity> doomed(COMMAND_ENTITY_COUNT);
+    registry->create(shared.begin(), shared.end());
+    registry->create(doomed.begin(), doomed.end());
+    registry->insert<CommandRemoved>(shared.begin(), shared.end(), CommandRemoved{0});
+
+    //The first call creates a buffer for every thread, do it before the jobs start recording.
+    world.Commands();
+
+    std::vector<uint32_t> threadIndices(RECORDING_THREADS);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    JobCounter counter;
+    for (uint32_t thread = 0; thread < RECORDING_THREADS; thread++)
+    {
+        jobSystem.Run([&jobSystem, &world, &shared, &doomed, &threadIndices, thread]()
+                      {
+                          EntityCommandBuffer &commands = world.Commands();
+                          uint32_t index = jobSystem.ThreadIndex();
+                          threadIndices[thread] = index;
+
+                          for (uint32_t i = 0; i < COMMAND_ENTITY_COUNT; i++)
+                          {
+                              commands.Emplace<CommandValue>(shared[i], index, 0u);
+                              commands.Emplace<CommandValue>(shared[i], index, 1u);
+
+                              //Removes come after emplaces no matter which thread recorded what.
+                              commands.Remove<CommandRemoved>(shared[i]);
+                              commands.Emplace<CommandRemoved>(shared[i], thread);
+
+                              //Destroys come last, so the emplace doesn't bring the entity back.
+                              if (thread == 0) commands.Destroy(doomed[i]);
+                              else commands.Emplace<CommandValue>(doomed[i], index, 1u);
+
+                              DeferredEntity created = commands.Create();
+                              commands.Emplace<CommandValue>(created, index, 1u);
+                              commands.Emplace<CommandCreated>(created);
+                          }
+                      }, &counter);
+    }
+    jobSystem.Wait(counter);
+    double recordSeconds = Benchmark::SecondsSince(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    world.FlushCommands();
+    double playbackSeconds = Benchmark::SecondsSince(start);
+
+    Logger::Log("Record %i commands on %i threads: %sms", COMMAND_ENTITY_COUNT * RECORDING_THREADS * 8,
+                RECORDING_THREADS, std::to_string(recordSeconds * 1000.0).c_str());
+    Logger::Log("Playback: %sms", std::to_string(playbackSeconds * 1000.0).c_str());
+
+    //Buffers are played back in thread order, so the thread with the highest index writes last.
+    uint32_t lastThread = *std::max_element(threadIndices.begin(), threadIndices.end());
+
+    for (auto entity : shared)
+    {
+        auto &value = registry->get<CommandValue>(entity);
+        Check(value.thread == lastThread, "a write from an earlier buffer won");
+        Check(value.write == 1, "an earlier write from the same buffer won");
+        Check(!registry->has<CommandRemoved>(entity), "a remove was applied before an emplace");
+    }
+
+    for (auto entity : doomed)
+    {
+        Check(!registry->valid(entity), "an emplace was applied after a destroy");
+    }
+
+    auto created = registry->view<CommandCreated>();
+    Check(created.size() == COMMAND_ENTITY_COUNT * RECORDING_THREADS, "deferred entities went missing");
+    for (auto entity : created)
+    {
+        Check(registry->has<CommandValue>(entity), "a deferred entity is missing its component");
+        Check(registry->has<CommandFollowUp>(entity), "a command recorded during playback was dropped");
+    }
+
+    Logger::Log("Command buffer checks passed");
+}
+
+static BenchmarkRegistrar registrar("commands", &RunEntityCommandBufferBenchmark);
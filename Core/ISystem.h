@@ -7,13 +7,72 @@
 
 #include <Libraries/entt/entt.hpp>
 #include <map>
+#include <type_traits>
+#include <atomic>
 #include <Debugging/Logger.h>
 
 class World;
 
+/// The set of components (and singletons) a system touches. Used by the scheduler to figure out which systems can run
+/// at the same time.
+struct SystemAccess
+{
+    std::vector<entt::id_type> reads;
+    std::vector<entt::id_type> writes;
+
+    //Pools that need to exist before the system runs, creating them from a worker thread isn't safe.
+    std::vector<void (*)(entt::registry &)> pools;
+
+    //Systems that never declared their access are assumed to touch everything.
+    bool declared = false;
+
+    /// Whether two systems can't be run concurrently.
+    /// \param other The access of the other system.
+    /// \return True if either system writes something the other reads or writes.
+    [[nodiscard]] bool ConflictsWith(const SystemAccess &other) const
+    {
+        if (!declared || !other.declared) return true;
+
+        for (auto type : writes)
+        {
+            if (std::find(other.reads.begin(), other.reads.end(), type) != other.reads.end()) return true;
+            if (std::find(other.writes.begin(), other.writes.end(), type) != other.writes.end()) return true;
+        }
+
+        for (auto type : other.writes)
+        {
+            if (std::find(reads.begin(), reads.end(), type) != reads.end()) return true;
+        }
+
+        return false;
+    }
+};
+
+/// Dense per-type index for system classes, assigned the first time a type is looked up. Used to index the system
+/// cache of a world directly instead of searching it.
+class SystemTypeIndex
+{
+public:
+    template<typename T>
+    static uint32_t Get()
+    {
+        static const uint32_t index = Next();
+        return index;
+    }
+
+private:
+    static uint32_t Next()
+    {
+        static std::atomic<uint32_t> counter(0);
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
 class ISystem
 {
 public:
+    virtual ~ISystem() = default;
+
     virtual void Tick(World& world) = 0;
     virtual void FrameTick(World &world) = 0;
 
@@ -23,21 +82,83 @@ public:
     bool NeedsTick = true;
     bool NeedsFrameTick = false;
 
-    static std::vector<ISystem*>& SystemRegistry()
+    /// Systems that talk to GLFW, Vulkan or ImGui have to run on the thread that is driving the world.
+    bool RequiresMainThread = false;
+
+    /// Systems that need a window (and graphics API) are skipped when running headless.
+    bool RequiresWindow = false;
+
+    [[nodiscard]] const SystemAccess &Access() const
+    {
+        return access;
+    }
+
+    typedef ISystem *(*Factory)();
+
+    /// Factories of the systems every world is created with. Worlds tick concurrently, so each gets its own instances.
+    static std::vector<Factory>& SystemRegistry()
     {
-        static std::vector<ISystem *> registrar;
+        static std::vector<Factory> registrar;
         return registrar;
     }
+
+protected:
+    /// Declare that this system reads a component or singleton.
+    template<typename T>
+    void Reads();
+
+    /// Declare that this system writes a component or singleton.
+    template<typename T>
+    void Writes();
+
+private:
+    SystemAccess access;
+
+    template<typename T>
+    void AddPool();
 };
 
+template<typename T>
+void ISystem::Reads()
+{
+    using Type = std::remove_cv_t<T>;
+    access.declared = true;
+    access.reads.push_back(entt::type_info<Type>::id());
+    AddPool<Type>();
+}
+
+template<typename T>
+void ISystem::Writes()
+{
+    using Type = std::remove_cv_t<T>;
+    access.declared = true;
+    access.writes.push_back(entt::type_info<Type>::id());
+    AddPool<Type>();
+}
+
+template<typename T>
+void ISystem::AddPool()
+{
+    access.pools.push_back([](entt::registry &registry)
+                           {
+                               registry.prepare<T>();
+                           });
+}
+
 struct SystemRegistrar
 {
-    explicit SystemRegistrar(ISystem* system)
+    explicit SystemRegistrar(ISystem::Factory factory)
     {
-        ISystem::SystemRegistry().push_back(system);
-        Logger::Log("Registering system '%s'", typeid(*system).name());
+        ISystem::SystemRegistry().push_back(factory);
     }
 };
 
+/// Factory for SystemRegistrar.
+template<typename T>
+ISystem *CreateSystem()
+{
+    return new T();
+}
+
 
 #endif //RELIC_ISYSTEM_H
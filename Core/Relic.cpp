@@ -6,6 +6,12 @@
 #include <Graphics/Systems/VulkanRenderer.h>
 #include "Relic.h"
 #include "Core/Systems/Time.h"
+#include "Core/Systems/TransformHistory.h"
+#include "Core/Systems/TransformHierarchy.h"
+#include "Core/Systems/WorldBounds.h"
+#include <Spatial/Systems/SpatialIndex.h>
+#include "Core/Systems/HeadlessInput.h"
+#include <Graphics/Systems/NullRenderer.h>
 #include <Libraries/IMGUI/imgui_impl_vulkan.h>
 #include <Libraries/IMGUI/imgui_impl_glfw.h>
 #include <Graphics/Components/MeshComponent.h>
@@ -14,14 +20,20 @@
 #include <Core/Components/SingletonFrameStats.h>
 #include <Graphics/MaterialUtil.h>
 #include <Gameplay/Components/FPSCameraComponent.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <functional>
+#include <algorithm>
 
-Relic::Relic()
+Relic::Relic(RelicOptions options) : options(options)
 {
     window = nullptr;
     isRunning = false;
     renderer = nullptr;
     resourceManager = nullptr;
     memoryManager = nullptr;
+    jobSystem = nullptr;
 
     instance = this;
 }
@@ -31,12 +43,40 @@ Relic::~Relic()
     instance = nullptr;
 }
 
-void Relic::Start()
+int Relic::Start()
 {
     isRunning = true;
     Initialise();
-    GameLoop();
+
+    if (options.headless)
+    {
+        HeadlessLoop();
+    } else
+    {
+        GameLoop();
+    }
+
+    //A run with a fixed length is a test, and one that ended up drawing nothing didn't pass it. With GPU culling the
+    //instances are what the culling pass let through, read back from the GPU.
+    bool drewNothing = false;
+    SingletonRenderState** pRenderState = worlds[0]->Registry()->try_ctx<SingletonRenderState*>();
+    if (!options.headless && options.maxTicks > 0 && pRenderState != nullptr)
+    {
+        drewNothing = (*pRenderState)->stats.instances == 0;
+        if (drewNothing) Logger::Log("[Relic] Nothing was drawn in the last frame.");
+    }
+
     Cleanup();
+
+    //Checked after cleanup, destroying the device is when leaked objects get reported.
+    uint32_t validationErrors = VulkanRenderer::ValidationErrors();
+    if (validationErrors > 0)
+    {
+        Logger::Log("[Relic] Validation reported %i errors.", validationErrors);
+        return 1;
+    }
+
+    return drewNothing ? 1 : 0;
 }
 
 void Relic::Shutdown()
@@ -44,19 +84,136 @@ void Relic::Shutdown()
     isRunning = false;
 }
 
-void Relic::CreateSystems()
+void Relic::CreateSystems(World *world, bool primary)
 {
+    std::vector<std::unique_ptr<ISystem>> &owned = ownedSystems[world];
+
     //Create our core systems in order to guarantee correct execution order
     Time* time = new Time();
-    worlds[0]->RegisterSystem(time);
-    time->Init(*worlds[0]);
+    owned.emplace_back(time);
+    world->RegisterSystem(time);
+    time->Init(*world);
+
+    if (options.headless && options.tickRate > 0.0f)
+    {
+        world->Registry()->ctx<SingletonTime*>()->tickLength = 1.0f / options.tickRate;
+    }
+
+    //Has to snapshot transforms before any other system moves them.
+    TransformHistory* transformHistory = new TransformHistory();
+    owned.emplace_back(transformHistory);
+    world->RegisterSystem(transformHistory);
+    transformHistory->Init(*world);
+
+    //Stand ins for the systems that need a window. Only the primary world gets real input.
+    if (options.headless || !primary)
+    {
+        ISystem* input = new HeadlessInput();
+        owned.emplace_back(input);
+        world->RegisterSystem(input);
+        input->Init(*world);
+    }
+
+    //Renderers are held back until world transforms have been updated for the frame.
+    std::vector<ISystem*> renderers;
 
     Logger::Log("Creating %i registered systems", ISystem::SystemRegistry().size());
-    for(auto system : ISystem::SystemRegistry())
+    for(auto factory : ISystem::SystemRegistry())
     {
-        worlds[0]->RegisterSystem(system);
-        system->Init(*worlds[0]);
+        std::unique_ptr<ISystem> system(factory());
+
+        if (options.headless && system->RequiresWindow)
+        {
+            Logger::Log("Skipping system '%s' in headless mode", typeid(*system).name());
+            continue;
+        }
+
+        //Secondary worlds tick on worker threads, so they can't run anything that needs the main thread.
+        if (!primary && (system->RequiresWindow || system->RequiresMainThread)) continue;
+
+        ISystem* created = system.get();
+        owned.push_back(std::move(system));
+
+        if (dynamic_cast<Renderer*>(created) != nullptr)
+        {
+            renderers.push_back(created);
+            continue;
+        }
+
+        world->RegisterSystem(created);
+        created->Init(*world);
+    }
+
+    //Has to run after anything that moves transforms, and before anything that draws them.
+    TransformHierarchy* transformHierarchy = new TransformHierarchy();
+    owned.emplace_back(transformHierarchy);
+    world->RegisterSystem(transformHierarchy);
+    transformHierarchy->Init(*world);
+
+    //Needs this frame's world transforms, and renderers cull against the result.
+    WorldBounds* worldBounds = new WorldBounds();
+    owned.emplace_back(worldBounds);
+    world->RegisterSystem(worldBounds);
+    worldBounds->Init(*world);
+
+    SpatialIndex* spatialIndex = new SpatialIndex();
+    owned.emplace_back(spatialIndex);
+    world->RegisterSystem(spatialIndex);
+    spatialIndex->Init(*world);
+
+    if (options.headless && primary)
+    {
+        owned.emplace_back(new NullRenderer());
+        renderers.push_back(owned.back().get());
+    }
+
+    for(auto system : renderers)
+    {
+        world->RegisterSystem(system);
+        system->Init(*world);
+    }
+}
+
+World *Relic::CreateWorld()
+{
+    auto world = new World();
+    worlds.push_back(world);
+    CreateSystems(world, false);
+
+    return world;
+}
+
+void Relic::DestroyWorld(World *world)
+{
+    //The primary world owns the window and renderer, it lives until shutdown.
+    if (worlds.empty() || world == worlds[0]) return;
+
+    auto iterator = std::find(worlds.begin(), worlds.end(), world);
+    if (iterator == worlds.end()) return;
+
+    worlds.erase(iterator);
+    delete world;
+
+    //Only once the world has shut them down.
+    ownedSystems.erase(world);
+}
+
+void Relic::StepWorlds(const std::function<void(World *)> &step)
+{
+    //Secondary worlds don't share any state with each other, so each one is stepped as a single job.
+    JobCounter counter;
+    for (size_t i = 1; i < worlds.size(); i++)
+    {
+        World* world = worlds[i];
+        jobSystem->Run([&step, world]()
+                       {
+                           step(world);
+                       }, &counter);
     }
+
+    //The primary world stays on the main thread, it talks to the window and graphics API.
+    step(worlds[0]);
+    jobSystem->Wait(counter);
 }
 
 void Relic::Initialise()
@@ -64,10 +221,22 @@ void Relic::Initialise()
     //Initialise core systems
     resourceManager = new ResourceManager();
     memoryManager = new MemoryManager();
+    jobSystem = new JobSystem();
+    Logger::Log("Started job system with %i threads", jobSystem->ThreadCount());
 
     //Create a default world
     worlds.push_back(new World());
 
+    if (options.headless)
+    {
+        Logger::Log("Running headless");
+
+        CreateSystems(worlds[0], true);
+        CreateDefaultWorldObjects();
+        DebugInit();
+        return;
+    }
+
     //Initialise graphics
     glfwInit();
     window = new Window(800, 600, "Relic", true);
@@ -75,7 +244,7 @@ void Relic::Initialise()
     imGuiContext = ImGui::CreateContext();
     ImGui::StyleColorsDark();
 
-    CreateSystems();
+    CreateSystems(worlds[0], true);
     CreateDefaultWorldObjects();
 
     // Start the Dear ImGui frame
@@ -90,22 +259,125 @@ void Relic::Initialise()
 
 void Relic::GameLoop()
 {
+    SingletonTime* primaryTime = worlds[0]->Registry()->ctx<SingletonTime*>();
+
+    auto start = std::chrono::steady_clock::now();
+
     while (!window->ShouldClose() && isRunning)
     {
         glfwPollEvents();
 
         DrawRenderDebugWidget();
 
-        for (auto world : worlds)
+        float now = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+        StepWorlds([this, now](World* world)
+                   {
+                       StepWorld(world, now);
+                   });
+
+        if (options.maxTicks > 0 && primaryTime->tickCount >= options.maxTicks) isRunning = false;
+    }
+}
+
+void Relic::HeadlessLoop()
+{
+    typedef std::chrono::steady_clock Clock;
+
+    SingletonTime* primaryTime = worlds[0]->Registry()->ctx<SingletonTime*>();
+
+    auto start = Clock::now();
+    auto lastReport = start;
+    uint64_t lastReportTicks = 0;
+
+    while (isRunning)
+    {
+        if (options.tickRate > 0.0f)
+        {
+            float now = std::chrono::duration<float>(Clock::now() - start).count();
+            StepWorlds([this, now](World* world)
+                       {
+                           StepWorld(world, now);
+                       });
+
+            //Sleep until the next tick is due, there's no frame to present in the meantime.
+            float untilNextTick = primaryTime->tickLength - primaryTime->accumulator;
+            if (untilNextTick > 0.0f) std::this_thread::sleep_for(std::chrono::duration<float>(untilNextTick));
+        } else
+        {
+            //Free running: every iteration is exactly one tick of simulated time, however long it actually took.
+            StepWorlds([](World* world)
+                       {
+                           SingletonTime** pTime = world->Registry()->try_ctx<SingletonTime*>();
+                           if (pTime != nullptr)
+                           {
+                               SingletonTime* time = *pTime;
+                               time->lastFrameTime = time->currentTime;
+                               time->currentTime += time->tickLength;
+                               time->ticksThisFrame = 1;
+                               time->alpha = 0.0f;
+                           }
+
+                           world->Tick();
+                           world->FrameTick();
+                       });
+        }
+
+        auto current = Clock::now();
+        double sinceReport = std::chrono::duration<double>(current - lastReport).count();
+        if (sinceReport >= 1.0)
         {
-            world->FrameTick();
+            uint64_t ticks = primaryTime->tickCount - lastReportTicks;
+            Logger::Log("[Headless] %s ticks/s, %sms/tick", std::to_string(ticks / sinceReport).c_str(),
+                        std::to_string(ticks > 0 ? sinceReport * 1000.0 / ticks : 0.0).c_str());
 
-            if (world->Registry()->ctx<SingletonTime*>()->TickDelta() > tickLength)
-            {
-                world->Tick();
-            }
+            lastReport = current;
+            lastReportTicks = primaryTime->tickCount;
         }
+
+        if (options.maxTicks > 0 && primaryTime->tickCount >= options.maxTicks) isRunning = false;
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    Logger::Log("[Headless] Ran %s ticks in %ss (%s ticks/s)", std::to_string(primaryTime->tickCount).c_str(),
+                std::to_string(seconds).c_str(), std::to_string(primaryTime->tickCount / seconds).c_str());
+}
+
+void Relic::StepWorld(World *world, float now)
+{
+    SingletonTime** pTime = world->Registry()->try_ctx<SingletonTime*>();
+
+    //Worlds without a clock have nothing to simulate at a fixed rate.
+    if (pTime == nullptr)
+    {
+        world->FrameTick();
+        return;
+    }
+
+    SingletonTime* time = *pTime;
+    time->lastFrameTime = time->currentTime;
+    time->currentTime = now;
+    time->accumulator += time->FrameDelta();
+    time->ticksThisFrame = 0;
+
+    while (time->accumulator >= time->tickLength && time->ticksThisFrame < time->maxTicksPerFrame)
+    {
+        world->Tick();
+        time->accumulator -= time->tickLength;
+        time->ticksThisFrame++;
     }
+
+    //Hit the cap, drop whole ticks we couldn't get to rather than trying to catch up next frame as well.
+    if (time->accumulator >= time->tickLength)
+    {
+        float dropped = time->accumulator - std::fmod(time->accumulator, time->tickLength);
+        time->accumulator -= dropped;
+        time->droppedTime += dropped;
+    }
+
+    time->alpha = time->accumulator / time->tickLength;
+
+    world->FrameTick();
 }
 
 void Relic::DrawRenderDebugWidget()
@@ -146,6 +418,33 @@ void Relic::DrawRenderDebugWidget()
     ImGui::NextColumn();
     ImGui::Text("%.0ffps", 1.0f / frameStats->averageFrameTime);
 
+    ImGui::Columns(1);
+    ImGui::Separator();
+    ImGui::Text("Ticks %u (%.0fHz), alpha %.2f, dropped %.2fs", time->ticksThisFrame, 1.0f / time->tickLength, time->alpha, time->droppedTime);
+
+    SingletonRenderState** pRenderState = worlds[0]->Registry()->try_ctx<SingletonRenderState*>();
+    if (pRenderState != nullptr)
+    {
+        const RenderStats &stats = (*pRenderState)->stats;
+        ImGui::Separator();
+        ImGui::Text("Draws %u (%u instances)", stats.draws, stats.instances);
+        ImGui::Text("Material binds %u (%u avoided)", stats.materialBinds, stats.materialBindsAvoided);
+        ImGui::Text("Mesh binds %u (%u avoided)", stats.meshBinds, stats.meshBindsAvoided);
+        ImGui::Text("Pipeline binds %u (%u avoided)", stats.pipelineBinds, stats.pipelineBindsAvoided);
+        ImGui::Checkbox("GPU culling", &(*pRenderState)->gpuCulling);
+
+        const GeometryStats &geometry = (*pRenderState)->geometry;
+        ImGui::Text("Geometry %u ranges in %u buffers, %.1f/%.1fMB, %.0f%% fragmented, %u compactions",
+                    geometry.allocations, geometry.buffers, geometry.usedBytes / (1024.0f * 1024.0f),
+                    geometry.capacityBytes / (1024.0f * 1024.0f), geometry.fragmentation * 100.0f, geometry.compactions);
+
+        const UploadStats &uploads = (*pRenderState)->uploadStats;
+        ImGui::Text("Uploads %u batches, %.1fMB in flight, %.1fMB waiting, staging %.1f/%.1fMB",
+                    uploads.batchesInFlight, uploads.bytesInFlight / (1024.0f * 1024.0f),
+                    uploads.bytesWaiting / (1024.0f * 1024.0f), uploads.stagingUsedBytes / (1024.0f * 1024.0f),
+                    uploads.stagingCapacityBytes / (1024.0f * 1024.0f));
+    }
+
     ImGui::End();
 }
 
@@ -157,14 +456,21 @@ void Relic::Cleanup()
         delete world;
     }
 
-    ImGui::DestroyContext(imGuiContext);
+    ownedSystems.clear();
+
     DebugDestroy();
 
-    delete window;
-    glfwTerminate();
+    if (!options.headless)
+    {
+        ImGui::DestroyContext(imGuiContext);
+
+        delete window;
+        glfwTerminate();
+    }
 
     delete resourceManager;
     delete memoryManager;
+    delete jobSystem;
 }
 
 ///Debug initialisation code, this should be deleted later.
@@ -185,10 +491,38 @@ void Relic::DebugInit()
         registry->emplace<MeshComponent>(entity, &model->meshes[i], mat, model->meshes[i].guid);
         registry->emplace<TransformComponent>(entity, glm::zero<glm::vec3>(), glm::one<glm::vec3>(), glm::quat(glm::vec3(-glm::radians(90.0f), 0, 0)));
     }
+
+    //Copies of the first mesh rather than instances of it, draws are only split into chunks once there are enough
+    //different meshes to fill them.
+    if (options.testMeshes == 0 || model->meshCount == 0) return;
+
+    const Mesh &source = model->meshes[0];
+    testMeshes.reset(new Mesh[options.testMeshes]);
+    auto gridSize = (uint32_t) std::ceil(std::sqrt((float) options.testMeshes));
+
+    for(uint32_t i = 0; i < options.testMeshes; i++)
+    {
+        Mesh &mesh = testMeshes[i];
+        mesh.vertexCount = source.vertexCount;
+        mesh.vertices = new Vertex[source.vertexCount];
+        std::copy(source.vertices, source.vertices + source.vertexCount, mesh.vertices);
+        mesh.indexCount = source.indexCount;
+        mesh.indices = new uint32_t[source.indexCount];
+        std::copy(source.indices, source.indices + source.indexCount, mesh.indices);
+        mesh.bounds = source.bounds;
+        mesh.guid = GetGUID("TestMesh" + std::to_string(i));
+
+        glm::vec3 position((float) (i % gridSize) - gridSize * 0.5f, 0.0f, (float) (i / gridSize) - gridSize * 0.5f);
+        auto entity = registry->create();
+        registry->emplace<MeshComponent>(entity, &mesh, mat, mesh.guid);
+        registry->emplace<TransformComponent>(entity, position, glm::vec3(0.25f), glm::quat(glm::vec3(-glm::radians(90.0f), 0, 0)));
+    }
 }
 
 void Relic::DebugDestroy()
 {
+    //The worlds are gone by now, nothing refers to the meshes anymore.
+    testMeshes.reset();
 }
 
 void Relic::CreateDefaultWorldObjects()
@@ -211,6 +545,16 @@ Window *Relic::GetActiveWindow() const
     return window;
 }
 
+bool Relic::IsHeadless() const
+{
+    return options.headless;
+}
+
+bool Relic::UsesGpuCulling() const
+{
+    return options.gpuCulling;
+}
+
 Relic* Relic::instance = nullptr;
 
 World *Relic::GetPrimaryWorld() const
@@ -12,26 +12,77 @@
 #include <Graphics/Systems/VulkanRenderer.h>
 #include <ResourceManager/ResourceManager.h>
 #include <MemoryManager/MemoryManager.h>
+#include <Concurrency/Jobs/JobSystem.h>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include "World.h"
 
+/// Startup options, parsed from the command line in main.
+struct RelicOptions
+{
+    //Run without a window, Vulkan or ImGui. Rendering goes to a null back end and input is synthetic.
+    bool headless = false;
+
+    //Headless only: simulation rate in ticks per second, 0 ticks as fast as possible.
+    float tickRate = 0.0f;
+
+    //Stop after this many ticks of the primary world, 0 runs until shut down.
+    uint64_t maxTicks = 0;
+
+    //Start out culling and drawing on the GPU, where the back end supports it. Can be toggled at runtime.
+    bool gpuCulling = false;
+
+    //Add this many copies of the test mesh to the scene, each drawn separately, to give the renderer a few chunks of
+    //draws to record in parallel.
+    uint32_t testMeshes = 0;
+};
+
 class Relic
 {
 public:
-    Relic();
+    explicit Relic(RelicOptions options = RelicOptions());
     ~Relic();
-    void Start();
+    /// Run until shut down, or until options.maxTicks have passed.
+    /// \return The process exit code, non zero if validation reported errors along the way, or if a run of
+    /// options.maxTicks drew nothing in its last frame.
+    int Start();
     void Shutdown();
 
     static const Relic* Instance();
     Window* GetActiveWindow() const;
 
+    [[nodiscard]] bool IsHeadless() const;
+
+    [[nodiscard]] bool UsesGpuCulling() const;
+
     World* GetPrimaryWorld() const;
 
+    /// Create an additional world with its own registry, clock and systems. Secondary worlds tick in parallel with the
+    /// primary world on the job system, so they only get the registered systems that can run off the main thread.
+    /// Every world gets its own instance of each system, so systems can keep state without worlds racing on it.
+    /// \return The new world, owned by Relic.
+    World* CreateWorld();
+
+    /// Destroy a world created with CreateWorld. Must not be called while worlds are being stepped.
+    void DestroyWorld(World* world);
+
 private:
     void Initialise();
 
     void GameLoop();
 
+    /// Game loop used in headless mode, reports simulation throughput as it runs.
+    void HeadlessLoop();
+
+    /// Advance a world's clock, run as many fixed ticks as have built up, then run a frame.
+    /// \param world The world to advance.
+    /// \param now Seconds since the game loop started.
+    void StepWorld(World *world, float now);
+
+    /// Run a step function for every world, secondary worlds as jobs and the primary world on the calling thread.
+    void StepWorlds(const std::function<void(World *)> &step);
+
     void Cleanup();
 
     void DebugInit();
@@ -44,20 +95,24 @@ private:
 
     std::vector<World*> worlds;
 
+    //Systems created for a world rather than taken from the system registry, freed along with the world.
+    std::unordered_map<World*, std::vector<std::unique_ptr<ISystem>>> ownedSystems;
+
     ResourceManager *resourceManager;
     MemoryManager *memoryManager;
+    JobSystem *jobSystem;
     bool isRunning;
-
-    float tickLength = 1.0f / 30.0f;
+    RelicOptions options;
 
     ImGuiContext *imGuiContext;
 
     void DrawRenderDebugWidget();
 
-    void CreateSystems();
+    void CreateSystems(World *world, bool primary);
 
     //TEMP
     Model *model;
+    std::unique_ptr<Mesh[]> testMeshes;
 
     void CreateDefaultWorldObjects();
 };
@@ -0,0 +1,170 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "SystemScheduler.h"
+#include "World.h"
+#include <Core/Util.h>
+
+void SystemScheduler::BuildGraph(const std::vector<ISystem *> &systems, SystemPass pass)
+{
+    nodes.clear();
+
+    for (auto system : systems)
+    {
+        bool needed = pass == SystemPass::Tick ? system->NeedsTick : system->NeedsFrameTick;
+        if (!needed) continue;
+
+        nodes.push_back({system, {}, 0});
+    }
+
+    //A system depends on every earlier system it conflicts with, so conflicting systems keep their registration order.
+    for (uint32_t i = 0; i < nodes.size(); i++)
+    {
+        for (uint32_t j = i + 1; j < nodes.size(); j++)
+        {
+            if (!nodes[i].system->Access().ConflictsWith(nodes[j].system->Access())) continue;
+
+            nodes[i].dependents.push_back(j);
+            nodes[j].dependencyCount++;
+        }
+    }
+}
+
+void SystemScheduler::Run(World &world, const std::vector<ISystem *> &systems, SystemPass pass)
+{
+    BuildGraph(systems, pass);
+    if (nodes.empty()) return;
+
+    currentWorld = &world;
+    currentPass = pass;
+    exception = nullptr;
+    jobSystem = JobSystem::GetInstance();
+
+    //Nothing to run concurrently with, so skip the synchronisation entirely.
+    if (jobSystem == nullptr || jobSystem->ThreadCount() == 1 || nodes.size() == 1)
+    {
+        for (uint32_t i = 0; i < nodes.size() && !exception; i++) Execute(i);
+        Finish();
+        return;
+    }
+
+    //Worker threads can't safely create component pools, so do it up front.
+    for (auto &node : nodes)
+    {
+        for (auto prepare : node.system->Access().pools) prepare(*world.Registry());
+    }
+
+    if (pendingCapacity < nodes.size())
+    {
+        pendingCapacity = nodes.size();
+        pendingDependencies.reset(new std::atomic<uint32_t>[pendingCapacity]);
+    }
+
+    remaining.store((uint32_t) nodes.size(), std::memory_order_relaxed);
+    for (uint32_t i = 0; i < nodes.size(); i++)
+    {
+        pendingDependencies[i].store(nodes[i].dependencyCount, std::memory_order_relaxed);
+    }
+
+    for (uint32_t i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i].dependencyCount == 0) Dispatch(i);
+    }
+
+    //The calling thread runs main thread systems, and helps out with other jobs while it waits.
+    uint32_t idle = 0;
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        bool hasNode = false;
+        uint32_t node = 0;
+        {
+            std::lock_guard<std::mutex> lock(mainThreadMutex);
+            if (!mainThreadReady.empty())
+            {
+                node = mainThreadReady.front();
+                mainThreadReady.pop_front();
+                hasNode = true;
+            }
+        }
+
+        if (hasNode)
+        {
+            Execute(node);
+            Complete(node);
+            idle = 0;
+        } else if (jobSystem->RunPendingJob())
+        {
+            idle = 0;
+        } else if (++idle < 128)
+        {
+            PAUSE();
+        } else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    Finish();
+}
+
+void SystemScheduler::Finish()
+{
+    currentWorld = nullptr;
+
+    //Surface the first failure on the calling thread, the same as if the systems had been run serially.
+    if (exception)
+    {
+        std::exception_ptr rethrow = exception;
+        exception = nullptr;
+        std::rethrow_exception(rethrow);
+    }
+}
+
+void SystemScheduler::Execute(uint32_t node)
+{
+    ISystem *system = nodes[node].system;
+
+    try
+    {
+        if (currentPass == SystemPass::Tick)
+        {
+            system->Tick(*currentWorld);
+        } else
+        {
+            system->FrameTick(*currentWorld);
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if (!exception) exception = std::current_exception();
+    }
+}
+
+void SystemScheduler::Complete(uint32_t node)
+{
+    for (auto dependent : nodes[node].dependents)
+    {
+        if (pendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) Dispatch(dependent);
+    }
+
+    //Decrement last, the pass (and with it this scheduler's state) may be over as soon as this hits zero.
+    remaining.fetch_sub(1, std::memory_order_release);
+}
+
+void SystemScheduler::Dispatch(uint32_t node)
+{
+    if (nodes[node].system->RequiresMainThread)
+    {
+        std::lock_guard<std::mutex> lock(mainThreadMutex);
+        mainThreadReady.push_back(node);
+        return;
+    }
+
+    jobSystem->Run([this, node]()
+                   {
+                       Execute(node);
+                       Complete(node);
+                   });
+}
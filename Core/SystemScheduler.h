@@ -0,0 +1,73 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_SYSTEMSCHEDULER_H
+#define RELIC_SYSTEMSCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <exception>
+#include <Concurrency/Jobs/JobSystem.h>
+#include "ISystem.h"
+
+class World;
+
+enum class SystemPass
+{
+    Tick,
+    FrameTick
+};
+
+/// Runs the systems of a world for a single pass. Systems are ordered by registration, but a system only waits for the
+/// earlier systems whose declared access overlaps its own, everything else is handed to the job system as soon as its
+/// dependencies have finished.
+class SystemScheduler
+{
+public:
+    /// Run every system that needs the given pass and wait for all of them to complete.
+    /// \param world The world being ticked.
+    /// \param systems The systems of the world, in registration order.
+    /// \param pass Which pass to run.
+    void Run(World &world, const std::vector<ISystem *> &systems, SystemPass pass);
+
+private:
+    struct Node
+    {
+        ISystem *system;
+        std::vector<uint32_t> dependents;
+        uint32_t dependencyCount;
+    };
+
+    void BuildGraph(const std::vector<ISystem *> &systems, SystemPass pass);
+
+    void Execute(uint32_t node);
+
+    /// Mark a node as finished and dispatch any dependents that became ready. [Any thread]
+    void Complete(uint32_t node);
+
+    void Dispatch(uint32_t node);
+
+    void Finish();
+
+    std::vector<Node> nodes;
+    std::unique_ptr<std::atomic<uint32_t>[]> pendingDependencies;
+    size_t pendingCapacity = 0;
+    std::atomic<uint32_t> remaining{0};
+
+    //Main thread systems that became ready, picked up by the thread running the pass.
+    std::mutex mainThreadMutex;
+    std::deque<uint32_t> mainThreadReady;
+
+    JobSystem *jobSystem = nullptr;
+    World *currentWorld = nullptr;
+    SystemPass currentPass = SystemPass::Tick;
+
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+};
+
+#endif //RELIC_SYSTEMSCHEDULER_H
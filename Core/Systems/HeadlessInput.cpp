@@ -0,0 +1,47 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include <Core/Components/SingletonInput.h>
+#include <Core/Components/SingletonEntityComponent.h>
+#include "HeadlessInput.h"
+#include <Core/World.h>
+
+HeadlessInput::HeadlessInput()
+{
+    Writes<SingletonInput>();
+}
+
+void HeadlessInput::Tick(World &world)
+{
+}
+
+void HeadlessInput::FrameTick(World &world)
+{
+    auto& input = *world.Registry()->ctx<SingletonInput*>();
+
+    input.lastKeys = input.keys;
+    input.lastMouse = input.mouse;
+}
+
+void HeadlessInput::Init(World &world)
+{
+    NeedsTick = false;
+    NeedsFrameTick = true;
+
+    auto registry = world.Registry();
+    auto entity = registry->create();
+    registry->emplace<SingletonEntityComponent>(entity);
+
+    auto &component = registry->emplace<SingletonInput>(entity);
+    component.mousePosX = 0.0f;
+    component.mousePosY = 0.0f;
+
+    //Setup our context variables to make them easy to access.
+    registry->set<SingletonInput*>(&component);
+}
+
+void HeadlessInput::Shutdown(World &world)
+{
+    world.Registry()->unset<SingletonInput*>();
+}
@@ -0,0 +1,29 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_HEADLESSINPUT_H
+#define RELIC_HEADLESSINPUT_H
+
+
+#include <Core/ISystem.h>
+
+/// Stand in for Input when running without a window. Provides SingletonInput so gameplay systems keep working, nothing
+/// is pressed unless something writes into the singleton (e.g. a scripted test), and the previous frame's state is
+/// rolled over every frame so the GetKeyDown style queries behave the same as with real input.
+class HeadlessInput : public ISystem
+{
+public:
+    HeadlessInput();
+
+    void Tick(World &world) override;
+
+    void FrameTick(World &world) override;
+
+    void Init(World &world) override;
+
+    void Shutdown(World &world) override;
+};
+
+
+#endif //RELIC_HEADLESSINPUT_H
@@ -3,6 +3,7 @@
 //
 
 #include <Core/Components/SingletonInput.h>
+#include <Core/Components/SingletonEntityComponent.h>
 #include "Input.h"
 #include <Core/World.h>
 #include <GLFW/glfw3.h>
@@ -59,6 +60,14 @@ void Input::FrameTick(World &world)
     }
 }
 
+Input::Input()
+{
+    //GLFW input polling is only allowed from the main thread.
+    RequiresMainThread = true;
+    RequiresWindow = true;
+    Writes<SingletonInput>();
+}
+
 void Input::Init(World &world)
 {
     NeedsTick = false;
@@ -66,6 +75,7 @@ void Input::Init(World &world)
 
     auto registry = world.Registry();
     auto entity = registry->create();
+    registry->emplace<SingletonEntityComponent>(entity);
 
     auto &component = registry->emplace<SingletonInput>(entity);
 
@@ -89,4 +99,4 @@ void Input::OnMouseMoved(GLFWwindow *window, double x, double y)
     input->mousePosY = (float) y;
 }
 
-SystemRegistrar Input::registrar(new Input());
+SystemRegistrar Input::registrar(&CreateSystem<Input>);
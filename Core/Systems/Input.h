@@ -13,6 +13,8 @@ class GLFWwindow;
 class Input : public ISystem
 {
 public:
+    Input();
+
     void Tick(World &world) override;
 
     void FrameTick(World &world) override;
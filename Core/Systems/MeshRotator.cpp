@@ -7,6 +7,7 @@
 #include <Graphics/Components/MeshComponent.h>
 #include <Core/Components/TransformComponent.h>
 #include <Core/Components/SingletonTime.h>
+#include <Concurrency/Jobs/ParallelFor.h>
 
 void MeshRotator::Tick(World &world)
 {
@@ -18,20 +19,28 @@ void MeshRotator::FrameTick(World &world)
     auto view = registry->view<const MeshComponent, TransformComponent>();
     auto time = registry->ctx<SingletonTime*>();
 
-    for(auto entity : view)
+    float angle = glm::radians(45.0f) * time->FrameDelta();
+
+    ParallelEach(view, [registry, angle](entt::entity entity)
     {
-        auto &transform = view.get<TransformComponent>(entity);
-        transform.rotation = glm::rotate(transform.rotation, glm::radians(45.0f) * time->FrameDelta() , glm::vec3(0,0,1));
-    }
+        registry->patch<TransformComponent>(entity, [angle](TransformComponent &transform)
+        {
+            transform.rotation = glm::rotate(transform.rotation, angle, glm::vec3(0,0,1));
+        });
+    });
 }
 
 MeshRotator::MeshRotator()
 {
     NeedsTick = false;
     NeedsFrameTick = true;
+
+    Reads<MeshComponent>();
+    Reads<SingletonTime>();
+    Writes<TransformComponent>();
 }
 
-SystemRegistrar MeshRotator::registrar(new MeshRotator());
+SystemRegistrar MeshRotator::registrar(&CreateSystem<MeshRotator>);
 
 void MeshRotator::Init(World &world)
 {
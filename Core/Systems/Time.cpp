@@ -2,9 +2,10 @@
 // Created by mikag on 18/08/2020.
 //
 
-#include <GLFW/glfw3.h>
+#include <cstring>
 #include <Core/Components/SingletonTime.h>
 #include <Core/Components/SingletonFrameStats.h>
+#include <Core/Components/SingletonEntityComponent.h>
 #include "Time.h"
 #include <Core/World.h>
 
@@ -14,16 +15,15 @@ void Time::Tick(World &world)
     SingletonTime* time = registry->ctx<SingletonTime*>();
 
     time->lastTickTime = time->currentTime;
+    time->tickCount++;
 }
 
 void Time::FrameTick(World &world)
 {
+    //The clock itself is advanced by the game loop before this frame's ticks run, all that's left is the stats.
     auto registry = world.Registry();
     SingletonTime* time = registry->ctx<SingletonTime*>();
 
-    time->lastFrameTime = time->currentTime;
-    time->currentTime = glfwGetTime();
-
     SingletonFrameStats** pFrameStats = registry->try_ctx<SingletonFrameStats*>();
     if(pFrameStats != nullptr)
     {
@@ -43,6 +43,12 @@ void Time::FrameTick(World &world)
     }
 }
 
+Time::Time()
+{
+    Writes<SingletonTime>();
+    Writes<SingletonFrameStats>();
+}
+
 void Time::Init(World &world)
 {
     NeedsTick = true;
@@ -50,6 +56,7 @@ void Time::Init(World &world)
 
     auto registry = world.Registry();
     auto entity = registry->create();
+    registry->emplace<SingletonEntityComponent>(entity);
 
     auto &time = registry->emplace<SingletonTime>(entity);
     auto &frameStats = registry->emplace<SingletonFrameStats>(entity);
@@ -10,6 +10,8 @@
 class Time : public ISystem
 {
 public:
+    Time();
+
     void Tick(World &world) override;
     void FrameTick(World &world) override;
     void Init(World &world) override;
@@ -0,0 +1,310 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "TransformHierarchy.h"
+#include <cstring>
+#include <Core/World.h>
+#include <Core/Components/TransformComponent.h>
+#include <Core/Components/PreviousTransformComponent.h>
+#include <Core/Components/ParentComponent.h>
+#include <Core/Components/WorldTransformComponent.h>
+#include <Core/Components/SingletonTime.h>
+#include <Concurrency/Jobs/JobSystem.h>
+#include <Concurrency/Jobs/ParallelFor.h>
+#include <Debugging/Logger.h>
+
+TransformHierarchy::TransformHierarchy()
+{
+    NeedsTick = false;
+    NeedsFrameTick = true;
+
+    Reads<TransformComponent>();
+    Reads<PreviousTransformComponent>();
+    Reads<ParentComponent>();
+    Reads<SingletonTime>();
+    Writes<WorldTransformComponent>();
+}
+
+void TransformHierarchy::Tick(World &world)
+{
+}
+
+void TransformHierarchy::FrameTick(World &world)
+{
+    auto registry = world.Registry();
+
+    auto transforms = registry->view<const TransformComponent>();
+    auto previousTransforms = registry->view<const PreviousTransformComponent>();
+    auto worldTransforms = registry->view<WorldTransformComponent>();
+
+    //Whatever changed during the last update has been seen by now.
+    for (entt::entity entity : changedEntities)
+    {
+        if (worldTransforms.contains(entity)) worldTransforms.get(entity).changed = false;
+    }
+    changedEntities.clear();
+
+    bool rebuilt = hierarchyChanged;
+    if (hierarchyChanged) RebuildHierarchy(*registry);
+
+    //Without any parents every entity is a root, entities added since the last rebuild are too.
+    bool hasHierarchy = registry->size<ParentComponent>() > 0;
+
+    size_t count = registry->size<WorldTransformComponent>();
+    WorldTransformComponent *caches = registry->raw<WorldTransformComponent>();
+    const entt::entity *entities = registry->data<WorldTransformComponent>();
+
+    for (std::vector<uint32_t> &indices : queue) indices.clear();
+    queue.resize(hasHierarchy ? depthCount : 1);
+
+    auto enqueue = [&](size_t index)
+    {
+        WorldTransformComponent &cache = caches[index];
+        if (cache.queued) return;
+
+        cache.queued = true;
+        queue[hasHierarchy ? cache.depth : 0].push_back((uint32_t) index);
+    };
+
+    auto enqueueEntity = [&](entt::entity entity)
+    {
+        if (worldTransforms.contains(entity)) enqueue(&worldTransforms.get(entity) - caches);
+    };
+
+    //Only entities whose transform was changed are looked at, along with everything below them.
+    for (std::vector<entt::entity> &dirty : dirtyEntities)
+    {
+        for (entt::entity entity : dirty) enqueueEntity(entity);
+        dirty.clear();
+    }
+
+    //Interpolated entities move every frame, until they come to rest.
+    for (entt::entity entity : previousTransforms) enqueueEntity(entity);
+
+    //A rebuild moved every entity around and marked all of them dirty.
+    for (size_t i = 0; rebuilt && i < count; i++) enqueue(i);
+
+    SingletonTime **pTime = registry->try_ctx<SingletonTime *>();
+    float alpha = pTime != nullptr ? (*pTime)->alpha : 1.0f;
+
+    auto update = [&](size_t index)
+    {
+        WorldTransformComponent &cache = caches[index];
+        entt::entity entity = entities[index];
+        cache.queued = false;
+
+        //Entities moved from Tick are placed between their last two simulated states, so motion stays smooth at any
+        //frame rate.
+        const TransformComponent &transform = transforms.get(entity);
+        TransformComponent local = previousTransforms.contains(entity)
+                                   ? Interpolate(previousTransforms.get(entity).transform, transform, alpha)
+                                   : transform;
+
+        const WorldTransformComponent *parent = cache.parent != entt::null ? &worldTransforms.get(cache.parent) : nullptr;
+        bool parentChanged = parent != nullptr && parent->changed;
+
+        if (!cache.dirty && !parentChanged && memcmp(&cache.local, &local, sizeof(TransformComponent)) == 0)
+        {
+            cache.changed = false;
+            return;
+        }
+
+        cache.local = local;
+        cache.matrix = parent != nullptr ? parent->matrix * ToMatrix(local) : ToMatrix(local);
+        cache.dirty = false;
+        cache.changed = true;
+    };
+
+    //Every depth only reads the one above it, so the entities within a depth can be updated in parallel.
+    for (size_t depth = 0; depth < queue.size(); depth++)
+    {
+        const std::vector<uint32_t> &indices = queue[depth];
+
+        ParallelFor(indices.size(), [&update, &indices](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                update(indices[i]);
+            }
+        }, 0, sizeof(WorldTransformComponent));
+
+        //Children of an entity that moved have to follow it.
+        for (uint32_t index : indices)
+        {
+            if (!caches[index].changed) continue;
+
+            changedEntities.push_back(entities[index]);
+            for (uint32_t i = hasHierarchy ? childStarts[index] : 0; hasHierarchy && i < childStarts[index + 1]; i++)
+            {
+                enqueue(children[i]);
+            }
+        }
+    }
+
+    PrepareDirtyLists();
+}
+
+void TransformHierarchy::RebuildHierarchy(entt::registry &registry)
+{
+    hierarchyChanged = false;
+
+    size_t count = registry.size<WorldTransformComponent>();
+    WorldTransformComponent *caches = registry.raw<WorldTransformComponent>();
+    const entt::entity *entities = registry.data<WorldTransformComponent>();
+    auto worldTransforms = registry.view<WorldTransformComponent>();
+
+    //Resolve parents first, an entity whose parent is gone or has no transform becomes a root.
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto *parent = registry.try_get<ParentComponent>(entities[i]);
+        bool hasParent = parent != nullptr && parent->parent != entities[i] && registry.valid(parent->parent) &&
+                         worldTransforms.contains(parent->parent);
+
+        caches[i].parent = hasParent ? parent->parent : entt::null;
+        caches[i].dirty = true;
+    }
+
+    uint32_t maxDepth = 0;
+    bool foundCycle = false;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t depth = 0;
+        for (entt::entity parent = caches[i].parent; parent != entt::null && depth < MAX_DEPTH; depth++)
+        {
+            parent = worldTransforms.get(parent).parent;
+        }
+
+        if (depth >= MAX_DEPTH)
+        {
+            foundCycle = true;
+            depth = 0;
+        }
+
+        caches[i].depth = depth;
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    //Entities in a cycle are roots, but only once every depth has been worked out from the original parents.
+    for (size_t i = 0; foundCycle && i < count; i++)
+    {
+        if (caches[i].depth == 0) caches[i].parent = entt::null;
+    }
+
+    if (foundCycle)
+    {
+        Logger::Log("[TransformHierarchy] [WRN] Found a cycle in the transform hierarchy, or one deeper than %i.",
+                    MAX_DEPTH);
+    }
+
+    depthCount = maxDepth + 1;
+
+    //Children of every entity, so a change can be passed down without looking at the rest of the hierarchy.
+    childStarts.assign(count + 1, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (caches[i].parent != entt::null) childStarts[&worldTransforms.get(caches[i].parent) - caches]++;
+    }
+
+    for (size_t i = 0, start = 0; i <= count; i++)
+    {
+        size_t childCount = childStarts[i];
+        childStarts[i] = (uint32_t) start;
+        start += childCount;
+    }
+
+    children.resize(childStarts[count]);
+    std::vector<uint32_t> childEnds(childStarts.begin(), childStarts.end() - 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (caches[i].parent == entt::null) continue;
+
+        size_t parent = &worldTransforms.get(caches[i].parent) - caches;
+        children[childEnds[parent]++] = (uint32_t) i;
+    }
+}
+
+void TransformHierarchy::PrepareDirtyLists()
+{
+    JobSystem *jobSystem = JobSystem::GetInstance();
+    size_t count = (jobSystem ? jobSystem->ThreadCount() : 1) + 1;
+
+    if (dirtyEntities.size() < count) dirtyEntities.resize(count);
+}
+
+void TransformHierarchy::MarkDirty(entt::registry &registry, entt::entity entity)
+{
+    //Lists are only ever added at the end of a frame, never while systems are running.
+    JobSystem *jobSystem = JobSystem::GetInstance();
+    uint32_t index = jobSystem ? jobSystem->ThreadIndex() : 0;
+    std::vector<entt::entity> &dirty = index < dirtyEntities.size() - 1 ? dirtyEntities[index] : dirtyEntities.back();
+
+    dirty.push_back(entity);
+}
+
+void TransformHierarchy::OnTransformConstruction(entt::registry &registry, entt::entity entity)
+{
+    if (!registry.has<WorldTransformComponent>(entity)) registry.emplace<WorldTransformComponent>(entity);
+
+    registry.get<WorldTransformComponent>(entity).dirty = true;
+    MarkDirty(registry, entity);
+
+    //New entries need a depth and a place among their parent's children, which only matters if there's a hierarchy.
+    if (registry.size<ParentComponent>() > 0) hierarchyChanged = true;
+}
+
+void TransformHierarchy::OnTransformUpdate(entt::registry &registry, entt::entity entity)
+{
+    //Patched many times in a frame, but only needs looking at once.
+    WorldTransformComponent &cache = registry.get<WorldTransformComponent>(entity);
+    if (cache.dirty) return;
+
+    cache.dirty = true;
+    MarkDirty(registry, entity);
+}
+
+void TransformHierarchy::OnTransformDestruction(entt::registry &registry, entt::entity entity)
+{
+    registry.remove_if_exists<WorldTransformComponent>(entity);
+
+    //Removing swaps the last entry into the gap, and children of this entity become roots.
+    if (registry.size<ParentComponent>() > 0) hierarchyChanged = true;
+}
+
+void TransformHierarchy::OnHierarchyChanged(entt::registry &registry, entt::entity entity)
+{
+    hierarchyChanged = true;
+}
+
+void TransformHierarchy::Init(World &world)
+{
+    auto registry = world.Registry();
+    PrepareDirtyLists();
+
+    registry->on_construct<TransformComponent>().connect<&TransformHierarchy::OnTransformConstruction>(this);
+    registry->on_update<TransformComponent>().connect<&TransformHierarchy::OnTransformUpdate>(this);
+    registry->on_destroy<TransformComponent>().connect<&TransformHierarchy::OnTransformDestruction>(this);
+    registry->on_construct<ParentComponent>().connect<&TransformHierarchy::OnHierarchyChanged>(this);
+    registry->on_update<ParentComponent>().connect<&TransformHierarchy::OnHierarchyChanged>(this);
+    registry->on_destroy<ParentComponent>().connect<&TransformHierarchy::OnHierarchyChanged>(this);
+
+    //Pick up anything that was created before this system was.
+    auto missing = registry->view<TransformComponent>(entt::exclude<WorldTransformComponent>);
+    std::vector<entt::entity> entities(missing.begin(), missing.end());
+    registry->insert<WorldTransformComponent>(entities.begin(), entities.end());
+
+    hierarchyChanged = true;
+}
+
+void TransformHierarchy::Shutdown(World &world)
+{
+    auto registry = world.Registry();
+
+    registry->on_construct<TransformComponent>().disconnect<&TransformHierarchy::OnTransformConstruction>(this);
+    registry->on_update<TransformComponent>().disconnect<&TransformHierarchy::OnTransformUpdate>(this);
+    registry->on_destroy<TransformComponent>().disconnect<&TransformHierarchy::OnTransformDestruction>(this);
+    registry->on_construct<ParentComponent>().disconnect<&TransformHierarchy::OnHierarchyChanged>(this);
+    registry->on_update<ParentComponent>().disconnect<&TransformHierarchy::OnHierarchyChanged>(this);
+    registry->on_destroy<ParentComponent>().disconnect<&TransformHierarchy::OnHierarchyChanged>(this);
+}
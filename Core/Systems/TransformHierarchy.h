@@ -0,0 +1,69 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_TRANSFORMHIERARCHY_H
+#define RELIC_TRANSFORMHIERARCHY_H
+
+#include <Core/ISystem.h>
+#include <Libraries/entt/entt.hpp>
+#include <vector>
+
+/// Keeps a WorldTransformComponent up to date for every entity with a TransformComponent, taking ParentComponent and
+/// render interpolation into account.
+///
+/// Entities are updated one depth of the hierarchy at a time, so each depth can be updated in parallel once the one
+/// above it is done. Only entities whose TransformComponent was patched or replaced, interpolated entities and the
+/// children of anything that moved are looked at, static entities cost nothing per frame. Registered after gameplay
+/// systems and before the renderer.
+class TransformHierarchy : public ISystem
+{
+public:
+    TransformHierarchy();
+
+    void Tick(World &world) override;
+    void FrameTick(World &world) override;
+    void Init(World &world) override;
+    void Shutdown(World &world) override;
+
+private:
+    //Deeper hierarchies are assumed to be cycles, and the entity is treated as a root.
+    static constexpr uint32_t MAX_DEPTH = 64;
+
+    void OnTransformConstruction(entt::registry &registry, entt::entity entity);
+    void OnTransformUpdate(entt::registry &registry, entt::entity entity);
+    void OnTransformDestruction(entt::registry &registry, entt::entity entity);
+    void OnHierarchyChanged(entt::registry &registry, entt::entity entity);
+
+    /// Recalculate depths, parents and children.
+    void RebuildHierarchy(entt::registry &registry);
+
+    /// Make sure every job system thread has a dirty list. Must not be called while systems are running.
+    void PrepareDirtyLists();
+
+    /// Queue an entity for the next update. Safe to call from systems running in parallel.
+    void MarkDirty(entt::registry &registry, entt::entity entity);
+
+    bool hierarchyChanged = true;
+
+    //Number of depths in the hierarchy, as of the last rebuild.
+    uint32_t depthCount = 1;
+
+    //Children of each world transform, those of index i run from childStarts[i] up to childStarts[i + 1]. Only valid
+    //while there's a hierarchy and it hasn't changed.
+    std::vector<uint32_t> childStarts;
+    std::vector<uint32_t> children;
+
+    //Entities whose transform changed since the last update. One per job system thread, plus one shared by threads
+    //outside the job system.
+    std::vector<std::vector<entt::entity>> dirtyEntities;
+
+    //Indices of the world transforms to update, per depth.
+    std::vector<std::vector<uint32_t>> queue;
+
+    //Entities whose matrix changed during the last update, so their changed flag can be cleared on the next one.
+    std::vector<entt::entity> changedEntities;
+};
+
+
+#endif //RELIC_TRANSFORMHIERARCHY_H
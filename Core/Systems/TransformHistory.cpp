@@ -0,0 +1,41 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "TransformHistory.h"
+#include <Core/World.h>
+#include <Core/Components/TransformComponent.h>
+#include <Core/Components/PreviousTransformComponent.h>
+#include <Concurrency/Jobs/ParallelFor.h>
+
+TransformHistory::TransformHistory()
+{
+    NeedsTick = true;
+    NeedsFrameTick = false;
+
+    Reads<TransformComponent>();
+    Writes<PreviousTransformComponent>();
+}
+
+void TransformHistory::Tick(World &world)
+{
+    auto registry = world.Registry();
+    auto view = registry->view<PreviousTransformComponent, const TransformComponent>();
+
+    ParallelEach(view, [&view](entt::entity entity)
+    {
+        view.get<PreviousTransformComponent>(entity).transform = view.get<const TransformComponent>(entity);
+    });
+}
+
+void TransformHistory::FrameTick(World &world)
+{
+}
+
+void TransformHistory::Init(World &world)
+{
+}
+
+void TransformHistory::Shutdown(World &world)
+{
+}
@@ -0,0 +1,24 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_TRANSFORMHISTORY_H
+#define RELIC_TRANSFORMHISTORY_H
+
+#include <Core/ISystem.h>
+
+/// Stores the transform of interpolated entities before each tick runs, so the renderer has the two most recent
+/// simulation states to blend between. Registered right after Time so it runs before anything moves.
+class TransformHistory : public ISystem
+{
+public:
+    TransformHistory();
+
+    void Tick(World &world) override;
+    void FrameTick(World &world) override;
+    void Init(World &world) override;
+    void Shutdown(World &world) override;
+};
+
+
+#endif //RELIC_TRANSFORMHISTORY_H
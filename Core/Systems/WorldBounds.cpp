@@ -0,0 +1,87 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "WorldBounds.h"
+#include <Core/World.h>
+#include <Core/Components/WorldTransformComponent.h>
+#include <Core/Components/WorldBoundsComponent.h>
+#include <Graphics/Components/MeshComponent.h>
+#include <Concurrency/Jobs/ParallelFor.h>
+
+WorldBounds::WorldBounds()
+{
+    NeedsTick = false;
+    NeedsFrameTick = true;
+
+    Reads<MeshComponent>();
+    Reads<WorldTransformComponent>();
+    Writes<WorldBoundsComponent>();
+}
+
+void WorldBounds::Tick(World &world)
+{
+}
+
+void WorldBounds::FrameTick(World &world)
+{
+    auto registry = world.Registry();
+    auto bounds = registry->view<WorldBoundsComponent>();
+    auto meshes = registry->view<const MeshComponent>();
+    auto worldTransforms = registry->view<const WorldTransformComponent>();
+
+    ParallelEach(bounds, [&bounds, &meshes, &worldTransforms](entt::entity entity)
+    {
+        //Entities without a transform yet stay dirty until they have one.
+        if (!worldTransforms.contains(entity)) return;
+
+        WorldBoundsComponent &worldBounds = bounds.get(entity);
+        const WorldTransformComponent &worldTransform = worldTransforms.get(entity);
+        worldBounds.changed = worldBounds.dirty || worldTransform.changed;
+        if (!worldBounds.changed) return;
+
+        const Mesh *mesh = meshes.get(entity).mesh;
+        Bounds local = mesh != nullptr ? mesh->bounds : Bounds{glm::vec3(0.0f), glm::vec3(0.0f), 0.0f};
+
+        worldBounds.bounds = TransformBounds(local, worldTransform.matrix);
+        worldBounds.dirty = false;
+    });
+}
+
+void WorldBounds::OnMeshConstruction(entt::registry &registry, entt::entity entity)
+{
+    registry.emplace_or_replace<WorldBoundsComponent>(entity);
+}
+
+void WorldBounds::OnMeshUpdate(entt::registry &registry, entt::entity entity)
+{
+    if (registry.has<WorldBoundsComponent>(entity)) registry.get<WorldBoundsComponent>(entity).dirty = true;
+}
+
+void WorldBounds::OnMeshDestruction(entt::registry &registry, entt::entity entity)
+{
+    registry.remove_if_exists<WorldBoundsComponent>(entity);
+}
+
+void WorldBounds::Init(World &world)
+{
+    auto registry = world.Registry();
+
+    registry->on_construct<MeshComponent>().connect<&WorldBounds::OnMeshConstruction>();
+    registry->on_update<MeshComponent>().connect<&WorldBounds::OnMeshUpdate>();
+    registry->on_destroy<MeshComponent>().connect<&WorldBounds::OnMeshDestruction>();
+
+    //Pick up anything that was created before this system was.
+    auto missing = registry->view<MeshComponent>(entt::exclude<WorldBoundsComponent>);
+    std::vector<entt::entity> entities(missing.begin(), missing.end());
+    registry->insert<WorldBoundsComponent>(entities.begin(), entities.end());
+}
+
+void WorldBounds::Shutdown(World &world)
+{
+    auto registry = world.Registry();
+
+    registry->on_construct<MeshComponent>().disconnect<&WorldBounds::OnMeshConstruction>();
+    registry->on_update<MeshComponent>().disconnect<&WorldBounds::OnMeshUpdate>();
+    registry->on_destroy<MeshComponent>().disconnect<&WorldBounds::OnMeshDestruction>();
+}
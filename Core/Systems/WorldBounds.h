@@ -0,0 +1,31 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_WORLDBOUNDS_H
+#define RELIC_WORLDBOUNDS_H
+
+#include <Core/ISystem.h>
+#include <Libraries/entt/entt.hpp>
+
+/// Keeps a WorldBoundsComponent up to date for every entity with a MeshComponent, by transforming the mesh's bounds
+/// with the cached world matrix. Only entities whose world transform or mesh changed are recalculated. Registered right
+/// after TransformHierarchy.
+class WorldBounds : public ISystem
+{
+public:
+    WorldBounds();
+
+    void Tick(World &world) override;
+    void FrameTick(World &world) override;
+    void Init(World &world) override;
+    void Shutdown(World &world) override;
+
+private:
+    static void OnMeshConstruction(entt::registry &registry, entt::entity entity);
+    static void OnMeshUpdate(entt::registry &registry, entt::entity entity);
+    static void OnMeshDestruction(entt::registry &registry, entt::entity entity);
+};
+
+
+#endif //RELIC_WORLDBOUNDS_H
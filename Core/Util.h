@@ -5,6 +5,8 @@
 #ifndef RELIC_2_0_UTIL_H
 #define RELIC_2_0_UTIL_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <fstream>
 
@@ -36,4 +38,19 @@ static std::vector<char> ReadFile(const std::string& fileName)
     return buffer;
 }
 
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+/// Hash bytes with FNV-1a. Several pieces can be hashed together by passing the previous result as the hash.
+static uint64_t HashBytes(const void *data, size_t size, uint64_t hash = FNV_OFFSET_BASIS)
+{
+    auto bytes = (const uint8_t *) data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
 #endif //RELIC_2_0_UTIL_H
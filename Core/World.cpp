@@ -3,6 +3,12 @@
 //
 
 #include "World.h"
+#include <algorithm>
+
+World::World()
+{
+    ClearSystemCache();
+}
 
 entt::registry *World::Registry()
 {
@@ -11,40 +17,112 @@ entt::registry *World::Registry()
 
 void World::Tick()
 {
-    for (auto system : systems)
-    {
-        if (!system->NeedsTick) continue;
-        system->Tick(*this);
-    }
+    PrepareCommandBuffers();
+
+    inPass = true;
+    scheduler.Run(*this, systems, SystemPass::Tick);
+    inPass = false;
+
+    FlushCommands();
+    ApplyPendingSystemChanges();
 }
 
 void World::RegisterSystem(ISystem *system)
 {
+    if (inPass)
+    {
+        std::lock_guard<std::mutex> lock(pendingSystemsMutex);
+        pendingRegistrations.push_back(system);
+        return;
+    }
+
     systems.push_back(system);
+    ClearSystemCache();
 }
 
 void World::RemoveSystem(ISystem *system)
 {
-    auto iterator = systems.begin();
-    while (iterator != systems.end())
+    if (inPass)
+    {
+        std::lock_guard<std::mutex> lock(pendingSystemsMutex);
+        pendingRemovals.push_back(system);
+        return;
+    }
+
+    auto iterator = std::find(systems.begin(), systems.end(), system);
+    if (iterator != systems.end())
+    {
+        systems.erase(iterator);
+        ClearSystemCache();
+    }
+}
+
+void World::ClearSystemCache()
+{
+    for (auto &entry : systemCache)
+    {
+        entry.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+void World::ApplyPendingSystemChanges()
+{
+    std::lock_guard<std::mutex> lock(pendingSystemsMutex);
+
+    for (auto system : pendingRegistrations)
+    {
+        RegisterSystem(system);
+    }
+
+    for (auto system : pendingRemovals)
     {
-        if (*iterator == system)
-        {
-            systems.erase(iterator);
-            break;
-        }
+        RemoveSystem(system);
     }
+
+    pendingRegistrations.clear();
+    pendingRemovals.clear();
 }
 
 void World::FrameTick()
 {
-    for (auto system : systems)
+    PrepareCommandBuffers();
+
+    inPass = true;
+    scheduler.Run(*this, systems, SystemPass::FrameTick);
+    inPass = false;
+
+    FlushCommands();
+    ApplyPendingSystemChanges();
+}
+
+void World::PrepareCommandBuffers()
+{
+    JobSystem *jobSystem = JobSystem::GetInstance();
+    size_t count = (jobSystem ? jobSystem->ThreadCount() : 1) + 1;
+
+    while (commandBuffers.size() < count)
     {
-        if (!system->NeedsFrameTick) continue;
-        system->FrameTick(*this);
+        commandBuffers.emplace_back(new EntityCommandBuffer());
     }
 }
 
+EntityCommandBuffer &World::Commands()
+{
+    //Buffers are only ever added here or at the start of a pass, never while systems are running.
+    if (commandBuffers.empty()) PrepareCommandBuffers();
+
+    JobSystem *jobSystem = JobSystem::GetInstance();
+    uint32_t index = jobSystem ? jobSystem->ThreadIndex() : 0;
+
+    if (index >= commandBuffers.size() - 1) return *commandBuffers.back();
+    return *commandBuffers[index];
+}
+
+void World::FlushCommands()
+{
+    EntityCommandBuffer::Playback(registry, commandBuffers);
+}
+
 World::~World()
 {
     //Cleanup all our entities
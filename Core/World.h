@@ -6,22 +6,62 @@
 #define RELIC_WORLD_H
 
 #include <Libraries/entt/entt.hpp>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <memory>
 #include "ISystem.h"
+#include "SystemScheduler.h"
+#include "EntityCommandBuffer.h"
 
 class World
 {
 private:
     entt::registry registry;
     std::vector<ISystem*> systems;
+    SystemScheduler scheduler;
+
+    static constexpr uint32_t MAX_CACHED_SYSTEM_TYPES = 128;
+
+    //Systems found by GetSystem, indexed by SystemTypeIndex. Cleared whenever the set of systems changes.
+    mutable std::array<std::atomic<ISystem*>, MAX_CACHED_SYSTEM_TYPES> systemCache;
+
+    //Systems can't be added or removed while a pass is iterating them, so changes made mid pass wait until it's over.
+    bool inPass = false;
+    std::mutex pendingSystemsMutex;
+    std::vector<ISystem*> pendingRegistrations;
+    std::vector<ISystem*> pendingRemovals;
+
+    void ClearSystemCache();
+    void ApplyPendingSystemChanges();
+
+    //One per job system thread, plus one shared by threads outside the job system.
+    std::vector<std::unique_ptr<EntityCommandBuffer>> commandBuffers;
+
+    void PrepareCommandBuffers();
 
 public:
+    World();
+
     entt::registry * Registry();
 
+    /// Command buffer for the calling thread. Structural changes made from systems should go through here, they are
+    /// applied once the current pass has finished.
+    EntityCommandBuffer &Commands();
+
+    /// Apply every recorded command. Called automatically at the end of Tick and FrameTick.
+    void FlushCommands();
+
     void Tick();
     void FrameTick();
+
+    /// Add a system to the world. If a pass is running, the system is added once it has finished.
     void RegisterSystem(ISystem* system);
+
+    /// Remove a system from the world. If a pass is running, the system is removed once it has finished.
     void RemoveSystem(ISystem* system);
 
+    /// Find the first system that is (or derives from) T. Constant time after the first lookup of each type.
     template <typename T>
     T * GetSystem() const;
 
@@ -31,12 +71,21 @@ public:
 template<typename T>
 T * World::GetSystem() const
 {
+    uint32_t index = SystemTypeIndex::Get<T>();
+
+    if (index < MAX_CACHED_SYSTEM_TYPES)
+    {
+        ISystem* cached = systemCache[index].load(std::memory_order_acquire);
+        if (cached != nullptr) return static_cast<T*>(cached);
+    }
+
     T* ptr;
     for(auto * system : systems)
     {
         ptr = dynamic_cast<T*>(system);
         if(ptr != nullptr)
         {
+            if (index < MAX_CACHED_SYSTEM_TYPES) systemCache[index].store(ptr, std::memory_order_release);
             return ptr;
         }
     }
@@ -0,0 +1,108 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include <string>
+#include <chrono>
+#include "World.h"
+#include <Concurrency/Jobs/JobSystem.h>
+#include <Debugging/Benchmark.h>
+#include <Debugging/Logger.h>
+
+static const uint32_t ENTITIES_PER_WORLD = 50000;
+static const uint32_t TICKS = 100;
+static const float TICK_LENGTH = 1.0f / 30.0f;
+
+struct BenchmarkPosition
+{
+    float x, y, z;
+};
+
+struct BenchmarkVelocity
+{
+    float x, y, z;
+};
+
+/// Minimal simulation system, integrates velocity into position for every entity.
+class BenchmarkIntegrator : public ISystem
+{
+public:
+    BenchmarkIntegrator()
+    {
+        Reads<BenchmarkVelocity>();
+        Writes<BenchmarkPosition>();
+    }
+
+    void Tick(World &world) override
+    {
+        world.Registry()->view<BenchmarkPosition, const BenchmarkVelocity>().each(
+                [](BenchmarkPosition &position, const BenchmarkVelocity &velocity)
+                {
+                    position.x += velocity.x * TICK_LENGTH;
+                    position.y += velocity.y * TICK_LENGTH;
+                    position.z += velocity.z * TICK_LENGTH;
+                });
+    }
+
+    void FrameTick(World &world) override
+    {}
+
+    void Init(World &world) override
+    {}
+
+    void Shutdown(World &world) override
+    {}
+};
+
+static void RunWorldBenchmark()
+{
+    JobSystem jobSystem;
+    BenchmarkIntegrator integrator;
+
+    uint32_t maxWorlds = std::max(1u, jobSystem.ThreadCount()) * 2;
+
+    for (uint32_t worldCount = 1; worldCount <= maxWorlds; worldCount *= 2)
+    {
+        std::vector<World *> worlds;
+        for (uint32_t i = 0; i < worldCount; i++)
+        {
+            auto world = new World();
+            world->RegisterSystem(&integrator);
+
+            auto registry = world->Registry();
+            std::vector<entt::entity> entities(ENTITIES_PER_WORLD);
+            registry->create(entities.begin(), entities.end());
+            registry->insert<BenchmarkPosition>(entities.begin(), entities.end(), BenchmarkPosition{0.0f, 0.0f, 0.0f});
+            registry->insert<BenchmarkVelocity>(entities.begin(), entities.end(), BenchmarkVelocity{1.0f, 2.0f, 3.0f});
+
+            worlds.push_back(world);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t tick = 0; tick < TICKS; tick++)
+        {
+            JobCounter counter;
+            for (auto world : worlds)
+            {
+                jobSystem.Run([world]()
+                              {
+                                  world->Tick();
+                              }, &counter);
+            }
+            jobSystem.Wait(counter);
+        }
+        double seconds = Benchmark::SecondsSince(start);
+
+        double updates = (double) worldCount * ENTITIES_PER_WORLD * TICKS;
+        Logger::Log("%i world(s): %sms, %s million entity updates/s", worldCount, std::to_string(seconds * 1000.0).c_str(),
+                    std::to_string(updates / seconds / 1e6).c_str());
+
+        for (auto world : worlds)
+        {
+            world->RemoveSystem(&integrator);
+            delete world;
+        }
+    }
+}
+
+static BenchmarkRegistrar registrar("worlds", &RunWorldBenchmark);
@@ -0,0 +1,616 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "WorldSnapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <Core/World.h>
+#include <Core/Components/TransformComponent.h>
+#include <Core/Components/PreviousTransformComponent.h>
+#include <Core/Components/ParentComponent.h>
+#include <Core/Components/SingletonEntityComponent.h>
+#include <Graphics/Components/CameraComponent.h>
+#include <Graphics/Components/MeshComponent.h>
+#include <Graphics/MaterialUtil.h>
+#include <Gameplay/Components/FPSCameraComponent.h>
+#include <ResourceManager/ResourceManager.h>
+#include <ResourceManager/Compression/lz4/lz4.h>
+#include <Debugging/Logger.h>
+
+/*
+ * Layout:
+ *
+ * Entity count
+ * Entities[]
+ * Pool[]
+ *  Id, element size, count
+ *  Entities[]
+ *  Components[]
+ *
+ * Every array starts on a 16 byte boundary so it can be read in place. On disk this is preceded by a FileHeader, and
+ * may be LZ4 compressed as a whole.
+ */
+
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x504E5352; //"RSNP"
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+static constexpr uint32_t SNAPSHOT_FLAG_COMPRESSED = 1u << 0u;
+static constexpr size_t SNAPSHOT_ALIGNMENT = 16;
+static constexpr size_t MESH_CACHE_SIZE = 64;
+
+enum SnapshotPool : uint32_t
+{
+    SNAPSHOT_POOL_END = 0,
+    SNAPSHOT_POOL_TRANSFORM,
+    SNAPSHOT_POOL_PREVIOUS_TRANSFORM,
+    SNAPSHOT_POOL_CAMERA,
+    SNAPSHOT_POOL_FPS_CAMERA,
+    //Mesh and material GUID pairs referenced by the mesh pool.
+    SNAPSHOT_POOL_MESH_TABLE,
+    //Index into the mesh table for every entity with a MeshComponent.
+    SNAPSHOT_POOL_MESH,
+    SNAPSHOT_POOL_PARENT
+};
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t dataSize;
+    uint64_t storedSize;
+};
+
+struct alignas(SNAPSHOT_ALIGNMENT) PoolHeader
+{
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t count;
+};
+
+struct MeshRecord
+{
+    uint32_t mesh;
+    uint32_t material;
+};
+
+/// Appends aligned arrays to a buffer. Without a buffer it only counts, so the exact size can be found up front.
+class SnapshotWriter
+{
+public:
+    explicit SnapshotWriter(unsigned char *buffer) : buffer(buffer)
+    {}
+
+    void Write(const void *bytes, size_t size)
+    {
+        if (buffer != nullptr && size > 0) memcpy(buffer + offset, bytes, size);
+        offset = (offset + size + SNAPSHOT_ALIGNMENT - 1) & ~(SNAPSHOT_ALIGNMENT - 1);
+    }
+
+    template<typename T>
+    void Write(const T &value)
+    {
+        Write(&value, sizeof(T));
+    }
+
+    [[nodiscard]] size_t Offset() const
+    {
+        return offset;
+    }
+
+private:
+    unsigned char *buffer;
+    size_t offset = 0;
+};
+
+/// Reads arrays in place from a buffer written by SnapshotWriter.
+class SnapshotReader
+{
+public:
+    SnapshotReader(const unsigned char *buffer, size_t size) : buffer(buffer), size(size)
+    {}
+
+    /// \return A pointer to the next count elements, or nullptr if the buffer is too short.
+    template<typename T>
+    const T *Read(uint64_t count = 1)
+    {
+        uint64_t bytes = count * sizeof(T);
+        if (count > size || bytes > size - offset) return nullptr;
+
+        const T *result = reinterpret_cast<const T *>(buffer + offset);
+        offset = std::min<size_t>(size, (offset + bytes + SNAPSHOT_ALIGNMENT - 1) & ~(SNAPSHOT_ALIGNMENT - 1));
+        return result;
+    }
+
+private:
+    const unsigned char *buffer;
+    size_t size;
+    size_t offset = 0;
+};
+
+using EntityTraits = entt::entt_traits<std::underlying_type_t<entt::entity>>;
+
+/// Whether the slot at an index of an entt entity array holds a live entity rather than a link in the free list.
+static bool IsLive(const entt::entity *entities, size_t slot)
+{
+    return (entt::to_integral(entities[slot]) & EntityTraits::entity_mask) == slot;
+}
+
+/// Destroy every entity that doesn't belong to a singleton system.
+static void DestroyEntities(entt::registry &registry)
+{
+    std::vector<entt::entity> entities;
+    entities.reserve(registry.alive());
+    registry.each([&](entt::entity entity)
+                  {
+                      if (!registry.has<SingletonEntityComponent>(entity)) entities.push_back(entity);
+                  });
+
+    registry.destroy(entities.begin(), entities.end());
+}
+
+/// Replace every entity that doesn't belong to a singleton system with the ones in a snapshot, keeping their
+/// identifiers and versions. Entities that are alive in both are left as they are, along with their components. No
+/// slot that's live in the snapshot may be taken by a singleton entity.
+static void ReplaceEntities(entt::registry &registry, const entt::entity *entities, size_t count,
+                            const std::vector<entt::entity> &singletons)
+{
+    std::vector<bool> unchanged(count);
+    for (size_t slot = 0; slot < count; slot++)
+    {
+        unchanged[slot] = IsLive(entities, slot) && registry.valid(entities[slot]);
+    }
+
+    //Make every slot live, so the free list can be rebuilt in the order the snapshot's entities are created in below.
+    //Without that, each create with a hint has to walk the free list to find its slot.
+    size_t slotCount = std::max<size_t>(count, registry.size());
+    for (size_t i = registry.alive(); i < slotCount; i++) registry.create();
+
+    std::vector<bool> kept(slotCount);
+    for (entt::entity singleton : singletons) kept[entt::to_integral(singleton) & EntityTraits::entity_mask] = true;
+
+    //Slots the snapshot leaves free go first, so they end up at the back of the free list with the snapshot's versions.
+    for (size_t slot = slotCount; slot-- > 0;)
+    {
+        if (kept[slot] || (slot < count && IsLive(entities, slot))) continue;
+
+        entt::entity entity = registry.data()[slot];
+        if (slot < count) registry.destroy(entity, entt::registry::version(entities[slot]));
+        else registry.destroy(entity);
+    }
+
+    //Then the live ones from the back, which leaves the lowest at the front of the free list for each create to take.
+    for (size_t slot = count; slot-- > 0;)
+    {
+        if (IsLive(entities, slot) && !unchanged[slot]) registry.destroy(registry.data()[slot]);
+    }
+
+    for (size_t slot = 0; slot < count; slot++)
+    {
+        if (IsLive(entities, slot) && !unchanged[slot]) registry.create(entities[slot]);
+    }
+}
+
+template<typename T>
+static void WritePool(SnapshotWriter &writer, const entt::registry &registry, uint32_t id)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable components can be bulk copied.");
+
+    uint64_t count = registry.size<T>();
+    writer.Write(PoolHeader{id, sizeof(T), count});
+    writer.Write(registry.data<T>(), count * sizeof(entt::entity));
+    writer.Write(registry.raw<T>(), count * sizeof(T));
+}
+
+template<typename T>
+static bool ReadPool(SnapshotReader &reader, entt::registry &registry, const PoolHeader &header)
+{
+    if (header.elementSize != sizeof(T))
+    {
+        Logger::Log("[WorldSnapshot] [ERR] Component size mismatch in pool %i.", header.id);
+        return false;
+    }
+
+    const auto *entities = reader.Read<entt::entity>(header.count);
+    const auto *components = reader.Read<T>(header.count);
+    if (entities == nullptr || components == nullptr) return false;
+
+    registry.insert<T>(entities, entities + header.count, components, components + header.count);
+    return true;
+}
+
+/// Bring the mesh components of a restored world in line with a snapshot. Creating and destroying mesh components
+/// prepares and releases render data, so components that already match are left alone, and meshes that are about to
+/// change hands are added to their new entities before being removed from the old ones.
+static void RestoreMeshes(entt::registry &registry, const entt::entity *entities, const uint32_t *indices,
+                          uint64_t count, const std::vector<MeshComponent> &table)
+{
+    //Entries whose mesh isn't loaded are marked with a GUID and no mesh, entities using them are dropped.
+    std::vector<bool> resolved(table.size());
+    for (size_t i = 0; i < table.size(); i++)
+    {
+        resolved[i] = table[i].mesh != nullptr || table[i].guid == GUID_INVALID;
+    }
+
+    std::vector<entt::entity> added, changed, removed;
+    std::vector<MeshComponent> addedComponents, changedComponents;
+    //Indexed by entity slot.
+    std::vector<bool> restored(registry.size());
+    size_t dropped = 0;
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        const MeshComponent &component = table[indices[i]];
+        if (!resolved[indices[i]])
+        {
+            dropped++;
+            continue;
+        }
+
+        restored[entt::to_integral(entities[i]) & EntityTraits::entity_mask] = true;
+
+        const auto *current = registry.try_get<MeshComponent>(entities[i]);
+        if (current == nullptr)
+        {
+            added.push_back(entities[i]);
+            addedComponents.push_back(component);
+        } else if (current->mesh != component.mesh || current->material != component.material)
+        {
+            changed.push_back(entities[i]);
+            changedComponents.push_back(component);
+        }
+    }
+
+    for (entt::entity entity : registry.view<const MeshComponent>(entt::exclude<SingletonEntityComponent>))
+    {
+        if (!restored[entt::to_integral(entity) & EntityTraits::entity_mask]) removed.push_back(entity);
+    }
+
+    registry.insert<MeshComponent>(added.begin(), added.end(), addedComponents.begin(), addedComponents.end());
+    registry.remove<MeshComponent>(removed.begin(), removed.end());
+    registry.remove<MeshComponent>(changed.begin(), changed.end());
+    registry.insert<MeshComponent>(changed.begin(), changed.end(), changedComponents.begin(), changedComponents.end());
+
+    if (dropped > 0)
+    {
+        Logger::Log("[WorldSnapshot] [WRN] Dropped %s mesh components that reference meshes that aren't loaded.",
+                    std::to_string(dropped).c_str());
+    }
+}
+
+static bool ReadMeshPool(SnapshotReader &reader, entt::registry &registry, const PoolHeader &header,
+                         const std::vector<MeshComponent> &table)
+{
+    const auto *entities = reader.Read<entt::entity>(header.count);
+    const auto *indices = reader.Read<uint32_t>(header.count);
+    if (entities == nullptr || indices == nullptr) return false;
+
+    for (uint64_t i = 0; i < header.count; i++)
+    {
+        if (indices[i] >= table.size()) return false;
+    }
+
+    RestoreMeshes(registry, entities, indices, header.count, table);
+    return true;
+}
+
+WorldSnapshot WorldSnapshot::Capture(World &world)
+{
+    return Capture(*world.Registry());
+}
+
+WorldSnapshot WorldSnapshot::Capture(const entt::registry &registry)
+{
+    //Meshes are shared by many entities, so store each mesh and material pair once and give entities an index. A small
+    //direct mapped cache in front of the hash map catches almost every lookup, as levels only use a handful of meshes.
+    struct MeshKey
+    {
+        const Mesh *mesh;
+        const Material *material;
+        uint32_t index;
+    };
+
+    std::vector<MeshRecord> meshTable;
+    std::vector<uint32_t> meshIndices(registry.size<MeshComponent>());
+    std::unordered_map<const Mesh *, std::unordered_map<const Material *, uint32_t>> meshLookup;
+    MeshKey recentMeshes[MESH_CACHE_SIZE] = {};
+
+    const MeshComponent *meshComponents = registry.raw<MeshComponent>();
+    for (size_t i = 0; i < meshIndices.size(); i++)
+    {
+        const MeshComponent &component = meshComponents[i];
+
+        size_t hash = (reinterpret_cast<size_t>(component.mesh) >> 4u) ^ (reinterpret_cast<size_t>(component.material) >> 6u);
+        MeshKey &recent = recentMeshes[hash % MESH_CACHE_SIZE];
+        if (recent.mesh == component.mesh && recent.material == component.material && recent.mesh != nullptr)
+        {
+            meshIndices[i] = recent.index;
+            continue;
+        }
+
+        auto inserted = meshLookup[component.mesh].emplace(component.material, (uint32_t) meshTable.size());
+        if (inserted.second)
+        {
+            meshTable.push_back({component.mesh ? (uint32_t) component.mesh->guid : (uint32_t) GUID_INVALID,
+                                 component.material ? (uint32_t) component.material->guid : (uint32_t) GUID_INVALID});
+        }
+
+        meshIndices[i] = inserted.first->second;
+        recent = {component.mesh, component.material, meshIndices[i]};
+    }
+
+    //Entities of singleton systems are stored as free slots, they're left alone on restore.
+    std::vector<entt::entity> entities(registry.data(), registry.data() + registry.size());
+    for (entt::entity singleton : registry.view<const SingletonEntityComponent>())
+    {
+        auto slot = entt::to_integral(singleton) & EntityTraits::entity_mask;
+        auto version = entt::to_integral(singleton) & (EntityTraits::version_mask << EntityTraits::entity_shift);
+        entities[slot] = entt::entity{EntityTraits::entity_mask | version};
+    }
+
+    auto write = [&](SnapshotWriter &writer)
+    {
+        uint64_t entityCount = entities.size();
+        writer.Write(entityCount);
+        writer.Write(entities.data(), entityCount * sizeof(entt::entity));
+
+        WritePool<TransformComponent>(writer, registry, SNAPSHOT_POOL_TRANSFORM);
+        WritePool<PreviousTransformComponent>(writer, registry, SNAPSHOT_POOL_PREVIOUS_TRANSFORM);
+        WritePool<CameraComponent>(writer, registry, SNAPSHOT_POOL_CAMERA);
+        WritePool<FPSCameraComponent>(writer, registry, SNAPSHOT_POOL_FPS_CAMERA);
+        WritePool<ParentComponent>(writer, registry, SNAPSHOT_POOL_PARENT);
+
+        writer.Write(PoolHeader{SNAPSHOT_POOL_MESH_TABLE, sizeof(MeshRecord), meshTable.size()});
+        writer.Write(meshTable.data(), meshTable.size() * sizeof(MeshRecord));
+
+        writer.Write(PoolHeader{SNAPSHOT_POOL_MESH, sizeof(uint32_t), meshIndices.size()});
+        writer.Write(registry.data<MeshComponent>(), meshIndices.size() * sizeof(entt::entity));
+        writer.Write(meshIndices.data(), meshIndices.size() * sizeof(uint32_t));
+
+        writer.Write(PoolHeader{SNAPSHOT_POOL_END, 0, 0});
+    };
+
+    SnapshotWriter measure(nullptr);
+    write(measure);
+
+    WorldSnapshot snapshot;
+    snapshot.size = measure.Offset();
+    snapshot.data.reset(new unsigned char[snapshot.size]);
+
+    SnapshotWriter writer(snapshot.data.get());
+    write(writer);
+
+    return snapshot;
+}
+
+bool WorldSnapshot::Restore(World &world) const
+{
+    return Restore(*world.Registry());
+}
+
+bool WorldSnapshot::Restore(entt::registry &registry) const
+{
+    if (Empty()) return false;
+
+    SnapshotReader reader(data.get(), size);
+
+    const auto *entityCount = reader.Read<uint64_t>();
+    if (entityCount == nullptr) return false;
+
+    const auto *entities = reader.Read<entt::entity>(*entityCount);
+    if (entities == nullptr) return false;
+
+    //Singleton entities created after the snapshot was taken can sit in slots the snapshot needs.
+    std::vector<entt::entity> singletons;
+    for (entt::entity singleton : registry.view<SingletonEntityComponent>())
+    {
+        size_t slot = entt::to_integral(singleton) & EntityTraits::entity_mask;
+        if (slot < *entityCount && IsLive(entities, slot))
+        {
+            Logger::Log("[WorldSnapshot] [ERR] Snapshot entity %i is taken by a singleton.", (int) slot);
+            return false;
+        }
+
+        singletons.push_back(singleton);
+    }
+
+    //Clearing whole pools is far cheaper than removing components entity by entity, destroying the entities after only
+    //has to walk what's left over from component types the snapshot doesn't know about. Mesh components are the
+    //exception, they're updated in place so render data isn't released and prepared again.
+    registry.clear<TransformComponent, PreviousTransformComponent, CameraComponent, FPSCameraComponent,
+            ParentComponent>();
+    ReplaceEntities(registry, entities, *entityCount, singletons);
+
+    std::vector<MeshComponent> meshTable;
+    bool meshesRestored = false;
+    bool valid = true;
+
+    while (valid)
+    {
+        const auto *header = reader.Read<PoolHeader>();
+        if (header == nullptr)
+        {
+            valid = false;
+            break;
+        }
+
+        switch (header->id)
+        {
+            case SNAPSHOT_POOL_END:
+                if (!meshesRestored) RestoreMeshes(registry, nullptr, nullptr, 0, meshTable);
+                return true;
+            case SNAPSHOT_POOL_TRANSFORM:
+                valid = ReadPool<TransformComponent>(reader, registry, *header);
+                break;
+            case SNAPSHOT_POOL_PREVIOUS_TRANSFORM:
+                valid = ReadPool<PreviousTransformComponent>(reader, registry, *header);
+                break;
+            case SNAPSHOT_POOL_CAMERA:
+                valid = ReadPool<CameraComponent>(reader, registry, *header);
+                break;
+            case SNAPSHOT_POOL_FPS_CAMERA:
+                valid = ReadPool<FPSCameraComponent>(reader, registry, *header);
+                break;
+            case SNAPSHOT_POOL_MESH_TABLE:
+            {
+                const auto *records = reader.Read<MeshRecord>(header->count);
+                if (records == nullptr)
+                {
+                    valid = false;
+                    break;
+                }
+
+                ResourceManager *resourceManager = ResourceManager::GetInstance();
+                meshTable.resize(header->count);
+                for (uint64_t i = 0; i < header->count; i++)
+                {
+                    GUID meshGuid = records[i].mesh;
+                    GUID materialGuid = records[i].material;
+
+                    Mesh *mesh = meshGuid != GUID_INVALID && resourceManager ? resourceManager->GetMesh(meshGuid) : nullptr;
+                    Material *material = materialGuid != GUID_INVALID ? MaterialUtil::GetMaterial(materialGuid) : nullptr;
+                    meshTable[i] = {mesh, material, meshGuid};
+                }
+                break;
+            }
+            case SNAPSHOT_POOL_MESH:
+                valid = ReadMeshPool(reader, registry, *header, meshTable);
+                meshesRestored = true;
+                break;
+            case SNAPSHOT_POOL_PARENT:
+                valid = ReadPool<ParentComponent>(reader, registry, *header);
+                break;
+            default:
+                Logger::Log("[WorldSnapshot] [ERR] Unknown pool %i.", header->id);
+                valid = false;
+                break;
+        }
+    }
+
+    Logger::Log("[WorldSnapshot] [ERR] Snapshot is corrupt.");
+    DestroyEntities(registry);
+    return false;
+}
+
+void WorldSnapshot::Clone(World &source, World &target)
+{
+    Capture(source).Restore(target);
+}
+
+bool WorldSnapshot::Save(const std::string &path, bool compress) const
+{
+    FileHeader header{SNAPSHOT_MAGIC, SNAPSHOT_VERSION, 0, 0, size, size};
+
+    const char *stored = reinterpret_cast<const char *>(data.get());
+    std::unique_ptr<char[]> compressed;
+
+    if (compress && size <= LZ4_MAX_INPUT_SIZE)
+    {
+        int bound = LZ4_compressBound(static_cast<int>(size));
+        compressed.reset(new char[bound]);
+
+        int compressedSize = LZ4_compress_default(stored, compressed.get(), static_cast<int>(size), bound);
+
+        //Not worth it if it didn't shrink, store it as is.
+        if (compressedSize > 0 && static_cast<size_t>(compressedSize) < size)
+        {
+            header.flags |= SNAPSHOT_FLAG_COMPRESSED;
+            header.storedSize = static_cast<uint64_t>(compressedSize);
+            stored = compressed.get();
+        }
+    }
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        Logger::Log("[WorldSnapshot] [ERR] Failed to open %s for writing.", path.c_str());
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(stored, 1, header.storedSize, file) == header.storedSize;
+    fclose(file);
+
+    if (!written) Logger::Log("[WorldSnapshot] [ERR] Failed to write %s.", path.c_str());
+    return written;
+}
+
+bool WorldSnapshot::Load(const std::string &path)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        Logger::Log("[WorldSnapshot] [ERR] Failed to open %s.", path.c_str());
+        return false;
+    }
+
+    FileHeader header{};
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != SNAPSHOT_MAGIC ||
+        header.version != SNAPSHOT_VERSION)
+    {
+        Logger::Log("[WorldSnapshot] [ERR] %s is not a snapshot of the current version.", path.c_str());
+        fclose(file);
+        return false;
+    }
+
+    bool compressed = (header.flags & SNAPSHOT_FLAG_COMPRESSED) != 0;
+    if (!compressed && header.storedSize != header.dataSize)
+    {
+        Logger::Log("[WorldSnapshot] [ERR] %s is corrupt.", path.c_str());
+        fclose(file);
+        return false;
+    }
+
+    if (compressed && (header.dataSize > LZ4_MAX_INPUT_SIZE || header.storedSize > LZ4_MAX_INPUT_SIZE))
+    {
+        Logger::Log("[WorldSnapshot] [ERR] %s is too large.", path.c_str());
+        fclose(file);
+        return false;
+    }
+
+    std::unique_ptr<unsigned char[]> stored(new unsigned char[header.storedSize]);
+    bool read = fread(stored.get(), 1, header.storedSize, file) == header.storedSize;
+    fclose(file);
+
+    if (!read)
+    {
+        Logger::Log("[WorldSnapshot] [ERR] Failed to read %s.", path.c_str());
+        return false;
+    }
+
+    if (compressed)
+    {
+        std::unique_ptr<unsigned char[]> decompressed(new unsigned char[header.dataSize]);
+        int decompressedSize = LZ4_decompress_safe(reinterpret_cast<const char *>(stored.get()),
+                                                   reinterpret_cast<char *>(decompressed.get()),
+                                                   static_cast<int>(header.storedSize),
+                                                   static_cast<int>(header.dataSize));
+
+        if (decompressedSize < 0 || static_cast<uint64_t>(decompressedSize) != header.dataSize)
+        {
+            Logger::Log("[WorldSnapshot] [ERR] Failed to decompress %s.", path.c_str());
+            return false;
+        }
+
+        stored = std::move(decompressed);
+    }
+
+    data = std::move(stored);
+    size = header.dataSize;
+    return true;
+}
+
+size_t WorldSnapshot::Size() const
+{
+    return size;
+}
+
+bool WorldSnapshot::Empty() const
+{
+    return size == 0;
+}
@@ -0,0 +1,75 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_WORLDSNAPSHOT_H
+#define RELIC_WORLDSNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <Libraries/entt/entt.hpp>
+
+class World;
+
+/// A copy of the entities and components of a world, used to save levels and to roll worlds back.
+///
+/// Component pools are stored as contiguous blobs in the same order entt keeps them, so capturing and restoring are a
+/// handful of memcpys per pool rather than work per entity. Entity identifiers (including versions) are stored as is,
+/// so handles held by gameplay code stay valid across a restore. MeshComponent is stored as mesh and material GUIDs
+/// and resolved through the ResourceManager and MaterialUtil when restored. Mesh components that already match the
+/// snapshot are left in place on restore, so rolling back doesn't release and prepare render data again.
+///
+/// Only the component types listed in WorldSnapshot.cpp are captured, anything else is dropped on restore. Entities
+/// marked with a SingletonEntityComponent belong to the systems that created them, they're skipped when capturing and
+/// kept, along with their components, when restoring.
+class WorldSnapshot
+{
+public:
+    WorldSnapshot() = default;
+
+    WorldSnapshot(WorldSnapshot &&) = default;
+    WorldSnapshot &operator=(WorldSnapshot &&) = default;
+
+    WorldSnapshot(const WorldSnapshot &) = delete;
+    WorldSnapshot &operator=(const WorldSnapshot &) = delete;
+
+    /// Capture the current state of a world. Must not be called while the world is ticking.
+    static WorldSnapshot Capture(World &world);
+
+    static WorldSnapshot Capture(const entt::registry &registry);
+
+    /// Replace every entity in a world, other than singleton ones, with the ones in this snapshot. Must not be called
+    /// while the world is ticking.
+    /// \return False if the snapshot is empty, corrupt or needs a slot a singleton entity has since taken. The world is
+    /// left without any entities but singleton ones if it's corrupt, and untouched otherwise.
+    bool Restore(World &world) const;
+
+    bool Restore(entt::registry &registry) const;
+
+    /// Copy every entity from one world into another, replacing whatever the target had.
+    static void Clone(World &source, World &target);
+
+    /// Write the snapshot to disk.
+    /// \param path File to write.
+    /// \param compress Whether to LZ4 compress the component data.
+    /// \return False if the file couldn't be written.
+    bool Save(const std::string &path, bool compress = true) const;
+
+    /// Read a snapshot written by Save, replacing the contents of this one.
+    /// \param path File to read.
+    /// \return False if the file couldn't be read or isn't a snapshot of the current version.
+    bool Load(const std::string &path);
+
+    /// Size of the uncompressed snapshot in bytes.
+    [[nodiscard]] size_t Size() const;
+
+    [[nodiscard]] bool Empty() const;
+
+private:
+    std::unique_ptr<unsigned char[]> data;
+    size_t size = 0;
+};
+
+#endif //RELIC_WORLDSNAPSHOT_H
@@ -0,0 +1,154 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include "World.h"
+#include "WorldSnapshot.h"
+#include <Core/Components/TransformComponent.h>
+#include <Core/Systems/TransformHierarchy.h>
+#include <Core/Systems/WorldBounds.h>
+#include <Graphics/Components/MeshComponent.h>
+#include <Graphics/Systems/NullRenderer.h>
+#include <ResourceManager/ResourceManager.h>
+#include <Debugging/Benchmark.h>
+#include <Debugging/Logger.h>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static const uint32_t SNAPSHOT_ENTITY_COUNT = 1000000;
+static const uint32_t SNAPSHOT_MESH_COUNT = 16;
+static const char *SNAPSHOT_PATH = "snapshot_benchmark.rsnap";
+
+static std::string Milliseconds(double seconds)
+{
+    return std::to_string(seconds * 1000.0) + "ms";
+}
+
+static void LogFileSize(const char *label)
+{
+    FILE *file = fopen(SNAPSHOT_PATH, "rb");
+    if (file == nullptr) return;
+
+    fseek(file, 0, SEEK_END);
+    long bytes = ftell(file);
+    fclose(file);
+
+    Logger::Log("%s file: %sMB", label, std::to_string(bytes / (1024.0 * 1024.0)).c_str());
+}
+
+/// Time saving and loading a snapshot file, and restoring it into a world.
+static void MeasureFile(World &world, const WorldSnapshot &snapshot, bool compress)
+{
+    const char *label = compress ? "LZ4" : "Raw";
+
+    auto start = Clock::now();
+    snapshot.Save(SNAPSHOT_PATH, compress);
+    Logger::Log("%s save: %s", label, Milliseconds(Benchmark::SecondsSince(start)).c_str());
+    LogFileSize(label);
+
+    WorldSnapshot loaded;
+
+    start = Clock::now();
+    loaded.Load(SNAPSHOT_PATH);
+    double loadSeconds = Benchmark::SecondsSince(start);
+
+    start = Clock::now();
+    loaded.Restore(world);
+    double restoreSeconds = Benchmark::SecondsSince(start);
+
+    Logger::Log("%s load: %s read + %s restore = %s", label, Milliseconds(loadSeconds).c_str(),
+                Milliseconds(restoreSeconds).c_str(), Milliseconds(loadSeconds + restoreSeconds).c_str());
+
+    remove(SNAPSHOT_PATH);
+}
+
+/// Counts the meshes it prepares, to see whether restoring released any render data.
+class CountingRenderer : public NullRenderer
+{
+public:
+    void PrepareMesh(SingletonRenderState &state, Mesh &mesh) override
+    {
+        NullRenderer::PrepareMesh(state, mesh);
+        prepared++;
+    }
+
+    uint32_t prepared = 0;
+};
+
+static void RunWorldSnapshotBenchmark()
+{
+    //Meshes are looked up by GUID on restore, so they have to belong to a model the resource manager knows about.
+    std::unique_ptr<ResourceManager> ownedResourceManager;
+    if (ResourceManager::GetInstance() == nullptr) ownedResourceManager.reset(new ResourceManager());
+
+    Model model;
+    model.meshCount = SNAPSHOT_MESH_COUNT;
+    model.meshes = new Mesh[SNAPSHOT_MESH_COUNT];
+    ResourceManager::GetInstance()->RegisterModel(GetGUID("SnapshotBenchmarkModel"), &model);
+
+    //Restores fire the same signals as in a running game, so attach the systems that listen to them.
+    CountingRenderer renderer;
+    TransformHierarchy transformHierarchy;
+    WorldBounds worldBounds;
+
+    World world;
+    auto registry = world.Registry();
+    for (ISystem *system : std::initializer_list<ISystem *>{&renderer, &transformHierarchy, &worldBounds})
+    {
+        world.RegisterSystem(system);
+        system->Init(world);
+    }
+
+    std::vector<entt::entity> entities(SNAPSHOT_ENTITY_COUNT);
+    registry->create(entities.begin(), entities.end());
+
+    for (uint32_t i = 0; i < SNAPSHOT_ENTITY_COUNT; i++)
+    {
+        float offset = (float) i;
+        registry->emplace<TransformComponent>(entities[i], glm::vec3(offset, 0.0f, -offset), glm::vec3(1.0f),
+                                              glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        registry->emplace<MeshComponent>(entities[i], &model.meshes[i % SNAPSHOT_MESH_COUNT], nullptr,
+                                         model.meshes[i % SNAPSHOT_MESH_COUNT].guid);
+    }
+
+    auto start = Clock::now();
+    WorldSnapshot snapshot = WorldSnapshot::Capture(world);
+    Logger::Log("Capture %i entities: %s, %sMB", SNAPSHOT_ENTITY_COUNT,
+                Milliseconds(Benchmark::SecondsSince(start)).c_str(),
+                std::to_string(snapshot.Size() / (1024.0 * 1024.0)).c_str());
+
+    World clone;
+    start = Clock::now();
+    snapshot.Restore(clone);
+    Logger::Log("Restore into another world (clone): %s", Milliseconds(Benchmark::SecondsSince(start)).c_str());
+
+    //Move everything, so the rollback has transforms to undo.
+    registry->view<TransformComponent>().each([](TransformComponent &transform)
+                                              {
+                                                  transform.position.y += 1.0f;
+                                              });
+
+    uint32_t prepared = renderer.prepared;
+    start = Clock::now();
+    snapshot.Restore(world);
+    Logger::Log("Restore over the same world (rollback): %s", Milliseconds(Benchmark::SecondsSince(start)).c_str());
+
+    //Every mesh component survives a rollback, so no render data should have been released and prepared again.
+    Logger::Log("Meshes prepared again by the rollback: %i", renderer.prepared - prepared);
+
+    MeasureFile(world, snapshot, false);
+    MeasureFile(world, snapshot, true);
+
+    //The renderer looks at the meshes when their components are destroyed, do that before they're deleted.
+    registry->clear<MeshComponent>();
+
+    //The model lives on the stack, don't leave the resource manager pointing at its meshes.
+    ResourceManager::GetInstance()->UnregisterModel(&model);
+    delete[] model.meshes;
+    model.meshes = nullptr;
+}
+
+static BenchmarkRegistrar registrar("snapshot", &RunWorldSnapshotBenchmark);
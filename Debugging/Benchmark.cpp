@@ -0,0 +1,47 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "Benchmark.h"
+#include "Logger.h"
+
+bool Benchmark::Run(const std::string &name)
+{
+    auto &registry = Registry();
+
+    if (name == "all")
+    {
+        for (auto &benchmark : registry)
+        {
+            Logger::Log("Running benchmark '%s'", benchmark.first.c_str());
+            benchmark.second();
+        }
+        return true;
+    }
+
+    auto benchmark = registry.find(name);
+    if (benchmark == registry.end())
+    {
+        Logger::Log("No benchmark named '%s', available benchmarks:", name.c_str());
+        for (auto &available : registry)
+        {
+            Logger::Log("  %s", available.first.c_str());
+        }
+        return false;
+    }
+
+    Logger::Log("Running benchmark '%s'", name.c_str());
+    benchmark->second();
+    return true;
+}
+
+void Benchmark::Register(const std::string &name, Benchmark::Function function)
+{
+    Registry()[name] = function;
+}
+
+std::map<std::string, Benchmark::Function> &Benchmark::Registry()
+{
+    static std::map<std::string, Function> registry;
+    return registry;
+}
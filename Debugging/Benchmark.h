@@ -0,0 +1,43 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_BENCHMARK_H
+#define RELIC_BENCHMARK_H
+
+#include <map>
+#include <string>
+#include <chrono>
+
+/// Registry of microbenchmarks that can be run from the command line with `--benchmark <name>`, or `--benchmark all`.
+class Benchmark
+{
+public:
+    typedef void (*Function)();
+
+    /// Run a registered benchmark.
+    /// \param name The name of the benchmark, or "all" to run every benchmark.
+    /// \return False if no benchmark with that name is registered.
+    static bool Run(const std::string &name);
+
+    static void Register(const std::string &name, Function function);
+
+    /// Seconds elapsed since the given time point, for timing benchmark sections.
+    static double SecondsSince(std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+private:
+    static std::map<std::string, Function> &Registry();
+};
+
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(const char *name, Benchmark::Function function)
+    {
+        Benchmark::Register(name, function);
+    }
+};
+
+#endif //RELIC_BENCHMARK_H
@@ -84,9 +84,20 @@ void FPSCameraSystem::FrameTick(World &world)
         {
             transform.position -= transform.rotation * glm::vec3(0,1,0) * speed * time.FrameDelta();
         }
+
+        //Let TransformHierarchy know it moved.
+        registry->patch<TransformComponent>(entity);
     }
 }
 
+FPSCameraSystem::FPSCameraSystem()
+{
+    Reads<SingletonInput>();
+    Reads<SingletonTime>();
+    Writes<FPSCameraComponent>();
+    Writes<TransformComponent>();
+}
+
 void FPSCameraSystem::Init(World &world)
 {
     NeedsFrameTick = true;
@@ -98,4 +109,4 @@ void FPSCameraSystem::Shutdown(World &world)
 
 }
 
-SystemRegistrar FPSCameraSystem::registrar(new FPSCameraSystem());
+SystemRegistrar FPSCameraSystem::registrar(&CreateSystem<FPSCameraSystem>);
@@ -13,6 +13,8 @@ class FPSCameraSystem : public ISystem
 private:
     static SystemRegistrar registrar;
 public:
+    FPSCameraSystem();
+
     void Tick(World &world) override;
 
     void FrameTick(World &world) override;
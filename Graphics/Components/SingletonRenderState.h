@@ -8,10 +8,76 @@
 #include <Graphics/Window.h>
 #include <glm/glm.hpp>
 
+/// Work done by the back end during the last frame. Reset by the Renderer at the start of every frame.
+struct RenderStats
+{
+    //Draw calls, and the meshes they drew between them.
+    uint32_t draws;
+    uint32_t instances;
+
+    uint32_t pipelineBinds;
+    uint32_t materialBinds;
+    uint32_t meshBinds;
+
+    //Binds skipped because the draw before used the same state.
+    uint32_t pipelineBindsAvoided;
+    uint32_t materialBindsAvoided;
+    uint32_t meshBindsAvoided;
+
+    RenderStats &operator+=(const RenderStats &other)
+    {
+        draws += other.draws;
+        instances += other.instances;
+        pipelineBinds += other.pipelineBinds;
+        materialBinds += other.materialBinds;
+        meshBinds += other.meshBinds;
+        pipelineBindsAvoided += other.pipelineBindsAvoided;
+        materialBindsAvoided += other.materialBindsAvoided;
+        meshBindsAvoided += other.meshBindsAvoided;
+        return *this;
+    }
+};
+
+/// GPU memory used by mesh data, for back ends that pack meshes into shared buffers.
+struct GeometryStats
+{
+    //Ranges handed out to meshes, and the buffers they're in.
+    uint32_t allocations;
+    uint32_t buffers;
+
+    uint64_t usedBytes;
+    uint64_t capacityBytes;
+
+    //Worst fragmentation of any of the buffers, see TLSFAllocator::Fragmentation.
+    float fragmentation;
+    uint32_t compactions;
+};
+
+/// Data on its way to the GPU, for back ends that stage uploads.
+struct UploadStats
+{
+    uint32_t batchesInFlight;
+    uint64_t bytesInFlight;
+
+    //Uploads over the per frame budget, waiting for a later frame.
+    uint64_t bytesWaiting;
+
+    uint64_t stagingUsedBytes;
+    uint64_t stagingCapacityBytes;
+};
+
 struct SingletonRenderState
 {
     Window* window;
     glm::mat4 vpMatrix;
+
+    RenderStats stats = {};
+    GeometryStats geometry = {};
+    UploadStats uploadStats = {};
+
+    //Cull and draw on the GPU, if the back end supports it. Instance counts aren't known on the CPU then, so stats
+    //count the indirect draws, and the instances are read back from an earlier frame.
+    bool gpuCulling = false;
 };
 
 #endif //RELIC_SINGLETONRENDERSTATE_H
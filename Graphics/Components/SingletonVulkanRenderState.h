@@ -6,11 +6,51 @@
 #define RELIC_SINGLETONVULKANRENDERSTATE_H
 
 #include <vulkan/vulkan.h>
+#include <memory>
 #include <vector>
 #include <Libraries/IMGUI/imgui.h>
 #include <Graphics/vk_mem_alloc.h>
+#include <Graphics/FrameRingBuffer.h>
+#include <Graphics/UploadManager.h>
+#include <Graphics/PipelineCache.h>
+#include <Graphics/PipelineLibrary.h>
+#include <Graphics/TextureTable.h>
+#include <Graphics/IndirectCulling.h>
+#include <Graphics/DescriptorAllocator.h>
+#include <Graphics/DescriptorCache.h>
+#include <Graphics/VulkanModelExtensions.h>
 #include "SingletonRenderState.h"
 
+/// Secondary command buffer a chunk of the draws is recorded into. Has its own pool, since command buffers from the
+/// same pool can't be recorded on different threads at the same time.
+struct alignas(64) DrawRecorder
+{
+    VkCommandPool pool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+    //State bound in the command buffer, so draws that share it don't bind it again.
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+};
+
+/// Ready flag of a mesh or material, to be set once the upload with the ticket completes.
+struct PendingUpload
+{
+    uint64_t ticket;
+    bool *ready;
+};
+
+/// GPU resources that were released while submitted frames may still use them.
+struct ReleasedResources
+{
+    std::vector<Buffer> buffers;
+    //Destroyed along with their view and sampler.
+    std::vector<Image> images;
+    //Slots of the texture table, free to reuse once nothing reads them.
+    std::vector<uint32_t> textureSlots;
+    //Meshes whose ranges of the geometry arenas can be reused.
+    std::vector<VulkanRenderData *> meshes;
+};
+
 struct SingletonVulkanRenderState : SingletonRenderState
 {
     VkInstance instance;
@@ -30,11 +70,42 @@ struct SingletonVulkanRenderState : SingletonRenderState
     VkSurfaceKHR surface{};
     VkRenderPass renderPass{};
     VkDescriptorSetLayout descriptorSetLayout{};
-    VkDescriptorSetLayout materialDescriptorSetLayout{};
-    VkDescriptorPool descriptorPool{};
-    std::vector<VkDescriptorSet> descriptorSets;
+    //Every material texture, bound once as set 1.
+    TextureTable textures;
+    //Indexed by InstanceData::material in shaders, copied into each frame's data.
+    //Entries are nullptr while free.
+    std::vector<VulkanMaterialData *> materialTable;
+    std::vector<uint32_t> freeMaterials;
+    //Indexed by ObjectData::mesh when culling on the GPU, built into each frame's data like the material table.
+    std::vector<Mesh *> meshTable;
+    std::vector<uint32_t> freeMeshes;
+    //Set 0, one per buffer of frameData. Looked up every frame, so frames in flight with the same buffer share a set.
+    DescriptorCache frameSets;
+    VkDescriptorSet frameSet = VK_NULL_HANDLE;
+    //Buffer each frame in flight last looked its set up with.
+    std::vector<VkBuffer> frameSetBuffers;
+    //Sets that only last a frame, one allocator per frame in flight. Reset once the frame's fence has signalled.
+    std::vector<DescriptorAllocator> transientDescriptors;
+    //Set 2, the objects of a frame culled on the GPU.
+    VkDescriptorSetLayout objectSetLayout{};
+    VkDescriptorSet objectSet = VK_NULL_HANDLE;
+    //Only holds ImGui's font texture, recreated with the swapchain.
+    VkDescriptorPool imGuiDescriptorPool{};
     VkPipelineLayout pipelineLayout{};
-    VkPipeline graphicsPipeline{};
+    //Behind a pointer, the state is moved around by the registry and the library's compile thread can't be.
+    std::unique_ptr<PipelineLibrary> pipelines;
+    //Used for every pipeline, kept on disk between runs.
+    PipelineCache pipelineCache;
+
+    //Culling and drawing on the GPU, only created if the device supports it.
+    IndirectCulling culling;
+    bool indirectSupported = false;
+    //Set by AllocateObjects for frames the GPU culls.
+    bool indirectFrame = false;
+    //Vertex layout of pipelines that read instances from the objects buffer instead of a vertex buffer.
+    uint32_t indirectVertexLayout = 0;
+    //Pipeline of each draw list, in the order materials first needed them.
+    std::vector<uint32_t> drawListPipelines;
 
     VkPhysicalDevice physicalDevice{};
     std::vector<VkFramebuffer> swapchainFrameBuffers;
@@ -44,8 +115,24 @@ struct SingletonVulkanRenderState : SingletonRenderState
     //TODO: Temp
     ImDrawData *imGuiDrawData;
 
-    std::vector<VkBuffer> uniformBuffers;
-    std::vector<VmaAllocation> uniformBufferAllocations;
+    //Camera and instance data written every frame, and where this frame's went.
+    FrameRingBuffer frameData;
+    VkDeviceSize cameraOffset = 0;
+    VkDeviceSize instanceOffset = 0;
+    VkDeviceSize materialOffset = 0;
+
+    //Vertex and index data of every mesh, bound once per chunk of draws.
+    GeometryArena vertexArena;
+    GeometryArena indexArena;
+
+    //Copies of mesh and texture data, submitted once per frame.
+    UploadManager uploads;
+    std::vector<PendingUpload> pendingUploads;
+
+    //Resources released since the last submission. On submission they move to the frame in flight that was
+    //submitted, and are destroyed once its fence has signalled.
+    ReleasedResources released;
+    std::vector<ReleasedResources> releasedInFlight;
 
     VkImage depthImage;
     VmaAllocation depthImageAllocation;
@@ -59,11 +146,13 @@ struct SingletonVulkanRenderState : SingletonRenderState
     int MAX_FRAMES_IN_FLIGHT = 2;
 
     std::vector<const char *> layers = {
-            "VK_LAYER_LUNARG_standard_validation"
+            "VK_LAYER_KHRONOS_validation"
     };
 
     std::vector<const char *> deviceExtensions = {
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME
+            VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+            VK_KHR_MAINTENANCE3_EXTENSION_NAME,
+            VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME
     };
 
     VkSwapchainKHR swapchain{};
@@ -79,6 +168,12 @@ struct SingletonVulkanRenderState : SingletonRenderState
 
     bool framebufferResized = false;
 
+    //Recorders for each frame in flight, one per chunk of draws and a last one for ImGui. Only reset once the fence
+    //of their frame has been waited on.
+    std::vector<std::vector<DrawRecorder>> drawRecorders;
+    uint32_t drawChunkCount = 0;
+    std::vector<VkCommandBuffer> secondaryCommandBuffers;
+
     VmaAllocator allocator;
 
     std::vector<VkImageView> swapchainImageViews;
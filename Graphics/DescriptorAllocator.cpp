@@ -0,0 +1,111 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "DescriptorAllocator.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <Debugging/Logger.h>
+
+void DescriptorAllocator::Create(VkDevice device, uint32_t initialSets, const std::vector<PoolRatio> &ratios)
+{
+    this->device = device;
+    this->ratios = ratios;
+    setsPerPool = std::max(initialSets, 1u);
+    usedPools.clear();
+    freePools.clear();
+}
+
+void DescriptorAllocator::Destroy()
+{
+    for (VkDescriptorPool pool : usedPools) vkDestroyDescriptorPool(device, pool, nullptr);
+    for (VkDescriptorPool pool : freePools) vkDestroyDescriptorPool(device, pool, nullptr);
+    usedPools.clear();
+    freePools.clear();
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(VkDescriptorSetLayout layout)
+{
+    if (usedPools.empty()) usedPools.push_back(NextPool());
+
+    VkDescriptorSetAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = usedPools.back();
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &layout;
+
+    VkDescriptorSet set;
+    VkResult result = vkAllocateDescriptorSets(device, &allocateInfo, &set);
+
+    //The current pool is full, move on to the next one and try again.
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+    {
+        usedPools.push_back(NextPool());
+        allocateInfo.descriptorPool = usedPools.back();
+        result = vkAllocateDescriptorSets(device, &allocateInfo, &set);
+    }
+
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate descriptor set.");
+    }
+
+    return set;
+}
+
+void DescriptorAllocator::Reset()
+{
+    for (VkDescriptorPool pool : usedPools)
+    {
+        vkResetDescriptorPool(device, pool, 0);
+        freePools.push_back(pool);
+    }
+
+    usedPools.clear();
+}
+
+uint32_t DescriptorAllocator::PoolCount() const
+{
+    return static_cast<uint32_t>(usedPools.size() + freePools.size());
+}
+
+VkDescriptorPool DescriptorAllocator::NextPool()
+{
+    if (!freePools.empty())
+    {
+        VkDescriptorPool pool = freePools.back();
+        freePools.pop_back();
+        return pool;
+    }
+
+    VkDescriptorPool pool = CreatePool(setsPerPool);
+    setsPerPool = std::min(setsPerPool * 2, MAX_SETS_PER_POOL);
+    return pool;
+}
+
+VkDescriptorPool DescriptorAllocator::CreatePool(uint32_t setCount)
+{
+    std::vector<VkDescriptorPoolSize> sizes;
+    sizes.reserve(ratios.size());
+    for (const PoolRatio &ratio : ratios)
+    {
+        auto count = (uint32_t) std::ceil(ratio.perSet * (float) setCount);
+        sizes.push_back({ratio.type, std::max(count, 1u)});
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = setCount;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(sizes.size());
+    poolInfo.pPoolSizes = sizes.data();
+
+    VkDescriptorPool pool;
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create descriptor pool.");
+    }
+
+    Logger::Log("[DescriptorAllocator] Created a pool for %i sets.", (int) setCount);
+    return pool;
+}
@@ -0,0 +1,63 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_DESCRIPTORALLOCATOR_H
+#define RELIC_DESCRIPTORALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+/// Descriptor sets from a chain of pools that grows as they fill up, instead of one pool sized for the worst case.
+///
+/// Pools are sized from the number of descriptors of each type an average set needs, so they only hold what their sets
+/// use. Once a pool is full the next one is created twice as large, up to MAX_SETS_PER_POOL. Sets aren't freed one by
+/// one, Reset hands all of them back at once and keeps the pools for the next round, which makes a per frame allocator
+/// cost nothing but a vkResetDescriptorPool per pool.
+class DescriptorAllocator
+{
+public:
+    static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+    /// Descriptors of one type an average set needs.
+    struct PoolRatio
+    {
+        VkDescriptorType type;
+        float perSet;
+    };
+
+    /// \param initialSets Number of sets the first pool has room for.
+    void Create(VkDevice device, uint32_t initialSets, const std::vector<PoolRatio> &ratios);
+
+    /// Destroy every pool, and with them every set.
+    void Destroy();
+
+    /// Allocate a set, creating a new pool if the current one is full.
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+
+    /// Free every set allocated since the last reset. None of them may still be in use on the GPU.
+    void Reset();
+
+    /// Number of pools created so far.
+    [[nodiscard]] uint32_t PoolCount() const;
+
+private:
+    /// Take a pool with room left, or create one.
+    VkDescriptorPool NextPool();
+
+    VkDescriptorPool CreatePool(uint32_t setCount);
+
+    VkDevice device = VK_NULL_HANDLE;
+    std::vector<PoolRatio> ratios;
+
+    //Pools sets are allocated from, the last one being the current one.
+    std::vector<VkDescriptorPool> usedPools;
+    //Pools that were reset and are empty again.
+    std::vector<VkDescriptorPool> freePools;
+
+    //Size of the next pool that gets created.
+    uint32_t setsPerPool = 0;
+};
+
+#endif //RELIC_DESCRIPTORALLOCATOR_H
@@ -0,0 +1,106 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "DescriptorCache.h"
+#include <algorithm>
+#include <Core/Util.h>
+
+void DescriptorCache::Create(VkDevice device, uint32_t initialSets,
+                             const std::vector<DescriptorAllocator::PoolRatio> &ratios)
+{
+    this->device = device;
+    allocator.Create(device, initialSets, ratios);
+    sets.clear();
+    setCount = 0;
+}
+
+void DescriptorCache::Destroy()
+{
+    //Destroying the pools frees the sets.
+    allocator.Destroy();
+    sets.clear();
+    setCount = 0;
+}
+
+VkDescriptorSet DescriptorCache::Get(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding> &bindings)
+{
+    std::vector<Entry> &bucket = sets[Hash(layout, bindings)];
+
+    for (const Entry &entry : bucket)
+    {
+        if (entry.layout == layout && entry.bindings.size() == bindings.size() &&
+            std::equal(bindings.begin(), bindings.end(), entry.bindings.begin(), &DescriptorCache::Equal))
+        {
+            return entry.set;
+        }
+    }
+
+    VkDescriptorSet set = allocator.Allocate(layout);
+
+    std::vector<VkWriteDescriptorSet> writes(bindings.size());
+    for (size_t i = 0; i < bindings.size(); i++)
+    {
+        const DescriptorBinding &binding = bindings[i];
+        bool isImage = binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+                       binding.type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
+                       binding.type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
+                       binding.type == VK_DESCRIPTOR_TYPE_SAMPLER;
+
+        writes[i] = {};
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = binding.binding;
+        writes[i].dstArrayElement = 0;
+        writes[i].descriptorType = binding.type;
+        writes[i].descriptorCount = 1;
+        writes[i].pImageInfo = isImage ? &binding.image : nullptr;
+        writes[i].pBufferInfo = isImage ? nullptr : &binding.buffer;
+    }
+
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    bucket.push_back({layout, bindings, set});
+    setCount++;
+    return set;
+}
+
+void DescriptorCache::Forget()
+{
+    sets.clear();
+    setCount = 0;
+}
+
+uint32_t DescriptorCache::Size() const
+{
+    return setCount;
+}
+
+bool DescriptorCache::Equal(const DescriptorBinding &lhs, const DescriptorBinding &rhs)
+{
+    return lhs.binding == rhs.binding && lhs.type == rhs.type &&
+           lhs.buffer.buffer == rhs.buffer.buffer && lhs.buffer.offset == rhs.buffer.offset &&
+           lhs.buffer.range == rhs.buffer.range && lhs.image.sampler == rhs.image.sampler &&
+           lhs.image.imageView == rhs.image.imageView && lhs.image.imageLayout == rhs.image.imageLayout;
+}
+
+uint64_t DescriptorCache::Hash(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding> &bindings)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash = HashBytes(&layout, sizeof(layout), hash);
+
+    //Field by field, padding would make equal bindings hash differently.
+    for (const DescriptorBinding &binding : bindings)
+    {
+        hash = HashBytes(&binding.binding, sizeof(binding.binding), hash);
+        hash = HashBytes(&binding.type, sizeof(binding.type), hash);
+        hash = HashBytes(&binding.buffer.buffer, sizeof(binding.buffer.buffer), hash);
+        hash = HashBytes(&binding.buffer.offset, sizeof(binding.buffer.offset), hash);
+        hash = HashBytes(&binding.buffer.range, sizeof(binding.buffer.range), hash);
+        hash = HashBytes(&binding.image.sampler, sizeof(binding.image.sampler), hash);
+        hash = HashBytes(&binding.image.imageView, sizeof(binding.image.imageView), hash);
+        hash = HashBytes(&binding.image.imageLayout, sizeof(binding.image.imageLayout), hash);
+    }
+
+    return hash;
+}
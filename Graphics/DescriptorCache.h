@@ -0,0 +1,69 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_DESCRIPTORCACHE_H
+#define RELIC_DESCRIPTORCACHE_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "DescriptorAllocator.h"
+
+/// A buffer or image to be bound at one binding of a set. Only the info matching the type is used.
+struct DescriptorBinding
+{
+    uint32_t binding;
+    VkDescriptorType type;
+    VkDescriptorBufferInfo buffer;
+    VkDescriptorImageInfo image;
+};
+
+/// Descriptor sets that are looked up by what they contain, so bindings that are the same share one set instead of
+/// each asking for its own. Sets are written once, when first asked for, and never change after.
+///
+/// Entries are looked up by a hash of the layout and bindings, and compared in full on a hit so a collision can't hand
+/// out a set written for something else. Sets live as long as the cache, forgetting an entry only stops it from being
+/// handed out again.
+class DescriptorCache
+{
+public:
+    /// \param initialSets Number of sets the first pool has room for, see DescriptorAllocator.
+    void Create(VkDevice device, uint32_t initialSets, const std::vector<DescriptorAllocator::PoolRatio> &ratios);
+
+    void Destroy();
+
+    /// Get the set for a layout and bindings, allocating and writing it if there isn't one yet.
+    VkDescriptorSet Get(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding> &bindings);
+
+    /// Forget every entry, for when handles they refer to have been destroyed and could be reused. Sets that were
+    /// handed out stay valid.
+    ///
+    /// The sets aren't freed, they stay allocated in the pools until Destroy. This leaks one set per entry for every
+    /// call, so it's only meant for rare events, like a frame's buffer growing (which doubles it each time).
+    void Forget();
+
+    /// Number of sets that can be handed out.
+    [[nodiscard]] uint32_t Size() const;
+
+private:
+    struct Entry
+    {
+        VkDescriptorSetLayout layout;
+        std::vector<DescriptorBinding> bindings;
+        VkDescriptorSet set;
+    };
+
+    static uint64_t Hash(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding> &bindings);
+
+    static bool Equal(const DescriptorBinding &lhs, const DescriptorBinding &rhs);
+
+    VkDevice device = VK_NULL_HANDLE;
+    DescriptorAllocator allocator;
+    //Entries with the same hash share a bucket.
+    std::unordered_map<uint64_t, std::vector<Entry>> sets;
+    uint32_t setCount = 0;
+};
+
+#endif //RELIC_DESCRIPTORCACHE_H
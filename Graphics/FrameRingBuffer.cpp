@@ -0,0 +1,104 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "FrameRingBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+void FrameRingBuffer::Create(VmaAllocator allocator, uint32_t frameCount, VkDeviceSize frameSize,
+                             VkBufferUsageFlags usage, VkDeviceSize alignment)
+{
+    this->allocator = allocator;
+    this->usage = usage;
+    this->alignment = std::max<VkDeviceSize>(alignment, 1);
+
+    frames.resize(frameCount);
+    for (Frame &frame : frames)
+    {
+        CreateFrame(frame, frameSize);
+    }
+
+    current = 0;
+    head = 0;
+}
+
+void FrameRingBuffer::Destroy()
+{
+    for (Frame &frame : frames)
+    {
+        vmaDestroyBuffer(allocator, frame.buffer, frame.allocation);
+    }
+
+    frames.clear();
+}
+
+void FrameRingBuffer::StartFrame(uint32_t frame)
+{
+    current = frame;
+    head = 0;
+}
+
+void *FrameRingBuffer::Allocate(VkDeviceSize size, VkDeviceSize &offset)
+{
+    Frame &frame = frames[current];
+    offset = (head + alignment - 1) / alignment * alignment;
+
+    if (offset + size > frame.size)
+    {
+        //Grow geometrically, the larger buffer is kept for every following use of this frame.
+        Frame grown;
+        CreateFrame(grown, std::max(frame.size * 2, offset + size));
+        memcpy(grown.data, frame.data, head);
+
+        vmaDestroyBuffer(allocator, frame.buffer, frame.allocation);
+        frame = grown;
+    }
+
+    head = offset + size;
+    return frame.data + offset;
+}
+
+void FrameRingBuffer::Flush()
+{
+    if (head > 0) vmaFlushAllocation(allocator, frames[current].allocation, 0, head);
+}
+
+VkBuffer FrameRingBuffer::Buffer() const
+{
+    return frames[current].buffer;
+}
+
+VkBuffer FrameRingBuffer::Buffer(uint32_t frame) const
+{
+    return frames[frame].buffer;
+}
+
+VkDeviceSize FrameRingBuffer::Used() const
+{
+    return head;
+}
+
+void FrameRingBuffer::CreateFrame(Frame &frame, VkDeviceSize size)
+{
+    VkBufferCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    createInfo.size = size;
+    createInfo.usage = usage;
+    createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocationCreateInfo = {};
+    allocationCreateInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+    allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo allocationInfo = {};
+    if (vmaCreateBuffer(allocator, &createInfo, &allocationCreateInfo, &frame.buffer, &frame.allocation,
+                        &allocationInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create frame ring buffer.");
+    }
+
+    frame.data = (uint8_t *) allocationInfo.pMappedData;
+    frame.size = size;
+}
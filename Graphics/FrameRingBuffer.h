@@ -0,0 +1,73 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_FRAMERINGBUFFER_H
+#define RELIC_FRAMERINGBUFFER_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+#include "vk_mem_alloc.h"
+
+/// Persistently mapped buffers for data the CPU writes every frame, one per frame in flight and used in turn.
+/// Allocating is a bump of an offset into the buffer of the current frame, nothing is mapped or unmapped after the
+/// buffers are created. An allocation stays valid until its frame's buffer comes around again.
+class FrameRingBuffer
+{
+public:
+    /// \param frameCount Number of frames in flight.
+    /// \param frameSize Initial size of each frame's buffer in bytes, they grow when a frame needs more.
+    /// \param usage Usage of the buffers, allocations are bound by offset into them.
+    /// \param alignment Every allocation starts at a multiple of this, at least minUniformBufferOffsetAlignment for
+    /// uniform buffers.
+    void Create(VmaAllocator allocator, uint32_t frameCount, VkDeviceSize frameSize, VkBufferUsageFlags usage,
+                VkDeviceSize alignment);
+
+    void Destroy();
+
+    /// Start allocating from a frame's buffer, discarding everything allocated from it before. The GPU has to be done
+    /// with the last frame that used it.
+    void StartFrame(uint32_t frame);
+
+    /// Allocate space in the current frame's buffer. Not thread safe.
+    ///
+    /// A full buffer is replaced with a larger one, keeping what was written so far. Anything referring to Buffer()
+    /// has to be updated after that, so all allocations of a frame should be made before recording uses the buffer.
+    /// \param size Size of the allocation in bytes.
+    /// \param offset Receives the offset of the allocation in Buffer().
+    /// \return Pointer to write the data to.
+    void *Allocate(VkDeviceSize size, VkDeviceSize &offset);
+
+    /// Make everything written in the current frame visible to the GPU, for memory that isn't host coherent.
+    void Flush();
+
+    /// Buffer of the current frame.
+    [[nodiscard]] VkBuffer Buffer() const;
+
+    [[nodiscard]] VkBuffer Buffer(uint32_t frame) const;
+
+    /// Bytes allocated in the current frame.
+    [[nodiscard]] VkDeviceSize Used() const;
+
+private:
+    struct Frame
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        uint8_t *data = nullptr;
+        VkDeviceSize size = 0;
+    };
+
+    void CreateFrame(Frame &frame, VkDeviceSize size);
+
+    VmaAllocator allocator = VK_NULL_HANDLE;
+    VkBufferUsageFlags usage = 0;
+    VkDeviceSize alignment = 1;
+
+    std::vector<Frame> frames;
+    uint32_t current = 0;
+    VkDeviceSize head = 0;
+};
+
+#endif //RELIC_FRAMERINGBUFFER_H
@@ -0,0 +1,223 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "FrustumCulling.h"
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RELIC_CULL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RELIC_CULL_SSE
+#endif
+
+static const size_t PLANE_COUNT = 6;
+static const size_t CULL_WIDTH = 8;
+
+Frustum ExtractFrustum(const glm::mat4 &viewProjection)
+{
+    //glm is column major, so row i of the matrix is element i of every column.
+    auto row = [&viewProjection](int i)
+    {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    glm::vec4 x = row(0);
+    glm::vec4 y = row(1);
+    glm::vec4 z = row(2);
+    glm::vec4 w = row(3);
+
+    Frustum frustum = {{w + x, w - x, w + y, w - y, w + z, w - z}};
+
+    for (glm::vec4 &plane : frustum.planes)
+    {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) plane /= length;
+    }
+
+    return frustum;
+}
+
+void CullingBatch::Resize(size_t count)
+{
+    centerX.resize(count);
+    centerY.resize(count);
+    centerZ.resize(count);
+    extentX.resize(count);
+    extentY.resize(count);
+    extentZ.resize(count);
+}
+
+void CullingBatch::Set(size_t index, const Bounds &bounds)
+{
+    centerX[index] = bounds.center.x;
+    centerY[index] = bounds.center.y;
+    centerZ[index] = bounds.center.z;
+    extentX[index] = bounds.extents.x;
+    extentY[index] = bounds.extents.y;
+    extentZ[index] = bounds.extents.z;
+}
+
+size_t CullingBatch::Size() const
+{
+    return centerX.size();
+}
+
+const char *CullingBatch::InstructionSet()
+{
+#if defined(RELIC_CULL_AVX)
+    return "AVX";
+#elif defined(RELIC_CULL_SSE)
+    return "SSE";
+#else
+    return "none";
+#endif
+}
+
+size_t CullingBatch::CullRange(const Frustum &frustum, size_t begin, size_t end, uint32_t *visible) const
+{
+    size_t count = 0;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        bool inside = true;
+
+        //A box is outside a plane when even its corner furthest along the normal is behind it.
+        for (const glm::vec4 &plane : frustum.planes)
+        {
+            float distance = plane.x * centerX[i] + plane.y * centerY[i] + plane.z * centerZ[i] + plane.w;
+            float radius = std::abs(plane.x) * extentX[i] + std::abs(plane.y) * extentY[i] +
+                           std::abs(plane.z) * extentZ[i];
+            inside &= distance + radius >= 0.0f;
+        }
+
+        visible[count] = (uint32_t) i;
+        count += inside ? 1 : 0;
+    }
+
+    return count;
+}
+
+size_t CullingBatch::CullScalar(const Frustum &frustum, std::vector<uint32_t> &visible) const
+{
+    visible.resize(Size());
+    size_t count = CullRange(frustum, 0, Size(), visible.data());
+    visible.resize(count);
+    return count;
+}
+
+size_t CullingBatch::Cull(const Frustum &frustum, std::vector<uint32_t> &visible) const
+{
+    size_t size = Size();
+    visible.resize(size);
+
+    uint32_t *out = visible.data();
+    size_t count = 0;
+    size_t i = 0;
+
+#if defined(RELIC_CULL_AVX)
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 normalX[PLANE_COUNT], normalY[PLANE_COUNT], normalZ[PLANE_COUNT], distances[PLANE_COUNT];
+    __m256 absX[PLANE_COUNT], absY[PLANE_COUNT], absZ[PLANE_COUNT];
+
+    for (size_t p = 0; p < PLANE_COUNT; p++)
+    {
+        normalX[p] = _mm256_set1_ps(frustum.planes[p].x);
+        normalY[p] = _mm256_set1_ps(frustum.planes[p].y);
+        normalZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+        distances[p] = _mm256_set1_ps(frustum.planes[p].w);
+        absX[p] = _mm256_andnot_ps(signMask, normalX[p]);
+        absY[p] = _mm256_andnot_ps(signMask, normalY[p]);
+        absZ[p] = _mm256_andnot_ps(signMask, normalZ[p]);
+    }
+
+    for (; i + CULL_WIDTH <= size; i += CULL_WIDTH)
+    {
+        __m256 cx = _mm256_loadu_ps(&centerX[i]);
+        __m256 cy = _mm256_loadu_ps(&centerY[i]);
+        __m256 cz = _mm256_loadu_ps(&centerZ[i]);
+        __m256 ex = _mm256_loadu_ps(&extentX[i]);
+        __m256 ey = _mm256_loadu_ps(&extentY[i]);
+        __m256 ez = _mm256_loadu_ps(&extentZ[i]);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t p = 0; p < PLANE_COUNT; p++)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normalX[p], cx), _mm256_mul_ps(normalY[p], cy)),
+                                            _mm256_add_ps(_mm256_mul_ps(normalZ[p], cz), distances[p]));
+            __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absX[p], ex), _mm256_mul_ps(absY[p], ey)),
+                                          _mm256_mul_ps(absZ[p], ez));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+
+        //Write every index and only advance past the visible ones, which avoids a branch per box.
+        for (size_t lane = 0; lane < CULL_WIDTH; lane++)
+        {
+            out[count] = (uint32_t) (i + lane);
+            count += (mask >> lane) & 1;
+        }
+    }
+#elif defined(RELIC_CULL_SSE)
+    __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 zero = _mm_setzero_ps();
+    __m128 normalX[PLANE_COUNT], normalY[PLANE_COUNT], normalZ[PLANE_COUNT], distances[PLANE_COUNT];
+    __m128 absX[PLANE_COUNT], absY[PLANE_COUNT], absZ[PLANE_COUNT];
+
+    for (size_t p = 0; p < PLANE_COUNT; p++)
+    {
+        normalX[p] = _mm_set1_ps(frustum.planes[p].x);
+        normalY[p] = _mm_set1_ps(frustum.planes[p].y);
+        normalZ[p] = _mm_set1_ps(frustum.planes[p].z);
+        distances[p] = _mm_set1_ps(frustum.planes[p].w);
+        absX[p] = _mm_andnot_ps(signMask, normalX[p]);
+        absY[p] = _mm_andnot_ps(signMask, normalY[p]);
+        absZ[p] = _mm_andnot_ps(signMask, normalZ[p]);
+    }
+
+    auto test = [&](size_t index)
+    {
+        __m128 cx = _mm_loadu_ps(&centerX[index]);
+        __m128 cy = _mm_loadu_ps(&centerY[index]);
+        __m128 cz = _mm_loadu_ps(&centerZ[index]);
+        __m128 ex = _mm_loadu_ps(&extentX[index]);
+        __m128 ey = _mm_loadu_ps(&extentY[index]);
+        __m128 ez = _mm_loadu_ps(&extentZ[index]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (size_t p = 0; p < PLANE_COUNT; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX[p], cx), _mm_mul_ps(normalY[p], cy)),
+                                         _mm_add_ps(_mm_mul_ps(normalZ[p], cz), distances[p]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)),
+                                       _mm_mul_ps(absZ[p], ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        return _mm_movemask_ps(inside);
+    };
+
+    //Two 4 wide halves per iteration, so SSE works on the same 8 boxes at a time as AVX.
+    for (; i + CULL_WIDTH <= size; i += CULL_WIDTH)
+    {
+        int mask = test(i) | (test(i + 4) << 4);
+
+        //Write every index and only advance past the visible ones, which avoids a branch per box.
+        for (size_t lane = 0; lane < CULL_WIDTH; lane++)
+        {
+            out[count] = (uint32_t) (i + lane);
+            count += (mask >> lane) & 1;
+        }
+    }
+#endif
+
+    //Whatever doesn't fill a full set of lanes, or everything if there's no SIMD.
+    count += CullRange(frustum, i, size, out + count);
+
+    visible.resize(count);
+    return count;
+}
@@ -0,0 +1,65 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_FRUSTUMCULLING_H
+#define RELIC_FRUSTUMCULLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include "Model.h"
+
+/// Six planes stored as (normal, distance), with normals pointing into the frustum. A point p is on the inside of a
+/// plane when dot(normal, p) + distance >= 0.
+struct Frustum
+{
+    glm::vec4 planes[6];
+};
+
+/// Extract the planes of the frustum of a view projection matrix. The near plane is taken for a -1 to 1 depth range,
+/// which is slightly conservative for projections that use 0 to 1.
+/// \param viewProjection The combined view and projection matrix.
+/// \return The frustum, with normalised planes.
+Frustum ExtractFrustum(const glm::mat4 &viewProjection);
+
+/// Axis aligned boxes stored as a structure of arrays, so they can be tested against a frustum several at a time.
+/// Uses AVX when the compiler targets it (configure with RELIC_AVX), SSE on other x86 targets, and plain C++
+/// everywhere else. Both SIMD paths test 8 boxes per iteration.
+class CullingBatch
+{
+public:
+    /// Resize the batch, keeping existing boxes.
+    void Resize(size_t count);
+
+    /// Set a box. Different indices can be set from different threads.
+    void Set(size_t index, const Bounds &bounds);
+
+    [[nodiscard]] size_t Size() const;
+
+    /// Test every box against a frustum.
+    /// \param frustum The frustum to test against.
+    /// \param visible Receives the indices of every box that is at least partially inside, in ascending order.
+    /// \return Number of visible boxes.
+    size_t Cull(const Frustum &frustum, std::vector<uint32_t> &visible) const;
+
+    /// Same as Cull, without SIMD. Used as the reference for benchmarks.
+    size_t CullScalar(const Frustum &frustum, std::vector<uint32_t> &visible) const;
+
+    /// Name of the instruction set Cull was built for, "AVX", "SSE" or "none".
+    static const char *InstructionSet();
+
+private:
+    size_t CullRange(const Frustum &frustum, size_t begin, size_t end, uint32_t *visible) const;
+
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+};
+
+#endif //RELIC_FRUSTUMCULLING_H
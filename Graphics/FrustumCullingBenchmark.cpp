@@ -0,0 +1,55 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include <string>
+#include <chrono>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include "FrustumCulling.h"
+#include <Debugging/Benchmark.h>
+#include <Debugging/Logger.h>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static const uint32_t CULLING_BOX_COUNT = 1000000;
+static const uint32_t CULLING_ITERATIONS = 20;
+static const float CULLING_WORLD_SIZE = 1000.0f;
+
+static void RunFrustumCullingBenchmark()
+{
+    //Boxes spread evenly around a camera at the origin, so only a small part of them are visible.
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-CULLING_WORLD_SIZE, CULLING_WORLD_SIZE);
+    std::uniform_real_distribution<float> extent(0.5f, 5.0f);
+
+    CullingBatch batch;
+    batch.Resize(CULLING_BOX_COUNT);
+    for (uint32_t i = 0; i < CULLING_BOX_COUNT; i++)
+    {
+        glm::vec3 center(position(random), position(random), position(random));
+        glm::vec3 extents(extent(random), extent(random), extent(random));
+        batch.Set(i, {center, extents, 0.0f});
+    }
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, CULLING_WORLD_SIZE);
+    Frustum frustum = ExtractFrustum(proj * view);
+
+    std::vector<uint32_t> visible;
+
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < CULLING_ITERATIONS; i++) batch.CullScalar(frustum, visible);
+    double scalarSeconds = Benchmark::SecondsSince(start) / CULLING_ITERATIONS;
+
+    start = Clock::now();
+    for (uint32_t i = 0; i < CULLING_ITERATIONS; i++) batch.Cull(frustum, visible);
+    double simdSeconds = Benchmark::SecondsSince(start) / CULLING_ITERATIONS;
+
+    Logger::Log("Cull %i boxes, %i visible", CULLING_BOX_COUNT, (int) visible.size());
+    Logger::Log("Scalar: %sms", std::to_string(scalarSeconds * 1000.0).c_str());
+    Logger::Log("SIMD (%s): %sms (%sx)", CullingBatch::InstructionSet(), std::to_string(simdSeconds * 1000.0).c_str(),
+                std::to_string(scalarSeconds / simdSeconds).c_str());
+}
+
+static BenchmarkRegistrar registrar("culling", &RunFrustumCullingBenchmark);
@@ -0,0 +1,317 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "IndirectCulling.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <Core/Util.h>
+
+bool IndirectCulling::Supported(VkPhysicalDevice physicalDevice)
+{
+    VkPhysicalDeviceFeatures features;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+    if (!features.multiDrawIndirect || !features.drawIndirectFirstInstance) return false;
+
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+
+    return std::any_of(extensions.begin(), extensions.end(), [](const VkExtensionProperties &extension)
+    {
+        return strcmp(extension.extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) == 0;
+    });
+}
+
+void IndirectCulling::Create(VkDevice device, VmaAllocator allocator, VkPipelineCache cache, uint32_t frameCount,
+                             const std::string &shaderPath)
+{
+    this->device = device;
+    this->allocator = allocator;
+
+    //Extension commands aren't exported by the loader, they have to be looked up.
+    drawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR) vkGetDeviceProcAddr(
+            device, "vkCmdDrawIndexedIndirectCountKHR");
+    if (drawIndexedIndirectCount == nullptr)
+    {
+        throw std::runtime_error("vkCmdDrawIndexedIndirectCountKHR is not available.");
+    }
+
+    //Objects, meshes, materials, commands and counts, in that order.
+    VkDescriptorSetLayoutBinding bindings[5] = {};
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo = {};
+    setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutInfo.bindingCount = 5;
+    setLayoutInfo.pBindings = bindings;
+
+    if (vkCreateDescriptorSetLayout(device, &setLayoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling descriptor set layout.");
+    }
+
+    VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5 * frameCount};
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = frameCount;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling descriptor pool.");
+    }
+
+    frames.resize(frameCount);
+    std::vector<VkDescriptorSetLayout> setLayouts(frameCount, setLayout);
+    std::vector<VkDescriptorSet> sets(frameCount);
+
+    VkDescriptorSetAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = pool;
+    allocateInfo.descriptorSetCount = frameCount;
+    allocateInfo.pSetLayouts = setLayouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocateInfo, sets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate culling descriptor sets.");
+    }
+
+    for (uint32_t i = 0; i < frameCount; i++) frames[i].set = sets[i];
+
+    VkPushConstantRange pushConstantRange = {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling pipeline layout.");
+    }
+
+    std::vector<char> code = ReadFile(shaderPath);
+
+    VkShaderModuleCreateInfo moduleInfo = {};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = code.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+
+    VkShaderModule module;
+    if (vkCreateShaderModule(device, &moduleInfo, nullptr, &module) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling shader module.");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = layout;
+
+    VkResult result = vkCreateComputePipelines(device, cache, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(device, module, nullptr);
+
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling pipeline.");
+    }
+}
+
+void IndirectCulling::Destroy()
+{
+    for (Frame &frame : frames)
+    {
+        if (frame.commands.buffer != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(allocator, frame.commands.buffer, frame.commands.allocation);
+        }
+        if (frame.counts.buffer != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(allocator, frame.counts.buffer, frame.counts.allocation);
+        }
+        if (frame.readback.buffer != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(allocator, frame.readback.buffer, frame.readback.allocation);
+        }
+    }
+
+    frames.clear();
+
+    //Destroying the pool frees the sets.
+    vkDestroyPipeline(device, pipeline, nullptr);
+    vkDestroyPipelineLayout(device, layout, nullptr);
+    vkDestroyDescriptorPool(device, pool, nullptr);
+    vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+}
+
+void IndirectCulling::Prepare(uint32_t frame, const Inputs &inputs, uint32_t objectCount, uint32_t drawLists)
+{
+    current = frame;
+    this->objectCount = objectCount;
+    this->drawLists = drawLists;
+
+    //Before the buffers are reserved, which may replace the one the counts were copied to.
+    Frame &target = frames[frame];
+    completedDraws = ReadBack(target);
+    if (objectCount == 0 || drawLists == 0) return;
+
+    //Every list has room for every object, so the culling pass never has to check for space.
+    VkDeviceSize commandsSize = (VkDeviceSize) drawLists * objectCount * sizeof(VkDrawIndexedIndirectCommand);
+    Reserve(target.commands, target.commandsSize, commandsSize,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    Reserve(target.counts, target.countsSize, drawLists * sizeof(uint32_t),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    Reserve(target.readback, target.readbackSize, drawLists * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VMA_MEMORY_USAGE_GPU_TO_CPU);
+
+    VkDescriptorBufferInfo bufferInfos[5] = {
+            {inputs.buffer, inputs.objectsOffset, inputs.objectsSize},
+            {inputs.buffer, inputs.meshesOffset, inputs.meshesSize},
+            {inputs.buffer, inputs.materialsOffset, inputs.materialsSize},
+            {target.commands.buffer, 0, target.commandsSize},
+            {target.counts.buffer, 0, target.countsSize}
+    };
+
+    VkWriteDescriptorSet writes[5] = {};
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = target.set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+
+    vkUpdateDescriptorSets(device, 5, writes, 0, nullptr);
+}
+
+void IndirectCulling::Record(VkCommandBuffer commandBuffer, const Frustum &frustum)
+{
+    if (objectCount == 0 || drawLists == 0) return;
+    Frame &frame = frames[current];
+
+    vkCmdFillBuffer(commandBuffer, frame.counts.buffer, 0, drawLists * sizeof(uint32_t), 0);
+
+    VkMemoryBarrier cleared = {};
+    cleared.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    cleared.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    cleared.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &cleared, 0, nullptr, 0, nullptr);
+
+    PushConstants constants = {};
+    std::copy(std::begin(frustum.planes), std::end(frustum.planes), constants.planes);
+    constants.objectCount = objectCount;
+    constants.listCapacity = objectCount;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &frame.set, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &constants);
+    vkCmdDispatch(commandBuffer, (objectCount + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+
+    VkMemoryBarrier culled = {};
+    culled.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    culled.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    culled.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         1, &culled, 0, nullptr, 0, nullptr);
+
+    //The draws only read the counts, so the copy doesn't hold them up.
+    VkBufferCopy copy = {0, 0, drawLists * sizeof(uint32_t)};
+    vkCmdCopyBuffer(commandBuffer, frame.counts.buffer, frame.readback.buffer, 1, &copy);
+    frame.readbackLists = drawLists;
+
+    VkMemoryBarrier copied = {};
+    copied.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    copied.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    copied.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                         1, &copied, 0, nullptr, 0, nullptr);
+}
+
+void IndirectCulling::Draw(VkCommandBuffer commandBuffer, uint32_t list) const
+{
+    if (objectCount == 0 || list >= drawLists) return;
+    const Frame &frame = frames[current];
+
+    VkDeviceSize offset = (VkDeviceSize) list * objectCount * sizeof(VkDrawIndexedIndirectCommand);
+    drawIndexedIndirectCount(commandBuffer, frame.commands.buffer, offset, frame.counts.buffer,
+                             list * sizeof(uint32_t), objectCount, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+uint32_t IndirectCulling::CompletedDraws() const
+{
+    return completedDraws;
+}
+
+uint32_t IndirectCulling::ReadBack(Frame &frame)
+{
+    if (frame.readbackLists == 0) return 0;
+
+    void *data;
+    if (vmaMapMemory(allocator, frame.readback.allocation, &data) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to map culling readback buffer.");
+    }
+
+    //Memory the GPU writes to isn't necessarily coherent.
+    vmaInvalidateAllocation(allocator, frame.readback.allocation, 0, VK_WHOLE_SIZE);
+
+    uint32_t draws = 0;
+    auto counts = (const uint32_t *) data;
+    for (uint32_t i = 0; i < frame.readbackLists; i++) draws += counts[i];
+
+    vmaUnmapMemory(allocator, frame.readback.allocation);
+    frame.readbackLists = 0;
+    return draws;
+}
+
+void IndirectCulling::Reserve(Buffer &buffer, VkDeviceSize &bufferSize, VkDeviceSize size, VkBufferUsageFlags usage,
+                              VmaMemoryUsage memoryUsage)
+{
+    if (size <= bufferSize) return;
+
+    //Only ever used by the frame being prepared, which the GPU is done with.
+    if (buffer.buffer != VK_NULL_HANDLE) vmaDestroyBuffer(allocator, buffer.buffer, buffer.allocation);
+
+    //Grow geometrically, object counts creep up as a scene is built.
+    bufferSize = std::max(bufferSize * 2, size);
+
+    VkBufferCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    createInfo.size = bufferSize;
+    createInfo.usage = usage;
+    createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocationCreateInfo = {};
+    allocationCreateInfo.usage = memoryUsage;
+
+    if (vmaCreateBuffer(allocator, &createInfo, &allocationCreateInfo, &buffer.buffer, &buffer.allocation,
+                        nullptr) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling buffer.");
+    }
+}
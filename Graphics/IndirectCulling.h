@@ -0,0 +1,117 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_INDIRECTCULLING_H
+#define RELIC_INDIRECTCULLING_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "vk_mem_alloc.h"
+#include "FrustumCulling.h"
+#include "VulkanModelExtensions.h"
+
+/// Frustum culling in a compute shader, writing the draws of what's visible for vkCmdDrawIndexedIndirectCount.
+///
+/// Objects are read from a buffer the CPU fills every frame (see ObjectData), along with the mesh and material tables
+/// they index. Each visible object becomes a draw of a single instance, with its index as the first instance so shaders
+/// can look it up again. Draws are sorted into lists, one per pipeline, each with a count the culling pass increments.
+///
+/// Command and count buffers are kept per frame in flight, so a frame never waits on the draws of the one before. Counts
+/// are also copied back to the CPU, and read once the GPU is done with the frame, see CompletedDraws.
+class IndirectCulling
+{
+public:
+    static constexpr uint32_t GROUP_SIZE = 64;
+
+    /// Whether a device can draw indirectly with a count. Needs VK_KHR_draw_indirect_count, multiDrawIndirect and
+    /// drawIndirectFirstInstance.
+    static bool Supported(VkPhysicalDevice physicalDevice);
+
+    /// Where the culling pass reads a frame's objects and the tables they index, all in one buffer.
+    struct Inputs
+    {
+        VkBuffer buffer;
+        VkDeviceSize objectsOffset;
+        VkDeviceSize objectsSize;
+        VkDeviceSize meshesOffset;
+        VkDeviceSize meshesSize;
+        VkDeviceSize materialsOffset;
+        VkDeviceSize materialsSize;
+    };
+
+    /// \param cache Cache the compute pipeline is created with.
+    /// \param shaderPath SPIR-V of the culling shader.
+    void Create(VkDevice device, VmaAllocator allocator, VkPipelineCache cache, uint32_t frameCount,
+                const std::string &shaderPath);
+
+    void Destroy();
+
+    /// Make room for a frame's draws and point the culling pass at its inputs. The GPU has to be done with the last
+    /// frame that used the same index, its draw counts are read back here.
+    /// \param objectCount Number of objects in the inputs. Nothing is culled or drawn when it's 0.
+    /// \param drawLists Number of lists draws are sorted into.
+    void Prepare(uint32_t frame, const Inputs &inputs, uint32_t objectCount, uint32_t drawLists);
+
+    /// Record the culling pass of the prepared frame, outside of a render pass. Indirect draws recorded after it see
+    /// its results.
+    void Record(VkCommandBuffer commandBuffer, const Frustum &frustum);
+
+    /// Record the draws of one list of the prepared frame, with whatever pipeline and buffers are bound.
+    void Draw(VkCommandBuffer commandBuffer, uint32_t list) const;
+
+    /// Draws the culling pass wrote, over all lists, the last time the prepared frame's index was used. That's a few
+    /// frames behind, the GPU has only just finished it.
+    uint32_t CompletedDraws() const;
+
+private:
+    struct Frame
+    {
+        Buffer commands = {};
+        Buffer counts = {};
+        VkDeviceSize commandsSize = 0;
+        VkDeviceSize countsSize = 0;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+
+        //Host visible copy of the counts, and how many lists were copied into it by the last Record.
+        Buffer readback = {};
+        VkDeviceSize readbackSize = 0;
+        uint32_t readbackLists = 0;
+    };
+
+    //Laid out as the push constants of the shader.
+    struct PushConstants
+    {
+        glm::vec4 planes[6];
+        uint32_t objectCount;
+        uint32_t listCapacity;
+    };
+
+    /// Make sure a buffer has at least size bytes, replacing it with a larger one if not. Contents aren't kept.
+    void Reserve(Buffer &buffer, VkDeviceSize &bufferSize, VkDeviceSize size, VkBufferUsageFlags usage,
+                 VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY);
+
+    /// Sum the counts copied back for a frame, which the GPU has to be done with.
+    uint32_t ReadBack(Frame &frame);
+
+    VkDevice device = VK_NULL_HANDLE;
+    VmaAllocator allocator = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount = nullptr;
+
+    std::vector<Frame> frames;
+
+    //The prepared frame.
+    uint32_t current = 0;
+    uint32_t objectCount = 0;
+    uint32_t drawLists = 0;
+    uint32_t completedDraws = 0;
+};
+
+#endif //RELIC_INDIRECTCULLING_H
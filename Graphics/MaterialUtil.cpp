@@ -4,19 +4,48 @@
 
 #include "MaterialUtil.h"
 
+#include <unordered_map>
 #include <Graphics/Model.h>
 #include <ResourceManager/ResourceManager.h>
 #include <Core/Relic.h>
 
+static std::unordered_map<GUID, Material *> &Materials()
+{
+    static std::unordered_map<GUID, Material *> materials;
+    return materials;
+}
+
 Material *MaterialUtil::CreateMaterial(GUID texture)
 {
+    Material *existing = GetMaterial(texture);
+    if (existing != nullptr) return existing;
+
     auto *mat = new Material();
     mat->texture = ResourceManager::GetInstance()->GetSimpleResourceData<Texture>(texture);
+    mat->guid = texture;
 
     //Register the material with our current renderer in order to init any render state.
     auto * renderer = Relic::Instance()->GetPrimaryWorld()->GetSystem<Renderer>();
     renderer->RegisterMaterial(mat);
 
+    Materials()[mat->guid] = mat;
     return mat;
 }
 
+Material *MaterialUtil::GetMaterial(GUID guid)
+{
+    auto material = Materials().find(guid);
+    return material != Materials().end() ? material->second : nullptr;
+}
+
+void MaterialUtil::DestroyMaterial(GUID guid)
+{
+    auto material = Materials().find(guid);
+    if (material == Materials().end()) return;
+
+    auto * renderer = Relic::Instance()->GetPrimaryWorld()->GetSystem<Renderer>();
+    renderer->UnregisterMaterial(material->second);
+
+    delete material->second;
+    Materials().erase(material);
+}
@@ -12,7 +12,18 @@ struct Material;
 class MaterialUtil
 {
 public:
+    /// Create a material for a texture, or return the existing one if it was already created. The material's GUID is
+    /// the texture's GUID.
     static Material* CreateMaterial(GUID texture);
+
+    /// Find a material created by CreateMaterial.
+    /// \param guid GUID of the material.
+    /// \return The material, or nullptr if it hasn't been created.
+    static Material* GetMaterial(GUID guid);
+
+    /// Unregister a material from the renderer and delete it. Meshes must no longer be drawn with it.
+    /// \param guid GUID of the material.
+    static void DestroyMaterial(GUID guid);
 };
 
 #endif //RELIC_MATERIALUTIL_H
@@ -8,6 +8,11 @@
 #include <cstdint>
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <algorithm>
+#include <cmath>
 #include <Importers/ImportUtil.h>
 #include <Core/RelicStruct.h>
 #include <memory>
@@ -20,6 +25,90 @@ typedef struct Vertex
     glm::vec2 textureCoordinate;
 } Vertex;
 
+/// Per instance data of a draw, read by shaders as a per instance vertex attribute.
+struct InstanceData
+{
+    glm::mat4 model;
+    //Index of the material in the back end's material table, so instances of one draw can differ in material.
+    uint32_t material;
+};
+
+/// Axis aligned box and bounding sphere sharing the same center.
+struct Bounds
+{
+    glm::vec3 center;
+    glm::vec3 extents;
+    float radius;
+};
+
+/// Material index of an object that has no material, the culling shader never draws it.
+constexpr uint32_t NO_MATERIAL = 0xFFFFFFFF;
+
+/// An object handed to the GPU to be culled and drawn there, laid out as in the objects buffer (std430).
+struct ObjectData
+{
+    glm::mat4 model;
+    //World space bounding box, w unused.
+    glm::vec4 center;
+    glm::vec4 extents;
+    //Indices of the mesh and material in the back end's tables.
+    uint32_t mesh;
+    uint32_t material;
+    uint32_t padding[2];
+};
+
+/// Calculate the bounds of a set of vertices. The sphere is centered on the box, and only as large as the vertices need.
+/// \param vertices The vertices.
+/// \param vertexCount Number of vertices.
+/// \return The bounds, zero sized at the origin if there are no vertices.
+inline Bounds CalculateBounds(const Vertex *vertices, size_t vertexCount)
+{
+    if (vertexCount == 0) return {glm::vec3(0.0f), glm::vec3(0.0f), 0.0f};
+
+    glm::vec3 min = vertices[0].position;
+    glm::vec3 max = vertices[0].position;
+    for (size_t i = 1; i < vertexCount; i++)
+    {
+        min = glm::min(min, vertices[i].position);
+        max = glm::max(max, vertices[i].position);
+    }
+
+    Bounds bounds{(min + max) * 0.5f, (max - min) * 0.5f, 0.0f};
+
+    float radiusSquared = 0.0f;
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        glm::vec3 offset = vertices[i].position - bounds.center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    bounds.radius = std::sqrt(radiusSquared);
+
+    return bounds;
+}
+
+/// Transform bounds into another space. The box grows to contain the rotated box, so it stays axis aligned.
+/// \param bounds The bounds to transform.
+/// \param matrix The transform, may contain scale.
+/// \return The transformed bounds.
+inline Bounds TransformBounds(const Bounds &bounds, const glm::mat4 &matrix)
+{
+    Bounds result;
+    result.center = glm::vec3(matrix * glm::vec4(bounds.center, 1.0f));
+
+    for (int row = 0; row < 3; row++)
+    {
+        result.extents[row] = std::abs(matrix[0][row]) * bounds.extents.x +
+                              std::abs(matrix[1][row]) * bounds.extents.y +
+                              std::abs(matrix[2][row]) * bounds.extents.z;
+    }
+
+    float scale = std::max(glm::length(glm::vec3(matrix[0])),
+                           std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+    result.radius = bounds.radius * scale;
+
+    return result;
+}
+
 struct Mesh : RelicStruct
 {
    uint32_t sType = REL_STRUCTURE_TYPE_MESH;
@@ -32,6 +121,15 @@ struct Mesh : RelicStruct
 
    void* renderData = nullptr;
 
+   //Mesh components using the mesh, its render data lives as long as there's at least one.
+   uint32_t renderReferences = 0;
+
+   //Index in the back end's mesh table, set when the render data is created.
+   uint32_t index = 0;
+
+   //Local space bounds of the vertices.
+   Bounds bounds = {glm::vec3(0.0f), glm::vec3(0.0f), 0.0f};
+
     GUID guid;
 
     ~Mesh()
@@ -47,6 +145,17 @@ struct Material : RelicStruct
     uint32_t sType = REL_STRUCTURE_TYPE_MATERIAL;
     Texture* texture;
     void* renderData = nullptr;
+
+    //Render state, materials that differ here are drawn with different pipelines.
+    bool doubleSided = false;
+    bool alphaBlend = false;
+
+    //Set by the renderer, so draws can be grouped by pipeline.
+    uint32_t pipeline = 0;
+    //Set by the renderer, the material's slot in its material table.
+    uint32_t index = 0;
+
+    GUID guid = GUID_INVALID;
 };
 
 struct Model : RelicStruct
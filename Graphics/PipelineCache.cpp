@@ -0,0 +1,135 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "PipelineCache.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <Debugging/Logger.h>
+
+void PipelineCache::Create(VkDevice device, VkPhysicalDevice physicalDevice, const std::string &path)
+{
+    this->device = device;
+    this->path = path;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    std::vector<char> data;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (file.is_open())
+    {
+        auto fileSize = (uint64_t) file.tellg();
+        file.seekg(0);
+
+        FileHeader header = {};
+        FileHeader expected = DeviceHeader();
+        file.read((char *) &header, sizeof(header));
+
+        //Everything but the size has to match, a cache from another device or driver is no use. The size is checked
+        //against the file before anything is allocated for it, a damaged one could claim anything.
+        bool valid = file.gcount() == sizeof(header) &&
+                     memcmp(&header, &expected, offsetof(FileHeader, dataSize)) == 0 &&
+                     header.dataSize == fileSize - sizeof(header);
+
+        if (valid)
+        {
+            data.resize(header.dataSize);
+            file.read(data.data(), (std::streamsize) data.size());
+            valid = (uint64_t) file.gcount() == header.dataSize;
+        }
+
+        if (!valid)
+        {
+            Logger::Log("[PipelineCache] Ignoring %s, it was written for another device or driver, or is damaged.",
+                        path.c_str());
+            data.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    //The driver does its own validation of the data too, start over if it still doesn't like it.
+    if (vkCreatePipelineCache(device, &createInfo, nullptr, &cache) != VK_SUCCESS)
+    {
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        data.clear();
+
+        if (vkCreatePipelineCache(device, &createInfo, nullptr, &cache) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create pipeline cache.");
+        }
+    }
+
+    loaded = !data.empty();
+    Logger::Log("[PipelineCache] %s, %i bytes.", loaded ? "Loaded from disk" : "Starting empty", (int) data.size());
+}
+
+void PipelineCache::Destroy()
+{
+    if (cache == VK_NULL_HANDLE) return;
+
+    Save();
+    vkDestroyPipelineCache(device, cache, nullptr);
+    cache = VK_NULL_HANDLE;
+}
+
+bool PipelineCache::Save()
+{
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device, cache, &size, nullptr) != VK_SUCCESS) return false;
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(device, cache, &size, data.data()) != VK_SUCCESS) return false;
+
+    FileHeader header = DeviceHeader();
+    header.dataSize = size;
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write((const char *) &header, sizeof(header));
+        file.write(data.data(), (std::streamsize) size);
+        if (!file.good()) return false;
+    }
+
+    //Renaming over an existing file fails on some platforms.
+    std::remove(path.c_str());
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) return false;
+
+    Logger::Log("[PipelineCache] Saved %i bytes.", (int) size);
+    return true;
+}
+
+VkPipelineCache PipelineCache::Handle() const
+{
+    return cache;
+}
+
+bool PipelineCache::Loaded() const
+{
+    return loaded;
+}
+
+PipelineCache::FileHeader PipelineCache::DeviceHeader() const
+{
+    //Zeroed first, so padding compares equal.
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.vendorID = properties.vendorID;
+    header.deviceID = properties.deviceID;
+    header.driverVersion = properties.driverVersion;
+    memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    return header;
+}
@@ -0,0 +1,62 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_PIPELINECACHE_H
+#define RELIC_PIPELINECACHE_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+
+/// VkPipelineCache that is kept on disk between runs, so pipelines built once don't have to be compiled again.
+///
+/// The file starts with the vendor, device, driver version and pipeline cache UUID of the device it was written on.
+/// A cache from another device or driver is ignored, since the driver would reject it or, worse, accept garbage.
+class PipelineCache
+{
+public:
+    /// Load the cache from disk, or start with an empty one if there's no usable file.
+    /// \param path File the cache is loaded from and saved to.
+    void Create(VkDevice device, VkPhysicalDevice physicalDevice, const std::string &path);
+
+    /// Save the cache and destroy it.
+    void Destroy();
+
+    /// Write the current contents of the cache to disk. Written to a temporary file first, so a crash while saving
+    /// leaves the old file intact.
+    /// \return False if the file couldn't be written.
+    bool Save();
+
+    [[nodiscard]] VkPipelineCache Handle() const;
+
+    /// Whether the cache was loaded from disk, i.e. this is a warm start.
+    [[nodiscard]] bool Loaded() const;
+
+private:
+    //"RPCC", and the version of the file layout.
+    static constexpr uint32_t FILE_MAGIC = 0x43435052;
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+    };
+
+    /// Header describing the current device.
+    [[nodiscard]] FileHeader DeviceHeader() const;
+
+    VkDevice device = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties properties = {};
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    std::string path;
+    bool loaded = false;
+};
+
+#endif //RELIC_PIPELINECACHE_H
@@ -0,0 +1,427 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "PipelineLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <Core/Util.h>
+#include <Debugging/Benchmark.h>
+#include <Debugging/Logger.h>
+
+void PipelineLibrary::Create(VkDevice device, VkPipelineCache cache)
+{
+    this->device = device;
+    this->cache = cache;
+    entries.reset(new Entry[MAX_PIPELINES]);
+    entryCount.store(0);
+    stopping = false;
+    thread = std::thread(&PipelineLibrary::CompileLoop, this);
+}
+
+void PipelineLibrary::Destroy()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    condition.notify_all();
+    if (thread.joinable()) thread.join();
+
+    for (uint32_t i = 0; i < entryCount.load(); i++)
+    {
+        VkPipeline pipeline = entries[i].pipeline.exchange(VK_NULL_HANDLE);
+        if (pipeline != VK_NULL_HANDLE) vkDestroyPipeline(device, pipeline, nullptr);
+    }
+
+    entryCount.store(0);
+    entries.reset();
+    ids.clear();
+    queue.clear();
+    vertexLayouts.clear();
+    shaders.clear();
+    hasTargets = false;
+}
+
+uint32_t PipelineLibrary::RegisterVertexLayout(const std::vector<VkVertexInputBindingDescription> &bindings,
+                                               const std::vector<VkVertexInputAttributeDescription> &attributes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    vertexLayouts.push_back({bindings, attributes});
+    return static_cast<uint32_t>(vertexLayouts.size() - 1);
+}
+
+void PipelineLibrary::ReleaseTargets()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    //Stop handing out work, and let whatever is being compiled finish, it uses the targets that are about to go.
+    hasTargets = false;
+    queue.clear();
+    condition.wait(lock, [this]()
+    {
+        return !compiling;
+    });
+
+    for (uint32_t i = 0; i < entryCount.load(); i++)
+    {
+        VkPipeline pipeline = entries[i].pipeline.exchange(VK_NULL_HANDLE);
+        if (pipeline != VK_NULL_HANDLE) vkDestroyPipeline(device, pipeline, nullptr);
+    }
+}
+
+void PipelineLibrary::SetTargets(VkPipelineLayout layout, VkRenderPass renderPass)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    this->layout = layout;
+    this->renderPass = renderPass;
+
+    uint32_t count = entryCount.load();
+    if (count > 0 && entries[FALLBACK_PIPELINE].pipeline.load() == VK_NULL_HANDLE)
+    {
+        entries[FALLBACK_PIPELINE].pipeline.store(Compile(entries[FALLBACK_PIPELINE], layout, renderPass));
+    }
+
+    for (uint32_t i = FALLBACK_PIPELINE + 1; i < count; i++)
+    {
+        if (entries[i].pipeline.load() == VK_NULL_HANDLE) queue.push_back(&entries[i]);
+    }
+
+    hasTargets = true;
+    lock.unlock();
+    condition.notify_all();
+}
+
+uint32_t PipelineLibrary::Request(const PipelineDescription &description)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    Entry entry;
+    entry.description = description;
+    entry.vertexShader = &LoadShader(description.vertexShader);
+    entry.fragmentShader = &LoadShader(description.fragmentShader);
+    uint64_t hash = Hash(entry);
+
+    //The hash only narrows it down, a collision mustn't hand out a pipeline built from something else.
+    std::vector<uint32_t> &candidates = ids[hash];
+    for (uint32_t candidate : candidates)
+    {
+        if (Matches(entries[candidate], entry)) return candidate;
+    }
+
+    uint32_t id = entryCount.load();
+    if (id == MAX_PIPELINES)
+    {
+        throw std::runtime_error("Pipeline library is full.");
+    }
+
+    Entry &added = entries[id];
+    added.description = description;
+    added.vertexShader = entry.vertexShader;
+    added.fragmentShader = entry.fragmentShader;
+    added.hash = hash;
+    candidates.push_back(id);
+
+    //Only counted once it's filled in, Get and Ready don't take the mutex.
+    entryCount.store(id + 1, std::memory_order_release);
+
+    if (!hasTargets) return id;
+
+    //Nothing is drawn without the fallback, so it can't wait.
+    if (id == FALLBACK_PIPELINE)
+    {
+        added.pipeline.store(Compile(added, layout, renderPass));
+        return id;
+    }
+
+    queue.push_back(&added);
+    lock.unlock();
+    condition.notify_all();
+    return id;
+}
+
+VkPipeline PipelineLibrary::Get(uint32_t id) const
+{
+    uint32_t count = entryCount.load(std::memory_order_acquire);
+    VkPipeline pipeline = id < count ? entries[id].pipeline.load(std::memory_order_acquire) : VK_NULL_HANDLE;
+    if (pipeline != VK_NULL_HANDLE || count == 0) return pipeline;
+
+    return entries[FALLBACK_PIPELINE].pipeline.load(std::memory_order_acquire);
+}
+
+bool PipelineLibrary::Ready(uint32_t id) const
+{
+    return id < entryCount.load(std::memory_order_acquire) &&
+           entries[id].pipeline.load(std::memory_order_acquire) != VK_NULL_HANDLE;
+}
+
+uint32_t PipelineLibrary::Pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<uint32_t>(queue.size()) + (compiling ? 1 : 0);
+}
+
+uint64_t PipelineLibrary::Hash(const Entry &entry) const
+{
+    const PipelineDescription &description = entry.description;
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    //Shaders by their code rather than their path, so paths holding the same shader share a pipeline.
+    hash = HashBytes(&entry.vertexShader->hash, sizeof(entry.vertexShader->hash), hash);
+    hash = HashBytes(&entry.fragmentShader->hash, sizeof(entry.fragmentShader->hash), hash);
+
+    if (description.vertexLayout < vertexLayouts.size())
+    {
+        const VertexLayout &vertexLayout = vertexLayouts[description.vertexLayout];
+        for (const VkVertexInputBindingDescription &binding : vertexLayout.bindings)
+        {
+            hash = HashBytes(&binding.binding, sizeof(binding.binding), hash);
+            hash = HashBytes(&binding.stride, sizeof(binding.stride), hash);
+            hash = HashBytes(&binding.inputRate, sizeof(binding.inputRate), hash);
+        }
+
+        for (const VkVertexInputAttributeDescription &attribute : vertexLayout.attributes)
+        {
+            hash = HashBytes(&attribute.location, sizeof(attribute.location), hash);
+            hash = HashBytes(&attribute.binding, sizeof(attribute.binding), hash);
+            hash = HashBytes(&attribute.format, sizeof(attribute.format), hash);
+            hash = HashBytes(&attribute.offset, sizeof(attribute.offset), hash);
+        }
+    }
+
+    hash = HashBytes(&description.cullMode, sizeof(description.cullMode), hash);
+    hash = HashBytes(&description.polygonMode, sizeof(description.polygonMode), hash);
+    hash = HashBytes(&description.alphaBlend, sizeof(description.alphaBlend), hash);
+    hash = HashBytes(&description.depthTest, sizeof(description.depthTest), hash);
+    hash = HashBytes(&description.depthWrite, sizeof(description.depthWrite), hash);
+    return hash;
+}
+
+bool PipelineLibrary::Matches(const Entry &lhs, const Entry &rhs) const
+{
+    const PipelineDescription &a = lhs.description;
+    const PipelineDescription &b = rhs.description;
+
+    //Shaders from different paths match if their code does, like in the hash.
+    bool sameShaders = (lhs.vertexShader == rhs.vertexShader || lhs.vertexShader->code == rhs.vertexShader->code) &&
+                       (lhs.fragmentShader == rhs.fragmentShader ||
+                        lhs.fragmentShader->code == rhs.fragmentShader->code);
+    if (!sameShaders) return false;
+
+    if (a.vertexLayout != b.vertexLayout)
+    {
+        if (a.vertexLayout >= vertexLayouts.size() || b.vertexLayout >= vertexLayouts.size()) return false;
+
+        const VertexLayout &layoutA = vertexLayouts[a.vertexLayout];
+        const VertexLayout &layoutB = vertexLayouts[b.vertexLayout];
+        bool sameBindings = std::equal(layoutA.bindings.begin(), layoutA.bindings.end(), layoutB.bindings.begin(),
+                                       layoutB.bindings.end(), [](const VkVertexInputBindingDescription &x,
+                                                                  const VkVertexInputBindingDescription &y)
+                                       {
+                                           return x.binding == y.binding && x.stride == y.stride &&
+                                                  x.inputRate == y.inputRate;
+                                       });
+        bool sameAttributes = std::equal(layoutA.attributes.begin(), layoutA.attributes.end(),
+                                         layoutB.attributes.begin(), layoutB.attributes.end(),
+                                         [](const VkVertexInputAttributeDescription &x,
+                                            const VkVertexInputAttributeDescription &y)
+                                         {
+                                             return x.location == y.location && x.binding == y.binding &&
+                                                    x.format == y.format && x.offset == y.offset;
+                                         });
+        if (!sameBindings || !sameAttributes) return false;
+    }
+
+    return a.cullMode == b.cullMode && a.polygonMode == b.polygonMode && a.alphaBlend == b.alphaBlend &&
+           a.depthTest == b.depthTest && a.depthWrite == b.depthWrite;
+}
+
+const PipelineLibrary::Shader &PipelineLibrary::LoadShader(const std::string &path)
+{
+    auto existing = shaders.find(path);
+    if (existing != shaders.end()) return existing->second;
+
+    //Read before adding it, so a missing file doesn't leave an empty shader behind.
+    std::vector<char> code = ReadFile(path);
+    Shader &shader = shaders[path];
+    shader.code = std::move(code);
+    shader.hash = HashBytes(shader.code.data(), shader.code.size());
+    return shader;
+}
+
+VkPipeline PipelineLibrary::Compile(const Entry &entry, VkPipelineLayout layout, VkRenderPass renderPass) const
+{
+    const PipelineDescription &description = entry.description;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    VkShaderModule vertModule = CreateShaderModule(entry.vertexShader->code);
+    VkShaderModule fragModule = CreateShaderModule(entry.fragmentShader->code);
+
+    VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertModule;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragModule;
+    shaderStages[1].pName = "main";
+
+    const VertexLayout &vertexLayout = vertexLayouts.at(description.vertexLayout);
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexLayout.bindings.size());
+    vertexInputInfo.pVertexBindingDescriptions = vertexLayout.bindings.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexLayout.attributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = vertexLayout.attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    //Set when recording, so pipelines survive the window being resized.
+    VkPipelineViewportStateCreateInfo viewportState = {};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = description.polygonMode;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = description.cullMode;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasClamp = VK_FALSE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling = {};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = description.alphaBlend ? VK_TRUE : VK_FALSE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending = {};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = description.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = description.depthWrite ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+    depthStencil.minDepthBounds = 0.0f;
+    depthStencil.maxDepthBounds = 1.0f;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = layout;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult result = vkCreateGraphicsPipelines(device, cache, 1, &pipelineInfo, nullptr, &pipeline);
+
+    vkDestroyShaderModule(device, fragModule, nullptr);
+    vkDestroyShaderModule(device, vertModule, nullptr);
+
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create graphics pipeline.");
+    }
+
+    Logger::Log("[PipelineLibrary] Compiled %s + %s in %sms.", description.vertexShader.c_str(),
+                description.fragmentShader.c_str(), std::to_string(Benchmark::SecondsSince(start) * 1000.0).c_str());
+    return pipeline;
+}
+
+VkShaderModule PipelineLibrary::CreateShaderModule(const std::vector<char> &code) const
+{
+    VkShaderModuleCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size();
+    createInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+
+    VkShaderModule module;
+    if (vkCreateShaderModule(device, &createInfo, nullptr, &module) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create shader module.");
+    }
+
+    return module;
+}
+
+void PipelineLibrary::CompileLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        condition.wait(lock, [this]()
+        {
+            return stopping || (hasTargets && !queue.empty());
+        });
+
+        if (stopping) return;
+
+        Entry *entry = queue.front();
+        queue.pop_front();
+        compiling = true;
+
+        //The targets can't change while compiling is set, ReleaseTargets waits for it.
+        VkPipelineLayout targetLayout = layout;
+        VkRenderPass targetRenderPass = renderPass;
+        lock.unlock();
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        try
+        {
+            pipeline = Compile(*entry, targetLayout, targetRenderPass);
+        }
+        catch (const std::exception &exception)
+        {
+            //Draws keep using the fallback.
+            Logger::Log("[PipelineLibrary] %s (%s + %s)", exception.what(), entry->description.vertexShader.c_str(),
+                        entry->description.fragmentShader.c_str());
+        }
+
+        lock.lock();
+        entry->pipeline.store(pipeline, std::memory_order_release);
+        compiling = false;
+        condition.notify_all();
+    }
+}
@@ -0,0 +1,158 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_PIPELINELIBRARY_H
+#define RELIC_PIPELINELIBRARY_H
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//Directory compiled shaders are loaded from, set by the build when it compiles them.
+#ifndef RELIC_SHADER_DIR
+#define RELIC_SHADER_DIR "Shaders/"
+#endif
+
+/// Everything a pipeline is built from, apart from the layout and render pass every pipeline of a library shares.
+struct PipelineDescription
+{
+    std::string vertexShader = RELIC_SHADER_DIR "vert.spv";
+    std::string fragmentShader = RELIC_SHADER_DIR "frag.spv";
+
+    //Index of a layout registered with PipelineLibrary::RegisterVertexLayout.
+    uint32_t vertexLayout = 0;
+
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    bool alphaBlend = false;
+    bool depthTest = true;
+    bool depthWrite = true;
+};
+
+/// Graphics pipelines, created on demand and looked up by a hash of their description.
+///
+/// Requesting a pipeline returns an id straight away, descriptions that are the same share one. Pipelines are
+/// compiled on a thread of the library's own, and until a pipeline is ready Get returns the fallback, the first
+/// pipeline requested, which is always compiled on the spot. So a new material is drawn with the fallback for a few
+/// frames instead of stalling one.
+///
+/// Every pipeline is built for the same layout and render pass, with a dynamic viewport and scissor. When those change
+/// every pipeline is compiled again, since the handles are part of what a pipeline is built from.
+class PipelineLibrary
+{
+public:
+    static constexpr uint32_t FALLBACK_PIPELINE = 0;
+
+    //Descriptions are shared, so this is the number of different ones rather than of materials.
+    static constexpr uint32_t MAX_PIPELINES = 1024;
+
+    /// \param cache Cache every pipeline is created with. Must be safe to use from several threads at once.
+    void Create(VkDevice device, VkPipelineCache cache);
+
+    /// Stop the compile thread and destroy every pipeline.
+    void Destroy();
+
+    /// \return Index of the layout, for PipelineDescription::vertexLayout.
+    uint32_t RegisterVertexLayout(const std::vector<VkVertexInputBindingDescription> &bindings,
+                                  const std::vector<VkVertexInputAttributeDescription> &attributes);
+
+    /// Destroy every pipeline, before the layout or render pass they were built for are destroyed. Descriptions are
+    /// kept, and compiled again once SetTargets is called. Pipelines must no longer be in use on the GPU.
+    void ReleaseTargets();
+
+    /// Set the layout and render pass pipelines are built for. Compiles the fallback on the calling thread, and
+    /// queues every other pipeline.
+    void SetTargets(VkPipelineLayout layout, VkRenderPass renderPass);
+
+    /// Get the id of a pipeline, queueing it to be compiled if it's new. Shaders are read the first time their path is
+    /// seen, and kept until the library is destroyed. The first pipeline requested becomes the fallback.
+    /// \throws std::runtime_error If there are already MAX_PIPELINES different pipelines.
+    uint32_t Request(const PipelineDescription &description);
+
+    /// The pipeline for an id, or the fallback while it's still being compiled. Can be called from any thread, also
+    /// while another is requesting pipelines.
+    [[nodiscard]] VkPipeline Get(uint32_t id) const;
+
+    /// Whether the pipeline for an id has been compiled, for callers that can't draw with the fallback instead. Can be
+    /// called from any thread, like Get.
+    [[nodiscard]] bool Ready(uint32_t id) const;
+
+    /// Number of pipelines waiting to be compiled, or being compiled.
+    [[nodiscard]] uint32_t Pending() const;
+
+private:
+    struct VertexLayout
+    {
+        std::vector<VkVertexInputBindingDescription> bindings;
+        std::vector<VkVertexInputAttributeDescription> attributes;
+    };
+
+    struct Shader
+    {
+        std::vector<char> code;
+        uint64_t hash = 0;
+    };
+
+    struct Entry
+    {
+        PipelineDescription description;
+        //Owned by the shaders map, which never moves its values.
+        const Shader *vertexShader = nullptr;
+        const Shader *fragmentShader = nullptr;
+        uint64_t hash = 0;
+        std::atomic<VkPipeline> pipeline{VK_NULL_HANDLE};
+    };
+
+    uint64_t Hash(const Entry &entry) const;
+
+    /// Whether two entries would build the same pipeline. The mutex must be held.
+    bool Matches(const Entry &lhs, const Entry &rhs) const;
+
+    /// The shader at a path, read from disk if it hasn't been yet. The mutex must be held.
+    const Shader &LoadShader(const std::string &path);
+
+    /// Build the pipeline of an entry. Thread safe, as long as the targets and vertex layouts don't change.
+    VkPipeline Compile(const Entry &entry, VkPipelineLayout layout, VkRenderPass renderPass) const;
+
+    VkShaderModule CreateShaderModule(const std::vector<char> &code) const;
+
+    void CompileLoop();
+
+    VkDevice device = VK_NULL_HANDLE;
+    VkPipelineCache cache = VK_NULL_HANDLE;
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    bool hasTargets = false;
+
+    std::vector<VertexLayout> vertexLayouts;
+
+    //Shaders by path, so requesting a known description doesn't read them again.
+    std::unordered_map<std::string, Shader> shaders;
+
+    //Allocated up front, so entries stay put while the compile thread works on them, and Get can read them without
+    //the mutex while Request adds more. Only the first entryCount are in use.
+    std::unique_ptr<Entry[]> entries;
+    std::atomic<uint32_t> entryCount{0};
+    //Ids of the entries with each hash.
+    std::unordered_map<uint64_t, std::vector<uint32_t>> ids;
+
+    //Guards everything the compile thread looks at, apart from the pipelines of entries.
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Entry *> queue;
+    bool compiling = false;
+    bool stopping = false;
+    std::thread thread;
+};
+
+#endif //RELIC_PIPELINELIBRARY_H
@@ -0,0 +1,102 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "RenderQueue.h"
+#include <algorithm>
+
+static const uint32_t PIPELINE_BITS = 8;
+static const uint32_t MATERIAL_BITS = 16;
+static const uint32_t MESH_BITS = 24;
+static const uint32_t DEPTH_BITS = 16;
+
+static const uint32_t RADIX_BITS = 8;
+static const uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+static const uint32_t RADIX_PASSES = 64 / RADIX_BITS;
+
+uint64_t RenderQueue::MakeKey(uint32_t pipeline, const Material *material, const Mesh *mesh, float depth)
+{
+    //Depth is expected in [0, 1], anything outside is clamped.
+    float clamped = std::min(std::max(depth, 0.0f), 1.0f);
+    auto quantisedDepth = (uint64_t) (clamped * (float) ((1u << DEPTH_BITS) - 1));
+
+    uint64_t key = (uint64_t) (pipeline & ((1u << PIPELINE_BITS) - 1));
+    key = (key << MATERIAL_BITS) | (uint64_t) (material->index & ((1u << MATERIAL_BITS) - 1));
+    key = (key << MESH_BITS) | (uint64_t) (mesh->index & ((1u << MESH_BITS) - 1));
+    key = (key << DEPTH_BITS) | quantisedDepth;
+    return key;
+}
+
+void RenderQueue::Clear()
+{
+    packets.clear();
+    entries.clear();
+}
+
+void RenderQueue::Resize(size_t count)
+{
+    packets.resize(count);
+    entries.resize(count);
+}
+
+void RenderQueue::Set(size_t index, uint64_t key, const DrawPacket &packet)
+{
+    packets[index] = packet;
+    entries[index] = {key, (uint32_t) index};
+}
+
+void RenderQueue::Sort()
+{
+    size_t count = entries.size();
+    if (count < 2) return;
+
+    //Every histogram in a single read of the keys.
+    uint32_t histograms[RADIX_PASSES][RADIX_SIZE] = {};
+    for (const SortEntry &entry : entries)
+    {
+        for (uint32_t pass = 0; pass < RADIX_PASSES; pass++)
+        {
+            histograms[pass][(entry.key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+        }
+    }
+
+    scratch.resize(count);
+    SortEntry *source = entries.data();
+    SortEntry *target = scratch.data();
+
+    for (uint32_t pass = 0; pass < RADIX_PASSES; pass++)
+    {
+        uint32_t shift = pass * RADIX_BITS;
+        uint32_t *histogram = histograms[pass];
+
+        //Every key has the same byte here, this pass wouldn't move anything.
+        if (histogram[(source[0].key >> shift) & (RADIX_SIZE - 1)] == count) continue;
+
+        uint32_t offset = 0;
+        for (uint32_t digit = 0; digit < RADIX_SIZE; digit++)
+        {
+            uint32_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            target[histogram[(source[i].key >> shift) & (RADIX_SIZE - 1)]++] = source[i];
+        }
+
+        std::swap(source, target);
+    }
+
+    if (source != entries.data()) entries.swap(scratch);
+}
+
+size_t RenderQueue::Size() const
+{
+    return entries.size();
+}
+
+const DrawPacket &RenderQueue::operator[](size_t index) const
+{
+    return packets[entries[index].packet];
+}
@@ -0,0 +1,63 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_RENDERQUEUE_H
+#define RELIC_RENDERQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include "Model.h"
+
+/// A single draw, referencing data that has to stay put until the queue has been submitted.
+struct DrawPacket
+{
+    Mesh *mesh;
+    Material *material;
+    const glm::mat4 *model;
+};
+
+/// Draws collected for a frame, sorted by a 64 bit key so that draws sharing state end up next to each other and back
+/// ends can skip binding anything that's already bound.
+///
+/// From the most significant bit down, keys hold the pipeline (8 bits), material (16 bits), mesh (24 bits) and view
+/// depth (16 bits), so draws are grouped by pipeline first and drawn front to back within a mesh. Materials and meshes
+/// are identified by the index the back end gave them, which is dense, so distinct ones never share a key as long as
+/// there are fewer than 2^16 materials and 2^24 meshes.
+class RenderQueue
+{
+public:
+    static uint64_t MakeKey(uint32_t pipeline, const Material *material, const Mesh *mesh, float depth);
+
+    void Clear();
+
+    /// Resize the queue, keeping existing packets.
+    void Resize(size_t count);
+
+    /// Set a packet. Different indices can be set from different threads.
+    void Set(size_t index, uint64_t key, const DrawPacket &packet);
+
+    /// Sort the packets by key, with an LSD radix sort. Bytes that are the same for every key are skipped, which is
+    /// most of them when there's only a handful of pipelines and materials.
+    void Sort();
+
+    [[nodiscard]] size_t Size() const;
+
+    /// Packet in sorted order, only valid after Sort.
+    [[nodiscard]] const DrawPacket &operator[](size_t index) const;
+
+private:
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t packet;
+    };
+
+    std::vector<DrawPacket> packets;
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> scratch;
+};
+
+#endif //RELIC_RENDERQUEUE_H
@@ -0,0 +1,116 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "NullRenderer.h"
+#include <Core/World.h>
+#include <Core/Components/SingletonEntityComponent.h>
+
+NullRenderer::NullRenderer()
+{
+    //Nothing here touches a graphics API, but the renderer still reads the whole scene so keep it off the workers.
+    RequiresMainThread = true;
+}
+
+void NullRenderer::Init(World &world)
+{
+    Renderer::Init(world);
+
+    auto registry = world.Registry();
+    auto entity = registry->create();
+    registry->emplace<SingletonEntityComponent>(entity);
+    auto &state = registry->emplace<SingletonRenderState>(entity);
+    state.window = nullptr;
+
+    registry->set<SingletonRenderState *>(&state);
+}
+
+void NullRenderer::Shutdown(World &world)
+{
+    world.Registry()->unset<SingletonRenderState *>();
+}
+
+void NullRenderer::Tick(World &world)
+{
+}
+
+void NullRenderer::StartFrame(SingletonRenderState &state, uint32_t chunkCount)
+{
+    chunkBinds.resize(chunkCount);
+}
+
+InstanceData *NullRenderer::AllocateInstances(SingletonRenderState &state, uint32_t count)
+{
+    instances.resize(count);
+    return instances.data();
+}
+
+void NullRenderer::StartChunk(SingletonRenderState &state, uint32_t chunk)
+{
+    //Every chunk starts from nothing bound, like a secondary command buffer.
+    chunkBinds[chunk] = {nullptr, nullptr};
+    chunkStats[chunk].stats.pipelineBinds++;
+}
+
+void NullRenderer::RenderMesh(SingletonRenderState &state, uint32_t chunk, Mesh &mesh, Material &material,
+                              uint32_t firstInstance, uint32_t instanceCount)
+{
+    ChunkBinds &binds = chunkBinds[chunk];
+    RenderStats &stats = chunkStats[chunk].stats;
+
+    //Count binds the same way a real back end would skip them, so batching can be measured headless.
+    if (binds.mesh != &mesh) stats.meshBinds++;
+    else stats.meshBindsAvoided++;
+
+    if (binds.material != &material) stats.materialBinds++;
+    else stats.materialBindsAvoided++;
+
+    binds.mesh = &mesh;
+    binds.material = &material;
+
+    stats.draws++;
+    stats.instances += instanceCount;
+}
+
+void NullRenderer::EndChunk(SingletonRenderState &state, uint32_t chunk)
+{
+}
+
+void NullRenderer::EndFrame(SingletonRenderState &state)
+{
+    lastFrameDrawCount = state.stats.instances;
+}
+
+void NullRenderer::PrepareMesh(SingletonRenderState &state, Mesh &mesh)
+{
+    if (freeMeshes.empty()) freeMeshes.push_back(meshSlots++);
+
+    mesh.index = freeMeshes.back();
+    freeMeshes.pop_back();
+}
+
+void NullRenderer::CleanupMesh(SingletonRenderState &state, Mesh &mesh)
+{
+    freeMeshes.push_back(mesh.index);
+}
+
+void NullRenderer::RegisterMaterial(Material *material)
+{
+    Renderer::RegisterMaterial(material);
+
+    if (freeMaterials.empty()) freeMaterials.push_back(materialSlots++);
+
+    material->index = freeMaterials.back();
+    freeMaterials.pop_back();
+}
+
+void NullRenderer::UnregisterMaterial(Material *material)
+{
+    Renderer::UnregisterMaterial(material);
+    freeMaterials.push_back(material->index);
+}
+
+uint32_t NullRenderer::LastFrameDrawCount() const
+{
+    return lastFrameDrawCount;
+}
@@ -0,0 +1,68 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_NULLRENDERER_H
+#define RELIC_NULLRENDERER_H
+
+#include "Renderer.h"
+
+/// Render back end that doesn't draw anything. Used when running headless, it still walks the scene every frame so
+/// the CPU side of rendering shows up in benchmarks.
+class NullRenderer : public Renderer
+{
+public:
+    NullRenderer();
+
+    void Init(World &world) override;
+
+    void Shutdown(World &world) override;
+
+    void Tick(World &world) override;
+
+    void StartFrame(SingletonRenderState &state, uint32_t chunkCount) override;
+
+    InstanceData *AllocateInstances(SingletonRenderState &state, uint32_t count) override;
+
+    void StartChunk(SingletonRenderState &state, uint32_t chunk) override;
+
+    void RenderMesh(SingletonRenderState &state, uint32_t chunk, Mesh &mesh, Material &material,
+                    uint32_t firstInstance, uint32_t instanceCount) override;
+
+    void EndChunk(SingletonRenderState &state, uint32_t chunk) override;
+
+    void EndFrame(SingletonRenderState &state) override;
+
+    void PrepareMesh(SingletonRenderState &state, Mesh &mesh) override;
+
+    void CleanupMesh(SingletonRenderState &state, Mesh &mesh) override;
+
+    void RegisterMaterial(Material *material) override;
+
+    void UnregisterMaterial(Material *material) override;
+
+    /// Number of meshes submitted during the last frame.
+    [[nodiscard]] uint32_t LastFrameDrawCount() const;
+
+private:
+    uint32_t lastFrameDrawCount = 0;
+
+    /// What a real back end would have bound while recording a chunk.
+    struct alignas(64) ChunkBinds
+    {
+        const Mesh *mesh;
+        const Material *material;
+    };
+
+    std::vector<ChunkBinds> chunkBinds;
+
+    std::vector<InstanceData> instances;
+
+    //Indices handed out like a real back end's table slots, the render queue sorts by them.
+    uint32_t meshSlots = 0;
+    std::vector<uint32_t> freeMeshes;
+    uint32_t materialSlots = 0;
+    std::vector<uint32_t> freeMaterials;
+};
+
+#endif //RELIC_NULLRENDERER_H
@@ -2,55 +2,196 @@
 // Created by Mika Goetze on 2019-08-02.
 //
 
-#include <Core/Components/TransformComponent.h>
+#include <Core/Components/WorldTransformComponent.h>
+#include <Core/Components/WorldBoundsComponent.h>
 #include "Renderer.h"
 #include "Graphics/Components/MeshComponent.h"
 #include "Graphics/Components/CameraComponent.h"
 #include <Core/World.h>
 #include <Core/Relic.h>
+#include <Concurrency/Jobs/ParallelFor.h>
+#include <Concurrency/Jobs/JobSystem.h>
+#include <algorithm>
 
 Renderer::~Renderer()
 = default;
 
 Renderer::Renderer()
 {
-
+    //Render back ends talk to the window and graphics API, which have to stay on the main thread.
+    RequiresMainThread = true;
+
+    Reads<MeshComponent>();
+    Reads<CameraComponent>();
+    Reads<WorldTransformComponent>();
+    Reads<WorldBoundsComponent>();
+    Writes<SingletonRenderState>();
 }
 
 void Renderer::FrameTick(World &world)
 {
     SingletonRenderState& state = *world.Registry()->ctx<SingletonRenderState*>();
-    StartFrame(state);
 
-    auto objects = world.Registry()->group<MeshComponent>(entt::get<TransformComponent>);
-    auto cameras = world.Registry()->group<CameraComponent>(entt::get<TransformComponent>);
+    auto objects = world.Registry()->group<MeshComponent>(entt::get<WorldTransformComponent, WorldBoundsComponent>);
+    auto cameras = world.Registry()->group<CameraComponent>(entt::get<WorldTransformComponent>);
 
     //For now we only render one camera, since the renderer doesn't support writing to textures yet.
+    bool hasCamera = false;
+    float farPlane = 1.0f;
 
     for(auto cameraEntity : cameras)
     {
         CameraComponent& cameraComponent = cameras.get<CameraComponent>(cameraEntity);
         if(!cameraComponent.isActive) continue;
 
-        TransformComponent& cameraTransform = cameras.get<TransformComponent>(cameraEntity);
+        const glm::mat4 &cameraMatrix = cameras.get<WorldTransformComponent>(cameraEntity).matrix;
+        glm::vec3 cameraPosition = glm::vec3(cameraMatrix[3]);
 
-        glm::vec3 cameraDir = cameraTransform.rotation * glm::vec3(0,0,1);
+        glm::vec3 cameraDir = glm::normalize(glm::vec3(cameraMatrix * glm::vec4(0, 0, 1, 0)));
         glm::vec3 right = glm::normalize(glm::cross(glm::vec3(0, 1, 0), -cameraDir));
         glm::vec3 up = glm::normalize(glm::cross(right, cameraDir));
-        glm::mat4 view = glm::lookAt(cameraTransform.position, cameraTransform.position + cameraDir, up);
+        glm::mat4 view = glm::lookAt(cameraPosition, cameraPosition + cameraDir, up);
 
-        glm::mat4 proj = glm::perspective(cameraComponent.fov, (float) window->GetWindowWidth() / (float) window->GetWindowHeight(), cameraComponent.nearPlane, cameraComponent.farPlane);
+        //Headless back ends have no window to take the aspect ratio from.
+        float aspect = window != nullptr ? (float) window->GetWindowWidth() / (float) window->GetWindowHeight() : 1.0f;
+        glm::mat4 proj = glm::perspective(cameraComponent.fov, aspect, cameraComponent.nearPlane, cameraComponent.farPlane);
         proj[1][1] *= -1;
 
         vpMatrix = proj * view;
+        farPlane = cameraComponent.farPlane;
+        hasCamera = true;
+        break;
+    }
+
+    const entt::entity *entities = objects.data();
+
+    //The GPU culls and draws by itself, all that's left to do here is hand it every object.
+    if(hasCamera && state.gpuCulling && SupportsIndirect(state))
+    {
+        state.stats = {};
+        StartFrame(state, 1);
+
+        ObjectData *gpuObjects = AllocateObjects(state, (uint32_t) objects.size());
+        ParallelFor(objects.size(), [&objects, entities, gpuObjects](size_t begin, size_t end)
+        {
+            for(size_t i = begin; i < end; i++)
+            {
+                const MeshComponent &meshComponent = objects.get<MeshComponent>(entities[i]);
+                const Bounds &bounds = objects.get<WorldBoundsComponent>(entities[i]).bounds;
+                gpuObjects[i] = {objects.get<WorldTransformComponent>(entities[i]).matrix,
+                                 glm::vec4(bounds.center, 0.0f), glm::vec4(bounds.extents, 0.0f),
+                                 meshComponent.mesh->index,
+                                 meshComponent.material != nullptr ? meshComponent.material->index : NO_MATERIAL, {}};
+            }
+        }, 0, sizeof(ObjectData));
+
+        chunkStats.assign(1, {});
+        StartChunk(state, 0);
+        RenderIndirect(state, 0, (uint32_t) objects.size());
+        EndChunk(state, 0);
+
+        state.stats = chunkStats[0].stats;
+        EndFrame(state);
+        return;
+    }
+
+    //Cull everything up front, so the back end only ever sees what's on screen.
+    visible.clear();
+
+    if(hasCamera)
+    {
+        culling.Resize(objects.size());
+        ParallelFor(objects.size(), [this, &objects, entities](size_t begin, size_t end)
+        {
+            for(size_t i = begin; i < end; i++)
+            {
+                culling.Set(i, objects.get<WorldBoundsComponent>(entities[i]).bounds);
+            }
+        }, 0, sizeof(float));
+
+        culling.Cull(ExtractFrustum(vpMatrix), visible);
 
-        for(auto entity : objects)
+        //Materials can be missing, e.g. after restoring a snapshot that refers to one that isn't loaded. Without one
+        //there's nothing to draw with.
+        visible.erase(std::remove_if(visible.begin(), visible.end(), [&objects, entities](uint32_t index)
         {
+            return objects.get<MeshComponent>(entities[index]).material == nullptr;
+        }), visible.end());
+    }
+
+    //Sort what's left so draws sharing a material and mesh are submitted back to back.
+    glm::vec4 depthRow(vpMatrix[0][3], vpMatrix[1][3], vpMatrix[2][3], vpMatrix[3][3]);
+    queue.Resize(visible.size());
+    ParallelFor(visible.size(), [this, &objects, entities, depthRow, farPlane](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; i++)
+        {
+            entt::entity entity = entities[visible[i]];
             MeshComponent& meshComponent = objects.get<MeshComponent>(entity);
-            TransformComponent& transformComponent = objects.get<TransformComponent>(entity);
-            RenderMesh(state, *meshComponent.mesh, *meshComponent.material, transformComponent);
+            const glm::mat4 &model = objects.get<WorldTransformComponent>(entity).matrix;
+
+            //The w row of the projection gives the distance along the view direction.
+            float depth = depthRow.x * model[3].x + depthRow.y * model[3].y + depthRow.z * model[3].z + depthRow.w;
+            uint64_t key = RenderQueue::MakeKey(meshComponent.material->pipeline, meshComponent.material,
+                                                meshComponent.mesh, depth / farPlane);
+            queue.Set(i, key, {meshComponent.mesh, meshComponent.material, &model});
         }
-        break;
+    }, 0, sizeof(DrawPacket));
+    queue.Sort();
+
+    //Draws of the same mesh and material are next to each other after sorting, each run becomes one instanced draw.
+    batches.clear();
+    for(size_t first = 0; first < queue.Size();)
+    {
+        const DrawPacket &packet = queue[first];
+
+        size_t last = first + 1;
+        while(last < queue.Size() && queue[last].mesh == packet.mesh && queue[last].material == packet.material) last++;
+
+        batches.push_back({(uint32_t) first, (uint32_t) (last - first)});
+        first = last;
+    }
+
+    //At most one chunk per thread, and only as many as there are draws to fill them.
+    JobSystem *jobSystem = JobSystem::GetInstance();
+    size_t threads = jobSystem != nullptr ? jobSystem->ThreadCount() : 1;
+    auto chunkCount = (uint32_t) std::min(threads, (batches.size() + MIN_DRAWS_PER_CHUNK - 1) / MIN_DRAWS_PER_CHUNK);
+
+    state.stats = {};
+    StartFrame(state, chunkCount);
+
+    InstanceData *instances = AllocateInstances(state, (uint32_t) queue.Size());
+    ParallelFor(queue.Size(), [this, instances](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; i++)
+        {
+            instances[i] = {*queue[i].model, queue[i].material->index};
+        }
+    }, 0, sizeof(InstanceData));
+
+    chunkStats.assign(chunkCount, {});
+
+    //One chunk per job, each recording a contiguous part of the batches so binds are still shared within it.
+    ParallelFor(chunkCount, [this, &state, chunkCount](size_t begin, size_t end)
+    {
+        for(size_t chunk = begin; chunk < end; chunk++)
+        {
+            size_t firstBatch = batches.size() * chunk / chunkCount;
+            size_t lastBatch = batches.size() * (chunk + 1) / chunkCount;
+
+            StartChunk(state, (uint32_t) chunk);
+            for(size_t i = firstBatch; i < lastBatch; i++)
+            {
+                const DrawPacket &packet = queue[batches[i].first];
+                RenderMesh(state, (uint32_t) chunk, *packet.mesh, *packet.material, batches[i].first, batches[i].count);
+            }
+            EndChunk(state, (uint32_t) chunk);
+        }
+    }, 1, sizeof(ChunkStats));
+
+    for(const ChunkStats &chunk : chunkStats)
+    {
+        state.stats += chunk.stats;
     }
 
     EndFrame(state);
@@ -60,7 +201,8 @@ void Renderer::Init(World &world)
 {
     NeedsFrameTick = true;
     NeedsTick = false;
-    this->window = Relic::Instance()->GetActiveWindow();
+    //Benchmarks run renderers without an engine instance.
+    this->window = Relic::Instance() ? Relic::Instance()->GetActiveWindow() : nullptr;
 
     world.Registry()->on_construct<MeshComponent>().connect<&Renderer::OnMeshComponentConstruction>(this);
     world.Registry()->on_destroy<MeshComponent>().connect<&Renderer::OnMeshComponentDestruction>(this);
@@ -70,14 +212,17 @@ void Renderer::OnMeshComponentConstruction(entt::registry& registry, entt::entit
 {
     MeshComponent &comp = registry.get<MeshComponent>(entity);
     SingletonRenderState & state = *registry.ctx<SingletonRenderState*>();
-    PrepareMesh(state, *comp.mesh);
+
+    //Meshes are shared between entities, only the first one prepares it.
+    if (comp.mesh->renderReferences++ == 0) PrepareMesh(state, *comp.mesh);
 }
 
 void Renderer::OnMeshComponentDestruction(entt::registry &registry, entt::entity entity)
 {
     MeshComponent &comp = registry.get<MeshComponent>(entity);
     SingletonRenderState & state = *registry.ctx<SingletonRenderState*>();
-    CleanupMesh(state, *comp.mesh);
+
+    if (--comp.mesh->renderReferences == 0) CleanupMesh(state, *comp.mesh);
 }
 
 void Renderer::RegisterMaterial(Material *material)
@@ -85,3 +230,8 @@ void Renderer::RegisterMaterial(Material *material)
     materials.push_back(material);
 }
 
+void Renderer::UnregisterMaterial(Material *material)
+{
+    materials.erase(std::remove(materials.begin(), materials.end(), material), materials.end());
+}
+
@@ -8,6 +8,8 @@
 #include <Core/ISystem.h>
 #include "Graphics/Window.h"
 #include "Graphics/Model.h"
+#include "Graphics/FrustumCulling.h"
+#include "Graphics/RenderQueue.h"
 #include <Core/Components/TransformComponent.h>
 #include <Graphics/Components/SingletonRenderState.h>
 
@@ -22,15 +24,54 @@ public:
 
     virtual ~Renderer() = 0;
 
-    virtual void StartFrame(SingletonRenderState &state) = 0;
-    virtual void RenderMesh(SingletonRenderState &state, Mesh &mesh, Material &material, TransformComponent component) = 0;
+    /// Start recording a frame.
+    /// \param chunkCount Number of chunks the draws of this frame are split into. Chunks are recorded in parallel, but
+    /// any one chunk is only ever recorded by one thread at a time.
+    virtual void StartFrame(SingletonRenderState &state, uint32_t chunkCount) = 0;
+
+    /// Get space for the data of every instance drawn this frame. Called once per frame, after StartFrame and before
+    /// the first RenderMesh.
+    /// \param count Number of instances.
+    /// \return Space for count instances, to be filled in by the caller. Only valid until EndFrame.
+    virtual InstanceData *AllocateInstances(SingletonRenderState &state, uint32_t count) = 0;
+
+    /// Start recording a chunk of draws, on the thread that records the rest of it.
+    virtual void StartChunk(SingletonRenderState &state, uint32_t chunk) = 0;
+
+    /// Draw a mesh once for each of a range of the instances returned by AllocateInstances.
+    /// \param chunk The chunk being recorded on this thread.
+    virtual void RenderMesh(SingletonRenderState &state, uint32_t chunk, Mesh &mesh, Material &material,
+                            uint32_t firstInstance, uint32_t instanceCount) = 0;
+
+    virtual void EndChunk(SingletonRenderState &state, uint32_t chunk) = 0;
+
+    /// Whether the back end can cull and draw on the GPU, through AllocateObjects and RenderIndirect.
+    virtual bool SupportsIndirect(SingletonRenderState &state) { return false; }
+
+    /// Get space for every object with a mesh, for the GPU to cull. Called in place of AllocateInstances, once per
+    /// frame after StartFrame and before the frame's only chunk is started.
+    /// \param count Number of objects.
+    /// \return Space for count objects, to be filled in by the caller. Only valid until EndFrame.
+    virtual ObjectData *AllocateObjects(SingletonRenderState &state, uint32_t count) { return nullptr; }
+
+    /// Cull the objects returned by AllocateObjects and draw what's visible, in place of RenderMesh.
+    /// \param chunk The chunk being recorded on this thread.
+    virtual void RenderIndirect(SingletonRenderState &state, uint32_t chunk, uint32_t objectCount) {}
+
     virtual void EndFrame(SingletonRenderState &state) = 0;
 
+    /// Create the render data of a mesh, when the first mesh component using it is created.
     virtual void PrepareMesh(SingletonRenderState &state, Mesh &mesh) = 0;
+
+    /// Release the render data of a mesh, when the last mesh component using it is destroyed. Frames already
+    /// submitted may still draw it, so back ends should hold on to GPU resources until those have finished.
     virtual void CleanupMesh(SingletonRenderState &state, Mesh &mesh) = 0;
 
     virtual void RegisterMaterial(Material *material);
 
+    /// Release the render data of a material. Nothing may draw with it afterwards.
+    virtual void UnregisterMaterial(Material *material);
+
     void Init(World &world) override;
 
     void FrameTick(World &world) override;
@@ -40,6 +81,33 @@ protected:
     glm::mat4 vpMatrix;
 
     std::vector<Material*> materials;
+
+    //Scratch space for culling, kept between frames to avoid reallocating.
+    CullingBatch culling;
+    std::vector<uint32_t> visible;
+    RenderQueue queue;
+
+    //Stats of every chunk, summed into the render state once they're all recorded. Padded so chunks recorded on
+    //different threads don't write to the same cache line.
+    struct alignas(64) ChunkStats
+    {
+        RenderStats stats;
+    };
+
+    std::vector<ChunkStats> chunkStats;
+
+private:
+    //Chunks are only worth recording on another thread once they have at least this many draws.
+    static constexpr size_t MIN_DRAWS_PER_CHUNK = 256;
+
+    /// Range of the sorted queue that shares a mesh and material, drawn with a single instanced draw.
+    struct DrawBatch
+    {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    std::vector<DrawBatch> batches;
 };
 
 #endif //RELIC_RENDERER_H
@@ -13,6 +13,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <algorithm>
 #include <Core/Util.h>
 #include <ResourceManager/ResourceManager.h>
 #include "VulkanRenderer.h"
@@ -23,12 +24,15 @@
 #include <Libraries/IMGUI/imgui_impl_glfw.h>
 #include <Core/World.h>
 #include <Graphics/Components/SingletonVulkanRenderState.h>
+#include <Core/Components/SingletonEntityComponent.h>
 #include <Core/Relic.h>
+#include <Debugging/Benchmark.h>
+#include <chrono>
 
 bool VulkanRenderer::CreateInstance(SingletonVulkanRenderState &state)
 {
     VkApplicationInfo applicationInfo = {};
-    applicationInfo.apiVersion = VK_API_VERSION_1_0;
+    applicationInfo.apiVersion = VK_API_VERSION_1_1;
     applicationInfo.applicationVersion = VK_MAKE_VERSION(0, 1, 0);
     applicationInfo.engineVersion = VK_MAKE_VERSION(0, 1, 0);
     applicationInfo.pApplicationName = "Test";
@@ -143,11 +147,19 @@ std::vector<const char *> *VulkanRenderer::GetRequiredExtensions(SingletonVulkan
     return extensions;
 }
 
+std::atomic<uint32_t> VulkanRenderer::validationErrors(0);
+
+uint32_t VulkanRenderer::ValidationErrors()
+{
+    return validationErrors;
+}
+
 VkBool32 VulkanRenderer::ValidationCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
                                             VkDebugUtilsMessageTypeFlagsEXT messageType,
                                             const VkDebugUtilsMessengerCallbackDataEXT *callbackData, void *userData)
 {
     Logger::Log("[ValidationMessage] %s", callbackData->pMessage);
+    if (messageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) validationErrors++;
 
     return VK_FALSE;
 }
@@ -273,7 +285,10 @@ int VulkanRenderer::ScorePhysicalDevice(SingletonVulkanRenderState &state, VkPhy
         isSwapchainSupported = !details.presentModes.empty() && !details.formats.empty();
     }
 
-    if (!indices.IsComplete() || !areExtensionsSupported || !isSwapchainSupported) score = 0;
+    //Materials sample from the texture table, there's no path without descriptor indexing.
+    bool isBindlessSupported = areExtensionsSupported && TextureTable::Supported(device);
+
+    if (!indices.IsComplete() || !areExtensionsSupported || !isSwapchainSupported || !isBindlessSupported) score = 0;
 
     return score;
 }
@@ -373,14 +388,29 @@ void VulkanRenderer::CreateLogicalDevice(SingletonVulkanRenderState &state)
     }
 
     VkPhysicalDeviceFeatures deviceFeatures = {};
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = TextureTable::RequiredFeatures();
+
+    //Culling on the GPU is optional, without it everything is culled on the CPU.
+    std::vector<const char *> extensions = state.deviceExtensions;
+    state.indirectSupported = IndirectCulling::Supported(state.physicalDevice);
+    if (!state.indirectSupported)
+    {
+        Logger::Log("[VulkanRenderer] [WRN] GPU culling is unavailable: indirect count draws aren't supported.");
+    } else
+    {
+        extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+        deviceFeatures.multiDrawIndirect = VK_TRUE;
+        deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+    }
 
     VkDeviceCreateInfo deviceCreateInfo = {};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceCreateInfo.pNext = &indexingFeatures;
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
     deviceCreateInfo.queueCreateInfoCount = queueCreateInfos.size();
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-    deviceCreateInfo.ppEnabledExtensionNames = state.deviceExtensions.data();
-    deviceCreateInfo.enabledExtensionCount = state.deviceExtensions.size();
+    deviceCreateInfo.ppEnabledExtensionNames = extensions.data();
+    deviceCreateInfo.enabledExtensionCount = extensions.size();
 
     if (!state.enabledValidationLayers.empty())
     {
@@ -527,134 +557,22 @@ void VulkanRenderer::CreateSwapchainImageViews(SingletonVulkanRenderState &state
 
 void VulkanRenderer::CreateGraphicsPipeline(SingletonVulkanRenderState &state)
 {
-    std::vector<char> vertShaderCode = ReadFile("Shaders/vert.spv");
-    std::vector<char> fragShaderCode = ReadFile("Shaders/frag.spv");
-
-    VkShaderModule vertModule = CreateShaderModule(vertShaderCode, state.device);
-    VkShaderModule fragModule = CreateShaderModule(fragShaderCode, state.device);
-
-    VkPipelineShaderStageCreateInfo vertShaderStageCreateInfo = {};
-    vertShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageCreateInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageCreateInfo.module = vertModule;
-    vertShaderStageCreateInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo fragShaderStageCreateInfo = {};
-    fragShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageCreateInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageCreateInfo.module = fragModule;
-    fragShaderStageCreateInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageCreateInfo, fragShaderStageCreateInfo};
-
-    auto bindingDescription = GetVertexInputBindingDescription();
-    auto attributeDescriptions = GetAttributeDescriptions();
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    VkViewport viewport = {};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float) state.swapchainImageExtent.width;
-    viewport.height = (float) state.swapchainImageExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    VkRect2D scissor = {};
-    scissor.offset = {0, 0};
-    scissor.extent = state.swapchainImageExtent;
-
-    VkPipelineViewportStateCreateInfo viewportState = {};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer = {};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizer.depthBiasClamp = VK_FALSE;
-
-    VkPipelineMultisampleStateCreateInfo multisampling = {};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending = {};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-
-    VkPushConstantRange pushConstants = {};
-    pushConstants.offset = 0;
-    pushConstants.size = sizeof(PushConstants);
-    pushConstants.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    std::vector<VkDescriptorSetLayout> layouts = {state.descriptorSetLayout, state.materialDescriptorSetLayout};
+    std::vector<VkDescriptorSetLayout> layouts = {state.descriptorSetLayout, state.textures.Layout(), state.objectSetLayout};
     pipelineLayoutInfo.setLayoutCount = layouts.size();
     pipelineLayoutInfo.pSetLayouts = layouts.data();
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushConstants;
+    pipelineLayoutInfo.pushConstantRangeCount = 0;
 
     if (vkCreatePipelineLayout(state.device, &pipelineLayoutInfo, nullptr, &state.pipelineLayout) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create pipeline layout.");
     }
 
-    VkPipelineDepthStencilStateCreateInfo depthStencil = {};
-    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = VK_TRUE;
-    depthStencil.depthWriteEnable = VK_TRUE;
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-    depthStencil.depthBoundsTestEnable = VK_FALSE;
-    depthStencil.stencilTestEnable = VK_FALSE;
-    depthStencil.minDepthBounds = 0.0f;
-    depthStencil.maxDepthBounds = 1.0f;
-
-    VkGraphicsPipelineCreateInfo pipelineInfo = {};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDepthStencilState = &depthStencil;
-    pipelineInfo.layout = state.pipelineLayout;
-    pipelineInfo.renderPass = state.renderPass;
-    pipelineInfo.subpass = 0;
-
-    if (vkCreateGraphicsPipelines(state.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &state.graphicsPipeline) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to create graphics pipeline.");
-    }
-
-    vkDestroyShaderModule(state.device, fragModule, nullptr);
-    vkDestroyShaderModule(state.device, vertModule, nullptr);
+    //The pipelines themselves come from the library, which compiles the fallback now and the rest in the background.
+    auto start = std::chrono::high_resolution_clock::now();
+    state.pipelines->SetTargets(state.pipelineLayout, state.renderPass);
+    Logger::Log("[VulkanRenderer] Created fallback pipeline in %sms, %i more queued.", std::to_string(Benchmark::SecondsSince(start) * 1000.0).c_str(), (int) state.pipelines->Pending());
 }
 
 void VulkanRenderer::CreateRenderPass(SingletonVulkanRenderState &state)
@@ -802,13 +720,35 @@ void VulkanRenderer::CreateSynchronisationObjects(SingletonVulkanRenderState &st
     }
 }
 
-void VulkanRenderer::StartFrame(SingletonRenderState &s)
+void VulkanRenderer::StartFrame(SingletonRenderState &s, uint32_t chunkCount)
 {
     auto & state = (SingletonVulkanRenderState&) s;
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     vkWaitForFences(state.device, 1, &state.inFlightFences[state.currentFrame], VK_TRUE, UINT64_MAX);
 
+    //That fence covers everything recorded for this frame in flight last time, so its pools are free to reset and
+    //what was released before it was submitted can go.
+    if (state.releasedInFlight.size() < state.MAX_FRAMES_IN_FLIGHT) state.releasedInFlight.resize(state.MAX_FRAMES_IN_FLIGHT);
+    DestroyReleased(state, state.releasedInFlight[state.currentFrame]);
+    state.transientDescriptors[state.currentFrame].Reset();
+
+    if (state.drawRecorders.size() < state.MAX_FRAMES_IN_FLIGHT) state.drawRecorders.resize(state.MAX_FRAMES_IN_FLIGHT);
+    CreateDrawRecorders(state, chunkCount + 1);
+    for (DrawRecorder &recorder : state.drawRecorders[state.currentFrame])
+    {
+        vkResetCommandPool(state.device, recorder.pool, 0);
+    }
+    state.drawChunkCount = chunkCount;
+    state.indirectFrame = false;
+    state.frameData.StartFrame(state.currentFrame);
+
+    //Whatever finished uploading can be drawn from now on, then everything written since last frame goes out at once.
+    state.uploads.Update();
+    UpdatePendingUploads(state);
+    state.uploads.Submit();
+    UpdateUploadStats(state);
+
     VkResult result = vkAcquireNextImageKHR(state.device, state.swapchain, UINT64_MAX, state.imageAvailableSemaphores[state.currentFrame], VK_NULL_HANDLE, &state.imageIndex);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
@@ -827,7 +767,7 @@ void VulkanRenderer::StartFrame(SingletonRenderState &s)
 
     state.imagesInFlight[state.imageIndex] = state.inFlightFences[state.currentFrame];
 
-    UpdateUniformBuffers(state.imageIndex);
+    UpdateUniformBuffers(state);
     StartCommandBuffer(state);
 }
 
@@ -840,7 +780,7 @@ void VulkanRenderer::CleanupSwapchain(SingletonVulkanRenderState &state)
 
     vkFreeCommandBuffers(state.device, state.commandPool, static_cast<uint32_t>(state.commandBuffers.size()), state.commandBuffers.data());
 
-    vkDestroyPipeline(state.device, state.graphicsPipeline, nullptr);
+    state.pipelines->ReleaseTargets();
     vkDestroyPipelineLayout(state.device, state.pipelineLayout, nullptr);
     vkDestroyRenderPass(state.device, state.renderPass, nullptr);
 
@@ -848,15 +788,10 @@ void VulkanRenderer::CleanupSwapchain(SingletonVulkanRenderState &state)
 
     vkDestroySwapchainKHR(state.device, state.swapchain, nullptr);
 
-    for (size_t i = 0; i < state.swapchainImages.size(); i++)
-    {
-        vmaDestroyBuffer(state.allocator, state.uniformBuffers[i], state.uniformBufferAllocations[i]);
-    }
-
     vkDestroyImageView(state.device, state.depthImageView, nullptr);
     vmaDestroyImage(state.allocator, state.depthImage, state.depthImageAllocation);
 
-    vkDestroyDescriptorPool(state.device, state.descriptorPool, nullptr);
+    vkDestroyDescriptorPool(state.device, state.imGuiDescriptorPool, nullptr);
 }
 
 
@@ -867,6 +802,8 @@ void VulkanRenderer::RecreateSwapChain(SingletonVulkanRenderState &state)
     vkDeviceWaitIdle(state.device);
     ImGui::Render();
 
+    //Released descriptor sets have to be freed before their pool goes.
+    DestroyAllReleased(state);
     CleanupSwapchain(state);
 //    ImGui_ImplVulkan_Shutdown();
 
@@ -876,9 +813,7 @@ void VulkanRenderer::RecreateSwapChain(SingletonVulkanRenderState &state)
     CreateGraphicsPipeline(state);
     CreateDepthResources(state);
     CreateFrameBuffers(state);
-    CreateUniformBuffers(state);
-    CreateDescriptorSetPool(state);
-    CreateDescriptorSets(state);
+    CreateImGuiDescriptorPool(state);
     CreateCommandBuffers(state, false);
     SetupImGui(state);
 }
@@ -907,10 +842,17 @@ void VulkanRenderer::CreateDescriptorSetLayout(SingletonVulkanRenderState &state
     VkDescriptorSetLayoutBinding uboLayoutBinding = {};
     uboLayoutBinding.binding = 0;
     uboLayoutBinding.descriptorCount = 1;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
-    std::vector<VkDescriptorSetLayoutBinding> bindings = {uboLayoutBinding};
+    //Materials are read where instances are, the vertex shader hands the texture slot on.
+    VkDescriptorSetLayoutBinding materialLayoutBinding = {};
+    materialLayoutBinding.binding = 1;
+    materialLayoutBinding.descriptorCount = 1;
+    materialLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    materialLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings = {uboLayoutBinding, materialLayoutBinding};
 
     VkDescriptorSetLayoutCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -923,115 +865,98 @@ void VulkanRenderer::CreateDescriptorSetLayout(SingletonVulkanRenderState &state
         throw std::runtime_error("failed to create descriptor set layout.");
     }
 
-    VkDescriptorSetLayoutBinding materialLayoutBinding = {};
-    materialLayoutBinding.binding = 1;
-    materialLayoutBinding.descriptorCount = 1;
-    materialLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    materialLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-
-    bindings = {materialLayoutBinding};
+    //Objects culled on the GPU, looked up by the instance index of their draw. A set of its own, since it's written
+    //anew every frame that uses it.
+    VkDescriptorSetLayoutBinding objectLayoutBinding = {};
+    objectLayoutBinding.binding = 0;
+    objectLayoutBinding.descriptorCount = 1;
+    objectLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    objectLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
-    createInfo.bindingCount = bindings.size();
-    createInfo.pBindings = bindings.data();
+    createInfo.bindingCount = 1;
+    createInfo.pBindings = &objectLayoutBinding;
 
-    if(vkCreateDescriptorSetLayout(state.device, &createInfo, nullptr, &state.materialDescriptorSetLayout) != VK_SUCCESS)
+    if (vkCreateDescriptorSetLayout(state.device, &createInfo, nullptr, &state.objectSetLayout) != VK_SUCCESS)
     {
-        throw std::runtime_error("failed to create material descriptor set layout.");
+        throw std::runtime_error("failed to create descriptor set layout.");
     }
 }
 
-void VulkanRenderer::CreateUniformBuffers(SingletonVulkanRenderState &state)
+void VulkanRenderer::CreateFrameData(SingletonVulkanRenderState &state)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(state.physicalDevice, &properties);
+
+    //The camera is read as a dynamic uniform buffer, materials as a dynamic storage buffer and instances as a vertex
+    //buffer, all at offsets into the frame.
+    state.frameData.Create(state.allocator, state.MAX_FRAMES_IN_FLIGHT, FRAME_DATA_SIZE,
+                           VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                           std::max(properties.limits.minUniformBufferOffsetAlignment, properties.limits.minStorageBufferOffsetAlignment));
+}
+
+void VulkanRenderer::UpdateUniformBuffers(SingletonVulkanRenderState &state)
 {
-    //Create Uniform buffers
-    state.uniformBuffers.resize(state.swapchainImages.size());
-    state.uniformBufferAllocations.resize(state.swapchainImages.size());
-    VkDeviceSize bufferSize = sizeof(UniformBufferObject);
+    CameraData *camera = (CameraData *) state.frameData.Allocate(sizeof(CameraData), state.cameraOffset);
+    camera->viewProjection = vpMatrix;
 
-    for (int i = 0; i < state.swapchainImages.size(); i++)
+    //Always the whole table, the descriptor's range has to fit behind every offset it's bound at.
+    auto materials = (MaterialTableEntry *) state.frameData.Allocate(MAX_MATERIALS * sizeof(MaterialTableEntry), state.materialOffset);
+    for (size_t i = 0; i < state.materialTable.size(); i++)
     {
-        CreateBuffer(state.allocator, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, state.uniformBuffers[i], state.uniformBufferAllocations[i]);
+        //The culling pass skips materials without a draw list, so it never draws one that isn't ready.
+        const VulkanMaterialData *data = state.materialTable[i];
+        if (data == nullptr) materials[i] = {0, NO_DRAW_LIST};
+        else materials[i] = {data->textureSlot, data->ready ? data->drawList : NO_DRAW_LIST};
     }
 }
 
-void VulkanRenderer::UpdateUniformBuffers(uint32_t currentImage)
+void VulkanRenderer::CreateImGuiDescriptorPool(SingletonVulkanRenderState &state)
 {
-//    static auto startTime = std::chrono::high_resolution_clock::now();
-//    auto currentTime = std::chrono::high_resolution_clock::now();
-//
-//    float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-//
-//    UniformBufferObject ubo = {};
-//    ubo.model = glm::rotate(glm::rotate(glm::identity<glm::mat4>(), time * glm::radians(45.0f), glm::vec3(0, 1, 0)), glm::radians(-90.0f), glm::vec3(1, 0, 0));
-//    ubo.view = glm::lookAt(glm::vec3(30), glm::zero<glm::vec3>(), glm::vec3(0, 1, 0));
-//    ubo.proj = glm::perspective(glm::radians(45.0f), swapchainImageExtent.width / (float) swapchainImageExtent.height, 1.0f, 200.0f);
-//
-//    //counteract opengl flip
-//    ubo.proj[1][1] *= -1;
-//
-//    WriteToBufferDirect(allocator, uniformBufferAllocations[currentImage], &ubo, sizeof(UniformBufferObject));
-}
+    //ImGui only allocates the set of its font texture.
+    VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1};
 
-void VulkanRenderer::CreateDescriptorSetPool(SingletonVulkanRenderState &state)
-{
-    VkDescriptorPoolSize pool_sizes[] =
-            {
-                    {VK_DESCRIPTOR_TYPE_SAMPLER,                1000},
-                    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000},
-                    {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          1000},
-                    {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          1000},
-                    {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,   1000},
-                    {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,   1000},
-                    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         1000},
-                    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         1000},
-                    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000},
-                    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000},
-                    {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,       1000}
-            };
-    VkDescriptorPoolCreateInfo pool_info = {};
-    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    pool_info.maxSets = 1000 * IM_ARRAYSIZE(pool_sizes);
-    pool_info.poolSizeCount = (uint32_t) IM_ARRAYSIZE(pool_sizes);
-    pool_info.pPoolSizes = pool_sizes;
-    if (vkCreateDescriptorPool(state.device, &pool_info, nullptr, &state.descriptorPool))
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(state.device, &poolInfo, nullptr, &state.imGuiDescriptorPool))
     {
         throw std::runtime_error("failed to create descriptor pool.");
     }
 }
 
-void VulkanRenderer::CreateDescriptorSets(SingletonVulkanRenderState &state)
+void VulkanRenderer::CreateDescriptorAllocators(SingletonVulkanRenderState &state)
 {
-    std::vector<VkDescriptorSetLayout> layouts(state.swapchainImages.size(), state.descriptorSetLayout);
-    VkDescriptorSetAllocateInfo allocateInfo = {};
-    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocateInfo.descriptorPool = state.descriptorPool;
-    allocateInfo.descriptorSetCount = state.swapchainImages.size();
-    allocateInfo.pSetLayouts = layouts.data();
+    //Frame sets only change when a frame's buffer grows, so there are rarely more than one per frame in flight.
+    state.frameSets.Create(state.device, state.MAX_FRAMES_IN_FLIGHT, {
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f}
+    });
+    state.frameSetBuffers.assign(state.MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
 
-    state.descriptorSets.resize(state.swapchainImages.size());
-    if (vkAllocateDescriptorSets(state.device, &allocateInfo, state.descriptorSets.data()))
+    state.transientDescriptors.resize(state.MAX_FRAMES_IN_FLIGHT);
+    for (DescriptorAllocator &allocator : state.transientDescriptors)
     {
-        throw std::runtime_error("failed to allocate descriptor sets.");
+        allocator.Create(state.device, TRANSIENT_DESCRIPTOR_SETS, {{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f}});
     }
+}
 
-    for (size_t i = 0; i < state.swapchainImages.size(); i++)
-    {
-        VkDescriptorBufferInfo bufferInfo = {};
-        bufferInfo.buffer = state.uniformBuffers[i];
-        bufferInfo.offset = 0;
-        bufferInfo.range = VK_WHOLE_SIZE;
-
-        VkWriteDescriptorSet descriptorWrite = {};
-        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet = state.descriptorSets[i];
-        descriptorWrite.dstBinding = 0;
-        descriptorWrite.dstArrayElement = 0;
-        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrite.descriptorCount = 1;
-        descriptorWrite.pBufferInfo = &bufferInfo;
-
-        vkUpdateDescriptorSets(state.device, 1, &descriptorWrite, 0, nullptr);
-    }
+void VulkanRenderer::UpdateFrameSet(SingletonVulkanRenderState &state)
+{
+    VkBuffer buffer = state.frameData.Buffer();
+
+    //A frame's buffer is destroyed when it grows, and its handle could come back as a different buffer. Forgetting
+    //leaks the old sets until shutdown, buffers double when they grow so that's a handful at most.
+    VkBuffer &lastBuffer = state.frameSetBuffers[state.currentFrame];
+    if (lastBuffer != buffer && lastBuffer != VK_NULL_HANDLE) state.frameSets.Forget();
+    lastBuffer = buffer;
+
+    //Dynamic, so the offsets of each frame's camera and materials are given when the set is bound.
+    state.frameSet = state.frameSets.Get(state.descriptorSetLayout, {
+            {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, {buffer, 0, sizeof(CameraData)}, {}},
+            {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, {buffer, 0, MAX_MATERIALS * sizeof(MaterialTableEntry)}, {}}
+    });
 }
 
 void VulkanRenderer::CreateDepthResources(SingletonVulkanRenderState &state)
@@ -1052,8 +977,8 @@ void VulkanRenderer::SetupImGui(SingletonVulkanRenderState &state)
     initInfo.Device = state.device;
     initInfo.QueueFamily = FindQueueFamily(state).graphicsFamily.value();
     initInfo.Queue = state.graphicsQueue;
-    initInfo.PipelineCache = nullptr;
-    initInfo.DescriptorPool = state.descriptorPool;
+    initInfo.PipelineCache = state.pipelineCache.Handle();
+    initInfo.DescriptorPool = state.imGuiDescriptorPool;
     initInfo.Allocator = nullptr;
     initInfo.MinImageCount = state.MAX_FRAMES_IN_FLIGHT;
     initInfo.ImageCount = state.MAX_FRAMES_IN_FLIGHT;
@@ -1109,7 +1034,10 @@ void VulkanRenderer::StartCommandBuffer(SingletonVulkanRenderState &state)
     {
         throw std::runtime_error("Failed to begin recording a command buffer.");
     }
+}
 
+void VulkanRenderer::StartRenderPass(SingletonVulkanRenderState &state)
+{
     VkRenderPassBeginInfo renderPassInfo = {};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     renderPassInfo.renderPass = state.renderPass;
@@ -1124,87 +1052,467 @@ void VulkanRenderer::StartCommandBuffer(SingletonVulkanRenderState &state)
     renderPassInfo.clearValueCount = clearValues.size();
     renderPassInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(state.commandBuffers[state.imageIndex], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(state.commandBuffers[state.imageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, state.graphicsPipeline);
+    //Everything inside the render pass is recorded into secondary command buffers, see StartChunk.
+    vkCmdBeginRenderPass(state.commandBuffers[state.imageIndex], &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+}
+
+void VulkanRenderer::CreateDrawRecorders(SingletonVulkanRenderState &state, uint32_t count)
+{
+    std::vector<DrawRecorder> &recorders = state.drawRecorders[state.currentFrame];
+    if (recorders.size() >= count) return;
+
+    QueueFamilyIndices queueFamilyIndices = FindQueueFamily(state);
+    size_t first = recorders.size();
+    recorders.resize(count);
+
+    for (size_t i = first; i < count; i++)
+    {
+        //Pools are reset as a whole every frame, so their buffers don't need resetting one by one.
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        if (vkCreateCommandPool(state.device, &poolInfo, nullptr, &recorders[i].pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create command pool.");
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = recorders[i].pool;
+        allocateInfo.commandBufferCount = 1;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+        if (vkAllocateCommandBuffers(state.device, &allocateInfo, &recorders[i].commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to allocate command buffer");
+        }
+    }
+}
+
+void VulkanRenderer::StartSecondaryCommandBuffer(SingletonVulkanRenderState &state, DrawRecorder &recorder)
+{
+    VkCommandBufferInheritanceInfo inheritanceInfo = {};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = state.renderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = state.swapchainFrameBuffers[state.imageIndex];
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    if (vkBeginCommandBuffer(recorder.commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to begin recording a command buffer.");
+    }
+
+    //Nothing carries over from the primary command buffer, or from the last time this one was recorded.
+    recorder.boundPipeline = VK_NULL_HANDLE;
+}
+
+void VulkanRenderer::StartChunk(SingletonRenderState &s, uint32_t chunk)
+{
+    auto & state = (SingletonVulkanRenderState&) s;
+    DrawRecorder &recorder = state.drawRecorders[state.currentFrame][chunk];
+    StartSecondaryCommandBuffer(state, recorder);
+
+    //Everything a draw reads is in these sets, the frame's data, the texture table and the objects of frames culled on
+    //the GPU. Pipelines share a layout, so they stay bound across the pipeline binds of RenderMesh.
+    VkDescriptorSet sets[] = {state.frameSet, state.textures.Set(), state.objectSet};
+    uint32_t setCount = state.indirectFrame ? 3 : 2;
+    uint32_t dynamicOffsets[] = {(uint32_t) state.cameraOffset, (uint32_t) state.materialOffset};
+    vkCmdBindDescriptorSets(recorder.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, state.pipelineLayout, 0, setCount, sets, 2, dynamicOffsets);
+
+    VkViewport viewport = {0.0f, 0.0f, (float) state.swapchainImageExtent.width, (float) state.swapchainImageExtent.height, 0.0f, 1.0f};
+    VkRect2D scissor = {{0, 0}, state.swapchainImageExtent};
+    vkCmdSetViewport(recorder.commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(recorder.commandBuffer, 0, 1, &scissor);
+
+    VkBuffer vertexBuffers[] = {state.vertexArena.buffer.buffer, state.frameData.Buffer()};
+    VkDeviceSize offsets[] = {0, state.instanceOffset};
+    vkCmdBindVertexBuffers(recorder.commandBuffer, 0, 2, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(recorder.commandBuffer, state.indexArena.buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    chunkStats[chunk].stats.meshBinds++;
+}
+
+void VulkanRenderer::EndChunk(SingletonRenderState &s, uint32_t chunk)
+{
+    auto & state = (SingletonVulkanRenderState&) s;
+
+    if (vkEndCommandBuffer(state.drawRecorders[state.currentFrame][chunk].commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to record command buffer.");
+    }
+}
+
+InstanceData *VulkanRenderer::AllocateInstances(SingletonRenderState &s, uint32_t count)
+{
+    auto & state = (SingletonVulkanRenderState&) s;
+    auto instances = (InstanceData *) state.frameData.Allocate(count * sizeof(InstanceData), state.instanceOffset);
+
+    //This is the last allocation before recording, if the buffer had to grow the frame's descriptor set follows it.
+    UpdateFrameSet(state);
 
-    vkCmdBindDescriptorSets(state.commandBuffers[state.imageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, state.pipelineLayout, 0, 1, &state.descriptorSets[state.imageIndex], 0, nullptr);
+    return instances;
+}
+
+bool VulkanRenderer::SupportsIndirect(SingletonRenderState &s)
+{
+    return ((SingletonVulkanRenderState&) s).indirectSupported;
+}
+
+ObjectData *VulkanRenderer::AllocateObjects(SingletonRenderState &s, uint32_t count)
+{
+    auto & state = (SingletonVulkanRenderState&) s;
+
+    //Where each mesh is in the arenas this frame, ranges move when an arena is compacted.
+    VkDeviceSize meshesOffset;
+    size_t meshCount = std::max<size_t>(state.meshTable.size(), 1);
+    auto meshes = (MeshTableEntry *) state.frameData.Allocate(meshCount * sizeof(MeshTableEntry), meshesOffset);
+    for (size_t i = 0; i < meshCount; i++)
+    {
+        Mesh *mesh = i < state.meshTable.size() ? state.meshTable[i] : nullptr;
+        auto renderData = mesh != nullptr ? (VulkanRenderData *) mesh->renderData : nullptr;
+        if (renderData == nullptr || !renderData->ready)
+        {
+            meshes[i] = {0, 0, 0};
+            continue;
+        }
+
+        meshes[i] = {(uint32_t) mesh->indexCount, state.indexArena.ranges.Offset(renderData->indices),
+                     (int32_t) state.vertexArena.ranges.Offset(renderData->vertices)};
+    }
+
+    VkDeviceSize objectsOffset;
+    auto objects = (ObjectData *) state.frameData.Allocate(std::max<uint32_t>(count, 1) * sizeof(ObjectData), objectsOffset);
+
+    //Nothing comes from the instance buffer this frame, but StartChunk binds it anyway.
+    state.instanceOffset = 0;
+
+    //As with AllocateInstances, this is the last allocation before recording.
+    UpdateFrameSet(state);
+
+    //The objects move every frame, so they get a set that only lasts the frame instead of a dynamic offset.
+    VkDescriptorBufferInfo objectInfo = {state.frameData.Buffer(), objectsOffset, std::max<uint32_t>(count, 1) * sizeof(ObjectData)};
+    state.objectSet = state.transientDescriptors[state.currentFrame].Allocate(state.objectSetLayout);
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = state.objectSet;
+    write.dstBinding = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &objectInfo;
+    vkUpdateDescriptorSets(state.device, 1, &write, 0, nullptr);
+
+    IndirectCulling::Inputs inputs = {};
+    inputs.buffer = state.frameData.Buffer();
+    inputs.objectsOffset = objectsOffset;
+    inputs.objectsSize = objectInfo.range;
+    inputs.meshesOffset = meshesOffset;
+    inputs.meshesSize = meshCount * sizeof(MeshTableEntry);
+    inputs.materialsOffset = state.materialOffset;
+    inputs.materialsSize = MAX_MATERIALS * sizeof(MaterialTableEntry);
+    state.culling.Prepare(state.currentFrame, inputs, count, (uint32_t) state.drawListPipelines.size());
+    state.indirectFrame = true;
+
+    return objects;
+}
+
+void VulkanRenderer::RenderIndirect(SingletonRenderState &s, uint32_t chunk, uint32_t objectCount)
+{
+    auto & state = (SingletonVulkanRenderState&) s;
+    DrawRecorder &recorder = state.drawRecorders[state.currentFrame][chunk];
+    RenderStats &stats = chunkStats[chunk].stats;
+
+    //One draw per pipeline, however many objects the culling pass lets through.
+    for (uint32_t list = 0; list < state.drawListPipelines.size(); list++)
+    {
+        //The fallback reads instances from a vertex buffer, so lists wait for their own pipeline instead.
+        uint32_t pipelineId = state.drawListPipelines[list];
+        if (!state.pipelines->Ready(pipelineId)) continue;
+
+        VkPipeline pipeline = state.pipelines->Get(pipelineId);
+        if (recorder.boundPipeline != pipeline)
+        {
+            vkCmdBindPipeline(recorder.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            recorder.boundPipeline = pipeline;
+            stats.pipelineBinds++;
+        }
+        else
+        {
+            stats.pipelineBindsAvoided++;
+        }
+
+        state.culling.Draw(recorder.commandBuffer, list);
+        stats.draws++;
+    }
+
+    //Only known once the GPU has culled, so these are the instances of a frame that's already done.
+    stats.instances += state.culling.CompletedDraws();
 }
 
 void VulkanRenderer::PrepareMesh(SingletonRenderState &s, Mesh &mesh)
 {
     auto & state = (SingletonVulkanRenderState&) s;
     auto renderData = new VulkanRenderData();
-    renderData->indexBuffer = {};
-    renderData->vertexBuffer = {};
+    renderData->vertices = TLSFAllocator::INVALID_ALLOCATION;
+    renderData->indices = TLSFAllocator::INVALID_ALLOCATION;
+
+    //Frames build the mesh table when they start, so a slot can be reused as soon as its mesh is gone.
+    if (state.freeMeshes.empty())
+    {
+        state.freeMeshes.push_back((uint32_t) state.meshTable.size());
+        state.meshTable.push_back(nullptr);
+    }
 
-    VkDeviceSize vertexBufferSize = mesh.vertexCount * sizeof(Vertex);
-    VkDeviceSize indexBufferSize = mesh.indexCount * sizeof(uint32_t);
+    mesh.index = state.freeMeshes.back();
+    state.freeMeshes.pop_back();
+    state.meshTable[mesh.index] = &mesh;
 
-    if (vertexBufferSize == 0 || indexBufferSize == 0)
+    if (mesh.vertexCount == 0 || mesh.indexCount == 0)
     {
         //empty mesh?
-        renderData->vertexBuffer.buffer = VK_NULL_HANDLE;
         renderData->ready = false;
 
         mesh.renderData = renderData;
         return;
     }
 
-    //Create buffers
-    CreateBuffer(state.allocator, indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY,
-                 renderData->indexBuffer.buffer,
-                 renderData->indexBuffer.allocation);
-    CreateBuffer(state.allocator, vertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY,
-                 renderData->vertexBuffer.buffer,
-                 renderData->vertexBuffer.allocation);
+    //Take a range of each arena, and write the data to it.
+    renderData->vertices = AllocateGeometry(state, state.vertexArena, mesh.vertexCount);
+    renderData->indices = AllocateGeometry(state, state.indexArena, mesh.indexCount);
 
+    if (renderData->vertices == TLSFAllocator::INVALID_ALLOCATION || renderData->indices == TLSFAllocator::INVALID_ALLOCATION)
+    {
+        Logger::Log("[VulkanRenderer] Failed to allocate geometry for a mesh with %i vertices.", (int) mesh.vertexCount);
+        renderData->ready = false;
 
-    //Write data to them
-    WriteToBuffer(state.allocator, renderData->indexBuffer.buffer, mesh.indices, indexBufferSize, state.commandPool, state.device, state.graphicsQueue);
-    WriteToBuffer(state.allocator, renderData->vertexBuffer.buffer, mesh.vertices, vertexBufferSize, state.commandPool, state.device, state.graphicsQueue);
+        mesh.renderData = renderData;
+        UpdateGeometryStats(state);
+        return;
+    }
 
-    renderData->ready = true;
+    VkDeviceSize vertexOffset = (VkDeviceSize) state.vertexArena.ranges.Offset(renderData->vertices) * sizeof(Vertex);
+    VkDeviceSize indexOffset = (VkDeviceSize) state.indexArena.ranges.Offset(renderData->indices) * sizeof(uint32_t);
+
+    //Both copies end up in the same batch, the mesh is drawn once it has completed.
+    state.uploads.WriteBuffer(state.indexArena.buffer.buffer, indexOffset, mesh.indices, mesh.indexCount * sizeof(uint32_t));
+    uint64_t ticket = state.uploads.WriteBuffer(state.vertexArena.buffer.buffer, vertexOffset, mesh.vertices, mesh.vertexCount * sizeof(Vertex));
+
+    renderData->ready = false;
+    state.pendingUploads.push_back({ticket, &renderData->ready});
 
     mesh.renderData = renderData;
+    UpdateGeometryStats(state);
 }
 
 void VulkanRenderer::CleanupMesh(SingletonRenderState &s, Mesh &mesh)
 {
     auto & state = (SingletonVulkanRenderState&) s;
-    vkDeviceWaitIdle(state.device);
-
     auto renderData = (VulkanRenderData *) mesh.renderData;
 
-    vmaDestroyBuffer(state.allocator, renderData->indexBuffer.buffer, renderData->indexBuffer.allocation);
-    vmaDestroyBuffer(state.allocator, renderData->vertexBuffer.buffer, renderData->vertexBuffer.allocation);
+    std::vector<PendingUpload> &pending = state.pendingUploads;
+    pending.erase(std::remove_if(pending.begin(), pending.end(), [renderData](const PendingUpload &upload)
+    {
+        return upload.ready == &renderData->ready;
+    }), pending.end());
 
-    delete renderData;
+    //Frames in flight may still draw from the mesh's ranges, they're freed once those have finished.
+    state.released.meshes.push_back(renderData);
     mesh.renderData = nullptr;
+
+    state.meshTable[mesh.index] = nullptr;
+    state.freeMeshes.push_back(mesh.index);
+}
+
+void VulkanRenderer::CreateGeometryArena(SingletonVulkanRenderState &state, GeometryArena &arena, uint32_t stride, VkBufferUsageFlags usage, uint32_t capacity)
+{
+    //Transfers both ways, for uploads and for copying everything over when compacting.
+    arena.stride = stride;
+    arena.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    arena.compactions = 0;
+    arena.ranges.Reset(capacity);
+
+    CreateBuffer(state.allocator, (VkDeviceSize) capacity * stride, arena.usage, VMA_MEMORY_USAGE_GPU_ONLY, arena.buffer.buffer, arena.buffer.allocation);
 }
 
-void VulkanRenderer::RenderMesh(SingletonRenderState &s, Mesh &mesh, Material &material, TransformComponent transform)
+uint32_t VulkanRenderer::AllocateGeometry(SingletonVulkanRenderState &state, GeometryArena &arena, uint32_t count)
+{
+    uint32_t range = arena.ranges.Allocate(count);
+    if (range != TLSFAllocator::INVALID_ALLOCATION) return range;
+
+    //Packing the ranges together is enough if there's enough free space in total, otherwise grow while we're at it.
+    uint32_t capacity = arena.ranges.Size();
+    if (capacity - arena.ranges.Used() < count) capacity = std::max(capacity * 2, arena.ranges.Used() + count);
+
+    CompactGeometryArena(state, arena, capacity);
+    return arena.ranges.Allocate(count);
+}
+
+void VulkanRenderer::CompactGeometryArena(SingletonVulkanRenderState &state, GeometryArena &arena, uint32_t capacity)
+{
+    //Uploads not submitted yet still write to the old buffer, the copy is ordered after them. Frames in flight may
+    //still be drawing from it, so it's released rather than destroyed.
+    std::vector<TLSFAllocator::Move> moves;
+    arena.ranges.Compact(moves);
+    arena.ranges.Grow(capacity);
+
+    //Everything before the first range that moved stayed where it was, ranges that were next to each other before
+    //are still next to each other and can be copied together.
+    std::vector<VkBufferCopy> copies;
+    uint32_t unmoved = moves.empty() ? arena.ranges.Used() : moves.front().to;
+    if (unmoved > 0) copies.push_back({0, 0, (VkDeviceSize) unmoved * arena.stride});
+
+    for (const TLSFAllocator::Move &move : moves)
+    {
+        VkDeviceSize from = (VkDeviceSize) move.from * arena.stride;
+        VkDeviceSize to = (VkDeviceSize) move.to * arena.stride;
+        VkDeviceSize size = (VkDeviceSize) move.size * arena.stride;
+
+        if (!copies.empty() && copies.back().srcOffset + copies.back().size == from && copies.back().dstOffset + copies.back().size == to)
+        {
+            copies.back().size += size;
+        }
+        else
+        {
+            copies.push_back({from, to, size});
+        }
+    }
+
+    Buffer compacted = {};
+    CreateBuffer(state.allocator, (VkDeviceSize) arena.ranges.Size() * arena.stride, arena.usage, VMA_MEMORY_USAGE_GPU_ONLY, compacted.buffer, compacted.allocation);
+
+    //Frames submitted from now on draw from the new buffer, the upload batch makes the copy visible to them.
+    if (!copies.empty()) state.uploads.CopyBuffer(arena.buffer.buffer, compacted.buffer, copies);
+
+    state.released.buffers.push_back(arena.buffer);
+    arena.buffer = compacted;
+    arena.compactions++;
+
+    Logger::Log("[VulkanRenderer] Compacted a geometry arena to %i elements.", (int) arena.ranges.Size());
+}
+
+void VulkanRenderer::DestroyReleased(SingletonVulkanRenderState &state, ReleasedResources &resources)
+{
+    for (Buffer &buffer : resources.buffers)
+    {
+        vmaDestroyBuffer(state.allocator, buffer.buffer, buffer.allocation);
+    }
+
+    for (Image &image : resources.images)
+    {
+        vkDestroySampler(state.device, image.sampler, nullptr);
+        vkDestroyImageView(state.device, image.view, nullptr);
+        vmaDestroyImage(state.allocator, image.image, image.allocation);
+    }
+
+    for (uint32_t slot : resources.textureSlots)
+    {
+        state.textures.Remove(slot);
+    }
+
+    for (VulkanRenderData *renderData : resources.meshes)
+    {
+        //Freeing an invalid range, from an empty mesh, does nothing.
+        state.vertexArena.ranges.Free(renderData->vertices);
+        state.indexArena.ranges.Free(renderData->indices);
+        delete renderData;
+    }
+
+    if (!resources.meshes.empty()) UpdateGeometryStats(state);
+
+    resources.buffers.clear();
+    resources.images.clear();
+    resources.textureSlots.clear();
+    resources.meshes.clear();
+}
+
+void VulkanRenderer::DestroyAllReleased(SingletonVulkanRenderState &state)
+{
+    for (ReleasedResources &resources : state.releasedInFlight)
+    {
+        DestroyReleased(state, resources);
+    }
+
+    DestroyReleased(state, state.released);
+}
+
+void VulkanRenderer::UpdatePendingUploads(SingletonVulkanRenderState &state)
+{
+    std::vector<PendingUpload> &pending = state.pendingUploads;
+    pending.erase(std::remove_if(pending.begin(), pending.end(), [&state](const PendingUpload &upload)
+    {
+        if (!state.uploads.IsComplete(upload.ticket)) return false;
+
+        *upload.ready = true;
+        return true;
+    }), pending.end());
+}
+
+void VulkanRenderer::UpdateUploadStats(SingletonVulkanRenderState &state)
+{
+    UploadStats &stats = state.uploadStats;
+    stats.batchesInFlight = state.uploads.BatchesInFlight();
+    stats.bytesInFlight = state.uploads.BytesInFlight();
+    stats.bytesWaiting = state.uploads.BytesWaiting();
+    stats.stagingUsedBytes = state.uploads.StagingUsed();
+    stats.stagingCapacityBytes = state.uploads.StagingSize();
+}
+
+void VulkanRenderer::UpdateGeometryStats(SingletonVulkanRenderState &state)
+{
+    GeometryStats &stats = state.geometry;
+    stats = {};
+    stats.buffers = 2;
+
+    for (GeometryArena *arena : {&state.vertexArena, &state.indexArena})
+    {
+        stats.allocations += arena->ranges.AllocationCount();
+        stats.usedBytes += (uint64_t) arena->ranges.Used() * arena->stride;
+        stats.capacityBytes += (uint64_t) arena->ranges.Size() * arena->stride;
+        stats.fragmentation = std::max(stats.fragmentation, arena->ranges.Fragmentation());
+        stats.compactions += arena->compactions;
+    }
+}
+
+void VulkanRenderer::RenderMesh(SingletonRenderState &s, uint32_t chunk, Mesh &mesh, Material &material,
+                                uint32_t firstInstance, uint32_t instanceCount)
 {
     auto & state = (SingletonVulkanRenderState&) s;
+    DrawRecorder &recorder = state.drawRecorders[state.currentFrame][chunk];
+    RenderStats &stats = chunkStats[chunk].stats;
     auto renderData = (VulkanRenderData *) mesh.renderData;
     auto matRenderData = (VulkanMaterialData *) material.renderData;
-    if (renderData == nullptr || matRenderData == nullptr || !renderData->ready) return;
-
-    VkDeviceSize offset = 0;
+    if (renderData == nullptr || matRenderData == nullptr || !renderData->ready || !matRenderData->ready) return;
 
-    PushConstants pushConstants = {};
-    glm::mat4 model = glm::scale(glm::identity<glm::mat4>(), transform.scale);
-    model = glm::toMat4(transform.rotation) * model;
-    model = glm::translate(model, transform.position);
-    pushConstants.mvp = vpMatrix * model;
+    //Every mesh is in the arenas bound when the chunk started, draws only pick their range.
+    stats.meshBindsAvoided++;
 
-    vkCmdPushConstants(state.commandBuffers[state.imageIndex], state.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+    //Instances carry their material, which picks a texture from the table bound when the chunk started.
+    stats.materialBindsAvoided++;
 
-    vkCmdBindVertexBuffers(state.commandBuffers[state.imageIndex], 0, 1, &renderData->vertexBuffer.buffer, &offset);
-    vkCmdBindIndexBuffer(state.commandBuffers[state.imageIndex], renderData->indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
-
-    vkCmdBindDescriptorSets(state.commandBuffers[state.imageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, state.pipelineLayout, 1, 1, &matRenderData->descriptorSet, 0, nullptr);
+    //Until its pipeline is compiled a material is drawn with the fallback.
+    VkPipeline pipeline = state.pipelines->Get(matRenderData->pipeline);
+    if (recorder.boundPipeline != pipeline)
+    {
+        vkCmdBindPipeline(recorder.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        recorder.boundPipeline = pipeline;
+        stats.pipelineBinds++;
+    }
+    else
+    {
+        stats.pipelineBindsAvoided++;
+    }
 
-    vkCmdDrawIndexed(state.commandBuffers[state.imageIndex], mesh.indexCount, 1, 0, 0, 0);
+    uint32_t firstIndex = state.indexArena.ranges.Offset(renderData->indices);
+    auto vertexOffset = (int32_t) state.vertexArena.ranges.Offset(renderData->vertices);
+    vkCmdDrawIndexed(recorder.commandBuffer, mesh.indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    stats.draws++;
+    stats.instances += instanceCount;
 }
 
 void VulkanRenderer::EndFrame(SingletonRenderState &s)
@@ -1213,10 +1521,33 @@ void VulkanRenderer::EndFrame(SingletonRenderState &s)
     //Draw ImGUI, and finish command buffer recording.
     ImGui::Render();
     state.imGuiDrawData = ImGui::GetDrawData();
-    if (state.imGuiDrawData != nullptr) ImGui_ImplVulkan_RenderDrawData(state.imGuiDrawData, state.commandBuffers[state.imageIndex]);
 
+    //ImGui gets the recorder after the last chunk, since the render pass only takes secondary command buffers.
+    DrawRecorder &imGuiRecorder = state.drawRecorders[state.currentFrame][state.drawChunkCount];
+    StartSecondaryCommandBuffer(state, imGuiRecorder);
+    if (state.imGuiDrawData != nullptr) ImGui_ImplVulkan_RenderDrawData(state.imGuiDrawData, imGuiRecorder.commandBuffer);
+
+    if (vkEndCommandBuffer(imGuiRecorder.commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to record command buffer.");
+    }
+
+    std::vector<VkCommandBuffer> &secondaryCommandBuffers = state.secondaryCommandBuffers;
+    secondaryCommandBuffers.clear();
+    for (uint32_t i = 0; i <= state.drawChunkCount; i++)
+    {
+        secondaryCommandBuffers.push_back(state.drawRecorders[state.currentFrame][i].commandBuffer);
+    }
+
+    //Culling has to finish before the draws that read its results, and compute can't be dispatched in a render pass.
+    if (state.indirectFrame) state.culling.Record(state.commandBuffers[state.imageIndex], ExtractFrustum(vpMatrix));
+
+    StartRenderPass(state);
+    vkCmdExecuteCommands(state.commandBuffers[state.imageIndex], static_cast<uint32_t>(secondaryCommandBuffers.size()), secondaryCommandBuffers.data());
     EndCommandBuffer(state.commandBuffers[state.imageIndex]);
 
+    state.frameData.Flush();
+
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -1239,6 +1570,10 @@ void VulkanRenderer::EndFrame(SingletonRenderState &s)
         throw std::runtime_error("Failed to submit draw command buffer.");
     }
 
+    //Anything released up to now may be used by this submission at the latest. This frame's list was emptied when
+    //its fence was waited on in StartFrame, so swapping keeps the capacity of both.
+    std::swap(state.releasedInFlight[state.currentFrame], state.released);
+
     VkPresentInfoKHR presentInfo = {};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
@@ -1276,7 +1611,12 @@ void VulkanRenderer::Tick(World &world)
 {
 }
 
-SystemRegistrar VulkanRenderer::registrar(new VulkanRenderer());
+VulkanRenderer::VulkanRenderer()
+{
+    RequiresWindow = true;
+}
+
+SystemRegistrar VulkanRenderer::registrar(&CreateSystem<VulkanRenderer>);
 
 void VulkanRenderer::Init(World &world)
 {
@@ -1289,7 +1629,16 @@ void VulkanRenderer::Init(World &world)
     registry->on_destroy<SingletonVulkanRenderState>().connect<&VulkanRenderer::OnRendererDestruction>(this);
 
     auto entity = registry->create();
+    registry->emplace<SingletonEntityComponent>(entity);
     auto &state = registry->emplace<SingletonVulkanRenderState>(entity);
+    state.gpuCulling = Relic::Instance()->UsesGpuCulling();
+
+    //Quietly culling on the CPU instead would hide that what was asked for doesn't work.
+    if (state.gpuCulling && !state.indirectSupported)
+    {
+        throw std::runtime_error("[VulkanRenderer] GPU culling was requested with --gpu-culling but is unavailable.");
+    }
+
     //Set it into the registry as a context variable
     registry->set<SingletonRenderState *>(&state);
 }
@@ -1312,18 +1661,20 @@ void VulkanRenderer::OnRendererCreation(entt::registry &registry, entt::entity e
     state.debugMessenger = {};
     state.imGuiDrawData = nullptr;
 
+    auto start = std::chrono::high_resolution_clock::now();
+
     int vulkanSupported = glfwVulkanSupported();
     if (vulkanSupported == GLFW_FALSE)
     {
         Logger::Log("Vulkan is not supported.");
-        exit(0);
+        exit(1);
     }
 
     window->SetUserPointer(&state);
     window->RegisterWindowSizeChangedCallback(WindowResizedCallback);
 
     //Try to create an state.instance, otherwise exit.
-    if (!CreateInstance(state)) exit(0);
+    if (!CreateInstance(state)) exit(1);
     InitialiseDebugMessenger(state);
 
     CreateSurface(state);
@@ -1339,6 +1690,19 @@ void VulkanRenderer::OnRendererCreation(entt::registry &registry, entt::entity e
     CreateLogicalDevice(state);
 
     CreateAllocator(state);
+    state.pipelineCache.Create(state.device, state.physicalDevice, PIPELINE_CACHE_PATH);
+    state.pipelines = std::make_unique<PipelineLibrary>();
+    state.pipelines->Create(state.device, state.pipelineCache.Handle());
+    auto attributeDescriptions = GetAttributeDescriptions();
+    state.pipelines->RegisterVertexLayout({GetVertexInputBindingDescription(), GetInstanceInputBindingDescription()}, {attributeDescriptions.begin(), attributeDescriptions.end()});
+    //The first pipeline requested is the fallback, the default description is what every material started out with.
+    state.pipelines->Request(PipelineDescription());
+    if (state.indirectSupported)
+    {
+        //Only the vertices come from a vertex buffer, the rest of an instance is looked up in the objects buffer.
+        state.indirectVertexLayout = state.pipelines->RegisterVertexLayout({GetVertexInputBindingDescription()}, {attributeDescriptions.begin(), attributeDescriptions.begin() + 3});
+    }
+    state.textures.Create(state.device, state.physicalDevice, MAX_TEXTURES);
     CreateSwapChain(state);
     CreateSwapchainImageViews(state);
     CreateRenderPass(state);
@@ -1347,14 +1711,40 @@ void VulkanRenderer::OnRendererCreation(entt::registry &registry, entt::entity e
     CreateDepthResources(state);
     CreateFrameBuffers(state);
     CreateCommandPool(state);
-    CreateUniformBuffers(state);
-    CreateDescriptorSetPool(state);
-    CreateDescriptorSets(state);
+    state.uploads.Create(state.device, state.allocator, FindQueueFamily(state).graphicsFamily.value(), state.graphicsQueue, STAGING_SIZE, UPLOAD_BUDGET);
+    CreateFrameData(state);
+    CreateGeometryArena(state, state.vertexArena, sizeof(Vertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, GEOMETRY_ARENA_VERTICES);
+    CreateGeometryArena(state, state.indexArena, sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, GEOMETRY_ARENA_INDICES);
+    CreateImGuiDescriptorPool(state);
+    CreateDescriptorAllocators(state);
+
+    if (state.indirectSupported)
+    {
+        //Culling on the GPU is optional, a missing shader turns it off unless it was asked for. Materials request
+        //pipelines with the indirect vertex shader later on, so that has to be there as well.
+        try
+        {
+            ReadFile(INDIRECT_VERTEX_SHADER_PATH);
+            state.culling.Create(state.device, state.allocator, state.pipelineCache.Handle(), state.MAX_FRAMES_IN_FLIGHT, CULLING_SHADER_PATH);
+        }
+        catch (const std::exception &exception)
+        {
+            Logger::Log("[VulkanRenderer] [WRN] GPU culling is unavailable: %s", exception.what());
+            state.culling.Destroy();
+            state.indirectSupported = false;
+        }
+    }
 
     CreateCommandBuffers(state, false);
     CreateSynchronisationObjects(state);
 
     SetupImGui(state);
+
+    //Without a cache every pipeline was just compiled from scratch, keep the result even if we don't shut down cleanly.
+    if (!state.pipelineCache.Loaded()) state.pipelineCache.Save();
+
+    Logger::Log("[VulkanRenderer] Started in %sms (%s pipeline cache).", std::to_string(Benchmark::SecondsSince(start) * 1000.0).c_str(),
+                state.pipelineCache.Loaded() ? "warm" : "cold");
 }
 
 void VulkanRenderer::OnRendererDestruction(entt::registry &registry, entt::entity entity)
@@ -1367,10 +1757,20 @@ void VulkanRenderer::OnRendererDestruction(entt::registry &registry, entt::entit
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplGlfw_Shutdown();
 
+    DestroyAllReleased(state);
     CleanupSwapchain(state);
 
+    state.frameSets.Destroy();
+    for (DescriptorAllocator &allocator : state.transientDescriptors) allocator.Destroy();
     vkDestroyDescriptorSetLayout(state.device, state.descriptorSetLayout, nullptr);
-
+    vkDestroyDescriptorSetLayout(state.device, state.objectSetLayout, nullptr);
+    state.textures.Destroy();
+
+    if (state.indirectSupported) state.culling.Destroy();
+    state.frameData.Destroy();
+    state.uploads.Destroy();
+    vmaDestroyBuffer(state.allocator, state.vertexArena.buffer.buffer, state.vertexArena.buffer.allocation);
+    vmaDestroyBuffer(state.allocator, state.indexArena.buffer.buffer, state.indexArena.buffer.allocation);
     vmaDestroyAllocator(state.allocator);
 
     for (size_t i = 0; i < state.MAX_FRAMES_IN_FLIGHT; i++)
@@ -1380,12 +1780,20 @@ void VulkanRenderer::OnRendererDestruction(entt::registry &registry, entt::entit
         vkDestroyFence(state.device, state.inFlightFences[i], nullptr);
     }
 
+    for (auto &recorders : state.drawRecorders)
+    {
+        for (DrawRecorder &recorder : recorders) vkDestroyCommandPool(state.device, recorder.pool, nullptr);
+    }
+
     vkDestroyCommandPool(state.device, state.commandPool, nullptr);
 
     delete state.supportedExtensions;
     delete state.supportedValidationLayers;
     DestroyDebugMessenger(state.instance, state.debugMessenger, nullptr);
 
+    state.pipelines->Destroy();
+    state.pipelines.reset();
+    state.pipelineCache.Destroy();
     vkDestroyDevice(state.device, nullptr);
     vkDestroySurfaceKHR(state.instance, state.surface, nullptr);
     vkDestroyInstance(state.instance, nullptr);
@@ -1393,11 +1801,23 @@ void VulkanRenderer::OnRendererDestruction(entt::registry &registry, entt::entit
 
 void VulkanRenderer::RegisterMaterial(Material *material)
 {
+    auto * state = (SingletonVulkanRenderState*) Relic::Instance()->GetPrimaryWorld()->Registry()->ctx<SingletonRenderState*>();
+
+    //Check for room before creating anything, nothing has to be undone then.
+    if (state->freeMaterials.empty() && state->materialTable.size() == MAX_MATERIALS)
+    {
+        throw std::runtime_error("Material table is full.");
+    }
+
+    if (state->textures.Count() == state->textures.Capacity())
+    {
+        throw std::runtime_error("Texture table is full.");
+    }
+
     Renderer::RegisterMaterial(material);
     auto *data = new VulkanMaterialData();
 
     //Create image and relevant descriptor set.
-    auto * state = (SingletonVulkanRenderState*) Relic::Instance()->GetPrimaryWorld()->Registry()->ctx<SingletonRenderState*>();
 
     VkFormat imageFormat = VK_FORMAT_R8G8B8A8_SRGB;
     CreateImage(state->allocator, data->texture.image, data->texture.allocation, VK_IMAGE_TYPE_2D, imageFormat, material->texture->width, material->texture->height, 1, 1, 1, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
@@ -1409,39 +1829,77 @@ void VulkanRenderer::RegisterMaterial(Material *material)
             1
     };
 
-    WriteToImage(state->allocator, data->texture.image, imageFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, material->texture->data, material->texture->dataSize, extent, state->commandPool, state->device, state->graphicsQueue);
+    //Meshes using the material aren't drawn until the texture has arrived.
+    uint64_t ticket = state->uploads.WriteImage(data->texture.image, extent, material->texture->data, material->texture->dataSize, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    data->ready = false;
+    state->pendingUploads.push_back({ticket, &data->ready});
 
     CreateSampler(state->device, data->texture.sampler);
+    data->textureSlot = state->textures.Add(data->texture.view, data->texture.sampler);
 
-    VkDescriptorSetAllocateInfo allocateInfo = {};
-    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocateInfo.descriptorPool = state->descriptorPool;
-    allocateInfo.descriptorSetCount = 1;
-    allocateInfo.pSetLayouts = &state->materialDescriptorSetLayout;
-
-    if(vkAllocateDescriptorSets(state->device, &allocateInfo, &data->descriptorSet) != VK_SUCCESS)
+    //Frames copy the table when they start, so a slot can be reused as soon as its material is gone.
+    if (state->freeMaterials.empty())
     {
-        throw std::runtime_error("failed to create descriptor set for material.");
+        state->freeMaterials.push_back((uint32_t) state->materialTable.size());
+        state->materialTable.emplace_back();
     }
 
-    VkDescriptorImageInfo info = {};
-    info.sampler = data->texture.sampler;
-    info.imageView = data->texture.view;
-    info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    VkWriteDescriptorSet descriptorWrite = {};
-    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrite.dstSet = data->descriptorSet;
-    descriptorWrite.dstBinding = 1;
-    descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.pImageInfo = &info;
-
-    vkUpdateDescriptorSets(state->device, 1, &descriptorWrite, 0, nullptr);
+    material->index = state->freeMaterials.back();
+    state->freeMaterials.pop_back();
+    state->materialTable[material->index] = data;
+
+    PipelineDescription description;
+    description.cullMode = material->doubleSided ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
+    description.alphaBlend = material->alphaBlend;
+    description.depthWrite = !material->alphaBlend;
+    data->pipeline = state->pipelines->Request(description);
+    material->pipeline = data->pipeline;
+
+    //The same state for culling on the GPU, with instances read from the objects buffer. Materials that end up with
+    //the same pipeline share a draw list.
+    data->drawList = NO_DRAW_LIST;
+    if (state->indirectSupported)
+    {
+        PipelineDescription indirectDescription = description;
+        indirectDescription.vertexShader = INDIRECT_VERTEX_SHADER_PATH;
+        indirectDescription.vertexLayout = state->indirectVertexLayout;
+        uint32_t indirectPipeline = state->pipelines->Request(indirectDescription);
+
+        std::vector<uint32_t> &lists = state->drawListPipelines;
+        auto list = std::find(lists.begin(), lists.end(), indirectPipeline);
+        if (list == lists.end()) list = lists.insert(lists.end(), indirectPipeline);
+        data->drawList = (uint32_t) (list - lists.begin());
+    }
 
     material->renderData = data;
 }
 
 
+void VulkanRenderer::UnregisterMaterial(Material *material)
+{
+    Renderer::UnregisterMaterial(material);
+
+    auto * state = (SingletonVulkanRenderState*) Relic::Instance()->GetPrimaryWorld()->Registry()->ctx<SingletonRenderState*>();
+    auto *data = (VulkanMaterialData *) material->renderData;
+    if (data == nullptr) return;
+
+    //A texture that is still uploading may not even be recorded yet, and the image has to outlive that.
+    std::vector<PendingUpload> &pending = state->pendingUploads;
+    auto uploading = std::remove_if(pending.begin(), pending.end(), [data](const PendingUpload &upload)
+    {
+        return upload.ready == &data->ready;
+    });
+    if (uploading != pending.end()) state->uploads.Flush();
+    pending.erase(uploading, pending.end());
+
+    //Frames in flight may still sample the texture.
+    state->released.images.push_back(data->texture);
+    state->released.textureSlots.push_back(data->textureSlot);
+    state->materialTable[material->index] = nullptr;
+    state->freeMaterials.push_back(material->index);
+
+    delete data;
+    material->renderData = nullptr;
+}
+
 #pragma clang diagnostic pop
\ No newline at end of file
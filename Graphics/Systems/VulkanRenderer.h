@@ -11,12 +11,14 @@
 #include "Graphics/vk_mem_alloc.h"
 #include <optional>
 #include <vector>
+#include <atomic>
 #include "Graphics/OpenFBX/ofbx.h"
 #include "Graphics/Model.h"
 #include <glm/glm.hpp>
 #include <Libraries/IMGUI/imgui.h>
 #include <Core/Components/TransformComponent.h>
 #include <Graphics/Components/SingletonVulkanRenderState.h>
+#include <Graphics/PipelineLibrary.h>
 
 struct QueueFamilyIndices
 {
@@ -39,19 +41,55 @@ struct SwapChainSupportDetails
 class VulkanRenderer : public Renderer
 {
 public:
+    VulkanRenderer();
+
     void Init(World &world) override;
 
     void Shutdown(World &world) override;
 
     void RegisterMaterial(Material *material) override;
 
+    void UnregisterMaterial(Material *material) override;
+
+    /// Number of errors the validation layers have reported so far, 0 when validation is off.
+    static uint32_t ValidationErrors();
+
 private:
     static SystemRegistrar registrar;
 
     /// Create a Vulkan Instance
     bool CreateInstance(SingletonVulkanRenderState &state);
 
-    void CreateUniformBuffers(SingletonVulkanRenderState &state);
+    void CreateFrameData(SingletonVulkanRenderState &state);
+
+    void CreateGeometryArena(SingletonVulkanRenderState &state, GeometryArena &arena, uint32_t stride,
+                             VkBufferUsageFlags usage, uint32_t capacity);
+
+    /// Get a range of an arena, compacting or growing it first if there's no free range large enough.
+    /// \param count Number of vertices or indices.
+    /// \return The range, to be used with arena.ranges.
+    uint32_t AllocateGeometry(SingletonVulkanRenderState &state, GeometryArena &arena, uint32_t count);
+
+    /// Move the data of an arena to a new buffer, packed together at its start. The copy goes out with the uploads,
+    /// ahead of the next frame, without waiting for the GPU.
+    /// \param capacity Size of the new buffer in elements, at least what's in use.
+    void CompactGeometryArena(SingletonVulkanRenderState &state, GeometryArena &arena, uint32_t capacity);
+
+    /// Destroy released resources, once the GPU is done with them.
+    void DestroyReleased(SingletonVulkanRenderState &state, ReleasedResources &resources);
+
+    /// Destroy every released resource, for when the device is idle.
+    void DestroyAllReleased(SingletonVulkanRenderState &state);
+
+    /// Mark meshes and materials whose uploads have completed as ready.
+    void UpdatePendingUploads(SingletonVulkanRenderState &state);
+
+    void UpdateGeometryStats(SingletonVulkanRenderState &state);
+
+    void UpdateUploadStats(SingletonVulkanRenderState &state);
+
+    /// Get the descriptor set of the current frame's data buffer, once the frame's allocations are done.
+    void UpdateFrameSet(SingletonVulkanRenderState &state);
 
     /// Check whether a vulkan instance extension is supported.
     /// \param extensionName Name of the extension to query.
@@ -79,6 +117,9 @@ private:
                                                              const VkDebugUtilsMessengerCallbackDataEXT *callbackData,
                                                              void *userData);
 
+    //Error messages reported by validation since startup, shared by every renderer since the callback is static.
+    static std::atomic<uint32_t> validationErrors;
+
     /// Attach the debug messenger to vulkan.
     void InitialiseDebugMessenger(SingletonVulkanRenderState &state);
 
@@ -156,9 +197,9 @@ private:
 
     void CreateCommandPool(SingletonVulkanRenderState &state);
 
-    void CreateDescriptorSetPool(SingletonVulkanRenderState &state);
+    void CreateImGuiDescriptorPool(SingletonVulkanRenderState &state);
 
-    void CreateDescriptorSets(SingletonVulkanRenderState &state);
+    void CreateDescriptorAllocators(SingletonVulkanRenderState &state);
 
     void CreateCommandBuffers(SingletonVulkanRenderState &state, bool isRecreate);
 
@@ -170,33 +211,73 @@ private:
 
     void CreateAllocator(SingletonVulkanRenderState &state);
 
-    void UpdateUniformBuffers(uint32_t currentImage);
+    void UpdateUniformBuffers(SingletonVulkanRenderState &state);
 
     void SetupImGui(SingletonVulkanRenderState &state);
 
     void StartCommandBuffer(SingletonVulkanRenderState &state);
 
+    /// Begin the render pass of the current frame, once everything recorded outside of it has been.
+    void StartRenderPass(SingletonVulkanRenderState &state);
+
+    /// Make sure the current frame in flight has at least count recorders.
+    void CreateDrawRecorders(SingletonVulkanRenderState &state, uint32_t count);
+
+    /// Begin a secondary command buffer that continues the render pass of the current frame.
+    void StartSecondaryCommandBuffer(SingletonVulkanRenderState &state, DrawRecorder &recorder);
+
     void EndCommandBuffer(VkCommandBuffer &commandBuffer);
 
-    struct UniformBufferObject
+    struct CameraData
     {
-        glm::mat4 model;
-        glm::mat4 view;
-        glm::mat4 proj;
+        glm::mat4 viewProjection;
     };
 
-    struct PushConstants
-    {
-        glm::mat4 mvp;
-    };
+    //Shaders of the GPU culling path, see IndirectCulling.
+    static constexpr const char *CULLING_SHADER_PATH = RELIC_SHADER_DIR "cull.spv";
+    static constexpr const char *INDIRECT_VERTEX_SHADER_PATH = RELIC_SHADER_DIR "indirect_vert.spv";
+
+    //File the pipeline cache is kept in, next to the shaders it was built from.
+    static constexpr const char *PIPELINE_CACHE_PATH = RELIC_SHADER_DIR "PipelineCache.bin";
+
+    //Initial size of the buffer for each frame's data, enough for the camera, materials and about 15k instances.
+    static constexpr VkDeviceSize FRAME_DATA_SIZE = 1024 * 1024;
+
+    //Sets the first pool of each frame's transient descriptor allocator has room for.
+    static constexpr uint32_t TRANSIENT_DESCRIPTOR_SETS = 16;
+
+    //Slots in the texture table, and the number of materials the material table has room for.
+    static constexpr uint32_t MAX_TEXTURES = 4096;
+    static constexpr uint32_t MAX_MATERIALS = 4096;
+
+    //Initial number of vertices and indices the geometry arenas have room for.
+    static constexpr uint32_t GEOMETRY_ARENA_VERTICES = 1024 * 1024;
+    static constexpr uint32_t GEOMETRY_ARENA_INDICES = 3 * 1024 * 1024;
+
+    //Size of the ring uploads are staged in, and how much of it a frame's uploads take at most.
+    static constexpr VkDeviceSize STAGING_SIZE = 64 * 1024 * 1024;
+    static constexpr VkDeviceSize UPLOAD_BUDGET = 16 * 1024 * 1024;
 public:
     void Tick(World &world) override;
 
-    void RenderMesh(SingletonRenderState &s, Mesh &mesh, Material &material, TransformComponent transform) override;
+    InstanceData *AllocateInstances(SingletonRenderState &s, uint32_t count) override;
+
+    void StartChunk(SingletonRenderState &s, uint32_t chunk) override;
+
+    void RenderMesh(SingletonRenderState &s, uint32_t chunk, Mesh &mesh, Material &material, uint32_t firstInstance,
+                    uint32_t instanceCount) override;
+
+    void EndChunk(SingletonRenderState &s, uint32_t chunk) override;
+
+    bool SupportsIndirect(SingletonRenderState &s) override;
+
+    ObjectData *AllocateObjects(SingletonRenderState &s, uint32_t count) override;
+
+    void RenderIndirect(SingletonRenderState &s, uint32_t chunk, uint32_t objectCount) override;
 
     void EndFrame(SingletonRenderState &state) override;
 
-    void StartFrame(SingletonRenderState &state) override;
+    void StartFrame(SingletonRenderState &state, uint32_t chunkCount) override;
 
     void PrepareMesh(SingletonRenderState &state, Mesh &mesh) override;
 
@@ -0,0 +1,183 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "TextureTable.h"
+#include <algorithm>
+#include <stdexcept>
+#include <Debugging/Logger.h>
+
+bool TextureTable::Supported(VkPhysicalDevice physicalDevice)
+{
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing = {};
+    indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &indexing;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    return indexing.runtimeDescriptorArray && indexing.shaderSampledImageArrayNonUniformIndexing &&
+           indexing.descriptorBindingPartiallyBound && indexing.descriptorBindingSampledImageUpdateAfterBind &&
+           indexing.descriptorBindingUpdateUnusedWhilePending;
+}
+
+VkPhysicalDeviceDescriptorIndexingFeaturesEXT TextureTable::RequiredFeatures()
+{
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing = {};
+    indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    indexing.runtimeDescriptorArray = VK_TRUE;
+    indexing.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    indexing.descriptorBindingPartiallyBound = VK_TRUE;
+    indexing.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    indexing.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    return indexing;
+}
+
+void TextureTable::Create(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t capacity)
+{
+    this->device = device;
+
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT limits = {};
+    limits.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+    VkPhysicalDeviceProperties2 properties = {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &limits;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+    //A combined image sampler counts as both a sampler and a sampled image.
+    this->capacity = std::min({capacity,
+                               limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+                               limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                               limits.maxDescriptorSetUpdateAfterBindSamplers,
+                               limits.maxDescriptorSetUpdateAfterBindSampledImages});
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = this->capacity;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    //Unused slots hold nothing, and slots are filled while frames using the table are still in flight.
+    VkDescriptorBindingFlagsEXT bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+                                               VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+                                               VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo = {};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create texture table layout.");
+    }
+
+    VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, this->capacity};
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create texture table pool.");
+    }
+
+    VkDescriptorSetAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = pool;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &layout;
+
+    if (vkAllocateDescriptorSets(device, &allocateInfo, &set) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate texture table.");
+    }
+
+    used = 0;
+    freeSlots.clear();
+    Logger::Log("[TextureTable] Created with %i slots.", (int) this->capacity);
+}
+
+void TextureTable::Destroy()
+{
+    //Destroying the pool frees the set.
+    vkDestroyDescriptorPool(device, pool, nullptr);
+    vkDestroyDescriptorSetLayout(device, layout, nullptr);
+    pool = VK_NULL_HANDLE;
+    layout = VK_NULL_HANDLE;
+    set = VK_NULL_HANDLE;
+}
+
+uint32_t TextureTable::Add(VkImageView view, VkSampler sampler)
+{
+    uint32_t slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else if (used < capacity)
+    {
+        slot = used++;
+    }
+    else
+    {
+        throw std::runtime_error("Texture table is full.");
+    }
+
+    VkDescriptorImageInfo info = {};
+    info.sampler = sampler;
+    info.imageView = view;
+    info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = 0;
+    write.dstArrayElement = slot;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo = &info;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    return slot;
+}
+
+void TextureTable::Remove(uint32_t slot)
+{
+    //The descriptor is left as it is, nothing reads it until the slot is written again.
+    freeSlots.push_back(slot);
+}
+
+VkDescriptorSetLayout TextureTable::Layout() const
+{
+    return layout;
+}
+
+VkDescriptorSet TextureTable::Set() const
+{
+    return set;
+}
+
+uint32_t TextureTable::Capacity() const
+{
+    return capacity;
+}
+
+uint32_t TextureTable::Count() const
+{
+    return used - static_cast<uint32_t>(freeSlots.size());
+}
@@ -0,0 +1,60 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_TEXTURETABLE_H
+#define RELIC_TEXTURETABLE_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+/// Every resident texture in one descriptor array, using VK_EXT_descriptor_indexing. Shaders pick a texture by its
+/// slot, so the whole scene is drawn with the table bound once instead of a descriptor set per material.
+///
+/// Slots are written while the set is bound in frames still in flight. That's fine for slots those frames don't use,
+/// so a slot may only be removed, and reused, once no frame in flight can read it any more.
+class TextureTable
+{
+public:
+    /// Whether a device has the descriptor indexing features the table relies on.
+    static bool Supported(VkPhysicalDevice physicalDevice);
+
+    /// The features to enable on the device, to be chained into VkDeviceCreateInfo.
+    static VkPhysicalDeviceDescriptorIndexingFeaturesEXT RequiredFeatures();
+
+    /// \param capacity Number of slots, lowered to what the device allows.
+    void Create(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t capacity);
+
+    void Destroy();
+
+    /// Put a texture in a free slot.
+    /// \return The slot, for shaders to index the table with.
+    uint32_t Add(VkImageView view, VkSampler sampler);
+
+    /// Free a slot. No frame in flight may still read it.
+    void Remove(uint32_t slot);
+
+    /// Layout of the set, a single array of combined image samplers at binding 0.
+    [[nodiscard]] VkDescriptorSetLayout Layout() const;
+
+    [[nodiscard]] VkDescriptorSet Set() const;
+
+    [[nodiscard]] uint32_t Capacity() const;
+
+    /// Number of slots in use.
+    [[nodiscard]] uint32_t Count() const;
+
+private:
+    VkDevice device = VK_NULL_HANDLE;
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    uint32_t capacity = 0;
+
+    //Slots below this have been handed out at some point, the free ones among them are in freeSlots.
+    uint32_t used = 0;
+    std::vector<uint32_t> freeSlots;
+};
+
+#endif //RELIC_TEXTURETABLE_H
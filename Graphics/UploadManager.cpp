@@ -0,0 +1,443 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "UploadManager.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+static void CreateStagingBuffer(VmaAllocator allocator, VkDeviceSize size, Buffer &buffer, void *&data)
+{
+    VkBufferCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    createInfo.size = size;
+    createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocationCreateInfo = {};
+    allocationCreateInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo allocationInfo = {};
+    if (vmaCreateBuffer(allocator, &createInfo, &allocationCreateInfo, &buffer.buffer, &buffer.allocation,
+                        &allocationInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create staging buffer.");
+    }
+
+    data = allocationInfo.pMappedData;
+}
+
+void UploadManager::Create(VkDevice device, VmaAllocator allocator, uint32_t queueFamily, VkQueue queue,
+                           VkDeviceSize stagingSize, VkDeviceSize frameBudget)
+{
+    this->device = device;
+    this->allocator = allocator;
+    this->queue = queue;
+    this->frameBudget = frameBudget;
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamily;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create upload command pool.");
+    }
+
+    //A whole number of aligned allocations, so wrapping around keeps the alignment.
+    this->stagingSize = (stagingSize + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    void *data = nullptr;
+    CreateStagingBuffer(allocator, this->stagingSize, staging, data);
+    stagingData = (uint8_t *) data;
+    stagingHead = 0;
+    stagingTail = 0;
+
+    frameBytes = 0;
+    nextTicket = 1;
+    completedTicket = 0;
+}
+
+void UploadManager::Destroy()
+{
+    while (!inFlight.empty())
+    {
+        WaitOldest();
+    }
+
+    if (isRecording)
+    {
+        vkEndCommandBuffer(recording.commandBuffer);
+        Retire(recording);
+        isRecording = false;
+    }
+
+    for (Batch &batch : freeBatches)
+    {
+        vkDestroyFence(device, batch.fence, nullptr);
+    }
+
+    freeBatches.clear();
+    waiting.clear();
+    waitingBytes = 0;
+
+    vkDestroyCommandPool(device, commandPool, nullptr);
+    vmaDestroyBuffer(allocator, staging.buffer, staging.allocation);
+    stagingData = nullptr;
+}
+
+uint64_t UploadManager::WriteBuffer(VkBuffer buffer, VkDeviceSize offset, const void *data, VkDeviceSize size)
+{
+    Write write;
+    write.ticket = nextTicket++;
+    write.buffer = buffer;
+    write.offset = offset;
+    return Enqueue(write, data, size);
+}
+
+uint64_t UploadManager::WriteImage(VkImage image, VkExtent3D extent, const void *data, VkDeviceSize size,
+                                   VkImageLayout finalLayout)
+{
+    Write write;
+    write.ticket = nextTicket++;
+    write.image = image;
+    write.extent = extent;
+    write.finalLayout = finalLayout;
+    return Enqueue(write, data, size);
+}
+
+uint64_t UploadManager::CopyBuffer(VkBuffer source, VkBuffer destination, const std::vector<VkBufferCopy> &regions)
+{
+    uint64_t ticket = nextTicket++;
+
+    //The copy has to see everything written to the source before it.
+    RecordWaiting(true);
+    Batch &batch = Recording();
+
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1,
+                         &barrier, 0, nullptr, 0, nullptr);
+    vkCmdCopyBuffer(batch.commandBuffer, source, destination, static_cast<uint32_t>(regions.size()), regions.data());
+
+    batch.lastTicket = ticket;
+    SubmitRecording();
+    frameBytes = 0;
+    return ticket;
+}
+
+void UploadManager::Submit()
+{
+    //Writes that had to wait go first, as far as the budget and the ring allow.
+    RecordWaiting(false);
+    SubmitRecording();
+    frameBytes = 0;
+}
+
+void UploadManager::Update()
+{
+    while (!inFlight.empty() && vkGetFenceStatus(device, inFlight.front().fence) == VK_SUCCESS)
+    {
+        completedTicket = std::max(completedTicket, inFlight.front().lastTicket);
+        Retire(inFlight.front());
+        inFlight.pop_front();
+    }
+}
+
+void UploadManager::Flush()
+{
+    RecordWaiting(true);
+    SubmitRecording();
+    frameBytes = 0;
+
+    while (!inFlight.empty())
+    {
+        WaitOldest();
+    }
+}
+
+bool UploadManager::IsComplete(uint64_t ticket) const
+{
+    return ticket <= completedTicket;
+}
+
+uint32_t UploadManager::BatchesInFlight() const
+{
+    return static_cast<uint32_t>(inFlight.size());
+}
+
+VkDeviceSize UploadManager::BytesInFlight() const
+{
+    VkDeviceSize bytes = isRecording ? recording.bytes : 0;
+    for (const Batch &batch : inFlight) bytes += batch.bytes;
+    return bytes;
+}
+
+VkDeviceSize UploadManager::BytesWaiting() const
+{
+    return waitingBytes;
+}
+
+VkDeviceSize UploadManager::StagingUsed() const
+{
+    return stagingHead - stagingTail;
+}
+
+VkDeviceSize UploadManager::StagingSize() const
+{
+    return stagingSize;
+}
+
+uint64_t UploadManager::Enqueue(Write &write, const void *data, VkDeviceSize size)
+{
+    uint64_t ticket = write.ticket;
+
+    //Anything already waiting has to go first, so writes to the same place land in the order they were made.
+    if (waiting.empty() && WithinBudget(size) && Record(write, data, size)) return ticket;
+
+    auto bytes = (const uint8_t *) data;
+    write.data.assign(bytes, bytes + size);
+    waitingBytes += size;
+    waiting.push_back(std::move(write));
+    return ticket;
+}
+
+bool UploadManager::Record(const Write &write, const void *data, VkDeviceSize size)
+{
+    VkBuffer source = staging.buffer;
+    VkDeviceSize sourceOffset = 0;
+
+    if (size > stagingSize)
+    {
+        Buffer dedicated = {};
+        void *mapped = nullptr;
+        CreateStagingBuffer(allocator, size, dedicated, mapped);
+        memcpy(mapped, data, size);
+        vmaFlushAllocation(allocator, dedicated.allocation, 0, size);
+
+        Recording().stagingBuffers.push_back(dedicated);
+        source = dedicated.buffer;
+    }
+    else
+    {
+        if (!AllocateStaging(size, sourceOffset)) return false;
+
+        memcpy(stagingData + sourceOffset, data, size);
+        vmaFlushAllocation(allocator, staging.allocation, sourceOffset, size);
+    }
+
+    Batch &batch = Recording();
+
+    if (write.image == VK_NULL_HANDLE)
+    {
+        VkBufferCopy copy = {};
+        copy.srcOffset = sourceOffset;
+        copy.dstOffset = write.offset;
+        copy.size = size;
+        vkCmdCopyBuffer(batch.commandBuffer, source, write.buffer, 1, &copy);
+    }
+    else
+    {
+        //The old contents are replaced entirely, so the image can come from an undefined layout.
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = write.image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy region = {};
+        region.bufferOffset = sourceOffset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = write.extent;
+
+        vkCmdCopyBufferToImage(batch.commandBuffer, source, write.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                               &region);
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = write.finalLayout;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    batch.lastTicket = write.ticket;
+    batch.stagingEnd = stagingHead;
+    batch.bytes += size;
+    frameBytes += size;
+    return true;
+}
+
+void UploadManager::RecordWaiting(bool force)
+{
+    while (!waiting.empty())
+    {
+        const Write &write = waiting.front();
+        VkDeviceSize size = write.data.size();
+        if (!force && !WithinBudget(size)) return;
+
+        if (!Record(write, write.data.data(), size))
+        {
+            if (!force) return;
+
+            //Whatever holds the ring is either being recorded or in flight, wait for the oldest of it.
+            if (inFlight.empty()) SubmitRecording();
+            WaitOldest();
+            continue;
+        }
+
+        waitingBytes -= size;
+        waiting.pop_front();
+    }
+}
+
+bool UploadManager::WithinBudget(VkDeviceSize size) const
+{
+    //A write larger than the budget still gets a submission to itself, rather than waiting forever.
+    return frameBytes == 0 || frameBytes + size <= frameBudget;
+}
+
+bool UploadManager::AllocateStaging(VkDeviceSize size, VkDeviceSize &offset)
+{
+    //Nothing uses an empty ring, so it can start over from the beginning, which leaves the most contiguous space.
+    if (stagingHead == stagingTail)
+    {
+        stagingHead = (stagingHead + stagingSize - 1) / stagingSize * stagingSize;
+        stagingTail = stagingHead;
+    }
+
+    VkDeviceSize start = (stagingHead + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    VkDeviceSize position = start % stagingSize;
+
+    //Allocations don't wrap around, the end of the ring is skipped instead.
+    if (position + size > stagingSize)
+    {
+        start += stagingSize - position;
+        position = 0;
+    }
+
+    if (start + size - stagingTail > stagingSize) return false;
+
+    stagingHead = start + size;
+    offset = position;
+    return true;
+}
+
+UploadManager::Batch &UploadManager::Recording()
+{
+    if (isRecording) return recording;
+
+    if (!freeBatches.empty())
+    {
+        recording = std::move(freeBatches.back());
+        freeBatches.pop_back();
+
+        vkResetFences(device, 1, &recording.fence);
+        vkResetCommandBuffer(recording.commandBuffer, 0);
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandPool = commandPool;
+        allocateInfo.commandBufferCount = 1;
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkAllocateCommandBuffers(device, &allocateInfo, &recording.commandBuffer) != VK_SUCCESS ||
+            vkCreateFence(device, &fenceInfo, nullptr, &recording.fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create upload batch.");
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(recording.commandBuffer, &beginInfo);
+
+    recording.lastTicket = 0;
+    recording.stagingEnd = stagingHead;
+    recording.bytes = 0;
+    isRecording = true;
+    return recording;
+}
+
+void UploadManager::SubmitRecording()
+{
+    if (!isRecording) return;
+
+    //Make the buffer copies visible to anything submitted after the batch, image writes have their own barriers.
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                            VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+                            VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(recording.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    if (vkEndCommandBuffer(recording.commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to record upload command buffer.");
+    }
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &recording.commandBuffer;
+
+    if (vkQueueSubmit(queue, 1, &submitInfo, recording.fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to submit uploads.");
+    }
+
+    inFlight.push_back(std::move(recording));
+    recording = Batch();
+    isRecording = false;
+}
+
+void UploadManager::WaitOldest()
+{
+    if (inFlight.empty()) return;
+
+    vkWaitForFences(device, 1, &inFlight.front().fence, VK_TRUE, UINT64_MAX);
+    completedTicket = std::max(completedTicket, inFlight.front().lastTicket);
+    Retire(inFlight.front());
+    inFlight.pop_front();
+}
+
+void UploadManager::Retire(Batch &batch)
+{
+    for (Buffer &buffer : batch.stagingBuffers)
+    {
+        vmaDestroyBuffer(allocator, buffer.buffer, buffer.allocation);
+    }
+
+    //Batches finish in order, so everything in the ring before this batch's end is free now.
+    stagingTail = std::max(stagingTail, batch.stagingEnd);
+
+    batch.stagingBuffers.clear();
+    batch.bytes = 0;
+    freeBatches.push_back(std::move(batch));
+}
@@ -0,0 +1,174 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_UPLOADMANAGER_H
+#define RELIC_UPLOADMANAGER_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "vk_mem_alloc.h"
+#include "VulkanModelExtensions.h"
+
+/// Copies data into device local buffers and images without waiting for the GPU.
+///
+/// Writes are recorded into a batch, and the whole batch goes to the queue in a single submission when Submit is
+/// called, once a frame. Each batch has a fence, which Update polls without blocking. Writes return a ticket, so
+/// callers can tell when the data has arrived and only use it from then on.
+///
+/// Data is staged in a persistently mapped ring buffer. Space taken by a batch is reclaimed once its fence signals.
+/// Each submission only takes up to a budget of bytes. Writes past the budget, or that don't fit in the ring, are
+/// copied aside and go out over the following frames, in the order they were made. Writes larger than the whole ring
+/// get a staging buffer of their own.
+///
+/// Writes complete in the order they were made, so a ticket is complete once every write up to it is. Not thread
+/// safe.
+class UploadManager
+{
+public:
+    /// \param queueFamily Family of the queue, the command pool is created for it.
+    /// \param queue Queue the batches are submitted to. Resources written have to be used on the same family.
+    /// \param stagingSize Size of the staging ring in bytes.
+    /// \param frameBudget Bytes each submission takes at most. A single larger write still goes in a submission of
+    /// its own.
+    void Create(VkDevice device, VmaAllocator allocator, uint32_t queueFamily, VkQueue queue,
+                VkDeviceSize stagingSize, VkDeviceSize frameBudget);
+
+    /// Wait for every submitted batch and destroy everything. Writes that were never submitted are dropped.
+    void Destroy();
+
+    /// Copy data into part of a buffer. The buffer needs VK_BUFFER_USAGE_TRANSFER_DST_BIT. The data can be freed as
+    /// soon as this returns.
+    /// \param offset Offset of the data in the buffer, in bytes.
+    /// \return Ticket of the write.
+    uint64_t WriteBuffer(VkBuffer buffer, VkDeviceSize offset, const void *data, VkDeviceSize size);
+
+    /// Replace the contents of the first mip level of a 2D colour image, and move it to a new layout. The data can
+    /// be freed as soon as this returns.
+    /// \param finalLayout Layout the image is in once the write completes.
+    /// \return Ticket of the write.
+    uint64_t WriteImage(VkImage image, VkExtent3D extent, const void *data, VkDeviceSize size,
+                        VkImageLayout finalLayout);
+
+    /// Copy regions of one buffer into another, after every write made so far, and submit it straight away so it runs
+    /// ahead of anything submitted later. Writes waiting for a later submission are recorded first, ignoring the
+    /// budget, which only blocks if they don't fit in the ring.
+    /// \return Ticket of the copy.
+    uint64_t CopyBuffer(VkBuffer source, VkBuffer destination, const std::vector<VkBufferCopy> &regions);
+
+    /// Submit the writes made since the last submission, and as many waiting ones as the budget allows, as a single
+    /// batch.
+    void Submit();
+
+    /// Retire batches the GPU has finished, reclaiming their staging space. Doesn't block.
+    void Update();
+
+    /// Submit everything, ignoring the budget, and wait for every batch to finish.
+    void Flush();
+
+    /// Whether a write is done. Only changes in Update and Flush.
+    [[nodiscard]] bool IsComplete(uint64_t ticket) const;
+
+    /// Number of batches submitted and not yet retired.
+    [[nodiscard]] uint32_t BatchesInFlight() const;
+
+    /// Bytes recorded or submitted and not yet retired.
+    [[nodiscard]] VkDeviceSize BytesInFlight() const;
+
+    /// Bytes of writes waiting for a later submission.
+    [[nodiscard]] VkDeviceSize BytesWaiting() const;
+
+    /// Bytes of the staging ring in use, including space skipped when wrapping around.
+    [[nodiscard]] VkDeviceSize StagingUsed() const;
+
+    [[nodiscard]] VkDeviceSize StagingSize() const;
+
+private:
+    //Staging offsets are kept at a multiple of this, which covers the texel size of every colour format.
+    static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+    struct Batch
+    {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        //Last write recorded, and where the ring's head was after it.
+        uint64_t lastTicket = 0;
+        VkDeviceSize stagingEnd = 0;
+        VkDeviceSize bytes = 0;
+        //Staging buffers of writes too large for the ring.
+        std::vector<Buffer> stagingBuffers;
+    };
+
+    /// A buffer write when image is null, an image write otherwise.
+    struct Write
+    {
+        uint64_t ticket = 0;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkImage image = VK_NULL_HANDLE;
+        VkExtent3D extent = {};
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        //Copy of the data, only for writes waiting for a later submission.
+        std::vector<uint8_t> data;
+    };
+
+    /// Record a write now if nothing is waiting and it fits, otherwise copy it aside.
+    uint64_t Enqueue(Write &write, const void *data, VkDeviceSize size);
+
+    /// Stage a write and record it into the batch being recorded.
+    /// \return False if there's no room in the staging ring.
+    bool Record(const Write &write, const void *data, VkDeviceSize size);
+
+    /// Record waiting writes, in order.
+    /// \param force Ignore the budget, and wait for batches to finish when the ring is full.
+    void RecordWaiting(bool force);
+
+    [[nodiscard]] bool WithinBudget(VkDeviceSize size) const;
+
+    /// Take space in the staging ring.
+    /// \return False if there isn't enough free space.
+    bool AllocateStaging(VkDeviceSize size, VkDeviceSize &offset);
+
+    /// Get the batch being recorded, starting one if there isn't one.
+    Batch &Recording();
+
+    void SubmitRecording();
+
+    /// Block until the oldest batch in flight is done, and retire it.
+    void WaitOldest();
+
+    /// Free the staging space and buffers of a finished batch and make it available again.
+    void Retire(Batch &batch);
+
+    VkDevice device = VK_NULL_HANDLE;
+    VmaAllocator allocator = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+
+    Batch recording;
+    bool isRecording = false;
+
+    std::deque<Batch> inFlight;
+    std::vector<Batch> freeBatches;
+
+    std::deque<Write> waiting;
+    VkDeviceSize waitingBytes = 0;
+
+    //Bytes recorded since the last submission.
+    VkDeviceSize frameBytes = 0;
+    VkDeviceSize frameBudget = 0;
+
+    //Head and tail only ever grow, their difference is the space in use and the position is modulo the size.
+    Buffer staging = {};
+    uint8_t *stagingData = nullptr;
+    VkDeviceSize stagingSize = 0;
+    VkDeviceSize stagingHead = 0;
+    VkDeviceSize stagingTail = 0;
+
+    uint64_t nextTicket = 1;
+    uint64_t completedTicket = 0;
+};
+
+#endif //RELIC_UPLOADMANAGER_H
@@ -6,6 +6,7 @@
 #define RELIC_VULKANMODELEXTENSIONS_H
 
 #include <vulkan/vulkan.h>
+#include <MemoryManager/TLSFAllocator.h>
 #include "vk_mem_alloc.h"
 
 struct Buffer
@@ -14,10 +15,23 @@ struct Buffer
     VmaAllocation allocation;
 };
 
+/// Buffer holding the vertex or index data of many meshes, each of which gets a range of it. Ranges are counted in
+/// elements, so they can be used as the vertex offset and first index of a draw directly.
+struct GeometryArena
+{
+    Buffer buffer;
+    TLSFAllocator ranges;
+    uint32_t stride;
+    VkBufferUsageFlags usage;
+    uint32_t compactions;
+};
+
 struct VulkanRenderData
 {
-    Buffer vertexBuffer;
-    Buffer indexBuffer;
+    //Ranges of the vertex and index arenas.
+    uint32_t vertices;
+    uint32_t indices;
+    //Set once the upload of the data has completed.
     bool ready;
 };
 
@@ -29,10 +43,37 @@ struct Image
     VmaAllocation allocation;
 };
 
+/// A material as shaders see it, laid out as in the material buffer (std430).
+struct MaterialTableEntry
+{
+    //Slot in the texture table.
+    uint32_t texture;
+    //Draw list of the material's pipeline when culling on the GPU, or NO_DRAW_LIST if it isn't drawn.
+    uint32_t drawList;
+};
+
+/// Where a mesh's data is in the geometry arenas, laid out as in the mesh table (std430).
+struct MeshTableEntry
+{
+    //0 while the mesh isn't ready, so it isn't drawn.
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+};
+
+constexpr uint32_t NO_DRAW_LIST = 0xFFFFFFFF;
+
 struct VulkanMaterialData
 {
-    VkDescriptorSet descriptorSet;
     Image texture;
+    //Slot of the texture in the texture table.
+    uint32_t textureSlot;
+    //Set once the upload of the texture has completed.
+    bool ready;
+    //Id in the PipelineLibrary.
+    uint32_t pipeline;
+    //Draw list of the material when culling on the GPU, see SingletonVulkanRenderState::drawListPipelines.
+    uint32_t drawList;
 };
 
 #endif //RELIC_VULKANMODELEXTENSIONS_H
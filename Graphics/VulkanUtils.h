@@ -9,6 +9,7 @@
 #include <vector>
 #include <stdexcept>
 #include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
 #include <Graphics/Model.h>
 #include <array>
 
@@ -57,42 +58,6 @@ void WriteToBufferDirect(VmaAllocator allocator, VmaAllocation allocation, void
     vmaUnmapMemory(allocator, allocation);
 }
 
-void CopyBuffer(VkBuffer sourceBuffer, VkBuffer destBuffer, VkDeviceSize size, VkCommandPool commandPool, VkDevice device, VkQueue queue)
-{
-    VkCommandBufferAllocateInfo allocateInfo = {};
-    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocateInfo.commandPool = commandPool;
-    allocateInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device, &allocateInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo info = {};
-    info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &info);
-
-    VkBufferCopy copy = {};
-    copy.srcOffset = 0;
-    copy.dstOffset = 0;
-    copy.size = size;
-    vkCmdCopyBuffer(commandBuffer, sourceBuffer, destBuffer, 1, &copy);
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo = {};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(queue);
-
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
-}
-
 VkCommandBuffer StartSingleUseCommandBuffer(VkCommandPool commandPool, VkDevice device)
 {
     VkCommandBufferAllocateInfo allocateInfo = {};
@@ -127,104 +92,6 @@ void EndSingleUseCommandBuffer(VkCommandBuffer buffer, VkQueue queue, VkCommandP
     vkFreeCommandBuffers(device, commandPool, 1, &buffer);
 }
 
-void CopyBufferToImage(VkBuffer sourceBuffer, VkImage image, VkImageLayout layout, VkExtent3D extent, VkCommandPool commandPool, VkDevice device, VkQueue queue)
-{
-    VkCommandBuffer buffer = StartSingleUseCommandBuffer(commandPool, device);
-
-    VkBufferImageCopy regions = {};
-    regions.bufferRowLength = 0;
-    regions.bufferImageHeight = 0;
-    regions.bufferOffset = 0;
-    regions.imageOffset = {0,0,0};
-    regions.imageSubresource = VkImageSubresourceLayers {
-        VK_IMAGE_ASPECT_COLOR_BIT,
-        0,
-        0,
-        1
-    };
-    regions.imageExtent = extent;
-
-    vkCmdCopyBufferToImage(buffer, sourceBuffer, image, layout, 1, &regions);
-
-    EndSingleUseCommandBuffer(buffer, queue, commandPool, device);
-}
-
-void WriteToBuffer(VmaAllocator allocator, VkBuffer buffer, void *data, size_t size, VkCommandPool commandPool, VkDevice device, VkQueue queue)
-{
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingAllocation;
-
-    CreateBuffer(allocator, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, stagingBuffer, stagingAllocation);
-    WriteToBufferDirect(allocator, stagingAllocation, data, size);
-
-    CopyBuffer(stagingBuffer, buffer, size, commandPool, device, queue);
-
-    vmaDestroyBuffer(allocator, stagingBuffer, stagingAllocation);
-}
-
-void TransitionImageLayout(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, VkFormat format, VkCommandPool commandPool, VkDevice device, VkQueue queue)
-{
-    VkCommandBuffer buffer = StartSingleUseCommandBuffer(commandPool, device);
-
-    VkImageMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-
-    barrier.image = image;
-    barrier.subresourceRange = {
-            VK_IMAGE_ASPECT_COLOR_BIT,
-            0,
-            1,
-            0,
-            1
-    };
-
-    VkPipelineStageFlags sourceStage, destinationStage;
-    if(oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if(oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    } else {
-        throw std::invalid_argument("unsupported layout transition...");
-    }
-
-    vkCmdPipelineBarrier(buffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-    EndSingleUseCommandBuffer(buffer, queue, commandPool, device);
-}
-
-void WriteToImage(VmaAllocator allocator, VkImage image, VkFormat format, VkImageLayout layout, VkImageLayout endLayout, void* data, size_t size, VkExtent3D extent, VkCommandPool commandPool, VkDevice device, VkQueue queue)
-{
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingAllocation;
-
-    CreateBuffer(allocator, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, stagingBuffer, stagingAllocation);
-    WriteToBufferDirect(allocator, stagingAllocation, data, size);
-
-    TransitionImageLayout(image, layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, format, commandPool, device, queue);
-
-    CopyBufferToImage(stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, extent, commandPool, device, queue);
-
-    TransitionImageLayout(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, endLayout, format, commandPool, device, queue);
-
-    vmaDestroyBuffer(allocator, stagingBuffer, stagingAllocation);
-}
-
 VkVertexInputBindingDescription GetVertexInputBindingDescription()
 {
     VkVertexInputBindingDescription description = {};
@@ -234,9 +101,18 @@ VkVertexInputBindingDescription GetVertexInputBindingDescription()
     return description;
 }
 
-std::array<VkVertexInputAttributeDescription, 3> GetAttributeDescriptions()
+VkVertexInputBindingDescription GetInstanceInputBindingDescription()
 {
-    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions = {};
+    VkVertexInputBindingDescription description = {};
+    description.stride = sizeof(InstanceData);
+    description.binding = 1;
+    description.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+    return description;
+}
+
+std::array<VkVertexInputAttributeDescription, 8> GetAttributeDescriptions()
+{
+    std::array<VkVertexInputAttributeDescription, 8> attributeDescriptions = {};
     //position
     attributeDescriptions[0].binding = 0;
     attributeDescriptions[0].location = 0;
@@ -255,6 +131,21 @@ std::array<VkVertexInputAttributeDescription, 3> GetAttributeDescriptions()
     attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
     attributeDescriptions[2].offset = offsetof(Vertex, textureCoordinate);
 
+    //instance model matrix, one location per column
+    for (uint32_t column = 0; column < 4; column++)
+    {
+        attributeDescriptions[3 + column].binding = 1;
+        attributeDescriptions[3 + column].location = 3 + column;
+        attributeDescriptions[3 + column].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attributeDescriptions[3 + column].offset = offsetof(InstanceData, model) + column * sizeof(glm::vec4);
+    }
+
+    //instance material
+    attributeDescriptions[7].binding = 1;
+    attributeDescriptions[7].location = 7;
+    attributeDescriptions[7].format = VK_FORMAT_R32_UINT;
+    attributeDescriptions[7].offset = offsetof(InstanceData, material);
+
     return attributeDescriptions;
 }
 
@@ -53,3 +53,9 @@ GUID GetGUID(const std::string resourceName)
     uint32_t guid = murmur3_32(reinterpret_cast<const uint8_t *>(resourceName.c_str()), resourceName.size(), 0);
     return reinterpret_cast<GUID>(guid);
 }
+
+GUID GetMeshGUID(GUID model, uint32_t index)
+{
+    uint32_t guid = murmur3_32(reinterpret_cast<const uint8_t *>(&index), sizeof(index), static_cast<uint32_t>(model));
+    return static_cast<GUID>(guid);
+}
@@ -17,4 +17,10 @@ uint32_t murmur3_32(const uint8_t* key, size_t len, uint32_t seed);
 
 GUID GetGUID(std::string resourceName);
 
+/// GUID of a mesh within a model, stable across imports as long as the model's mesh order doesn't change.
+/// \param model GUID of the model the mesh belongs to.
+/// \param index Index of the mesh within the model.
+/// \return The mesh GUID.
+GUID GetMeshGUID(GUID model, uint32_t index);
+
 #endif //RELIC_IMPORTUTIL_H
@@ -66,6 +66,7 @@ GUID ModelImporter::ImportResource(const std::string &filePath)
         }
 
         model->meshes[i].vertices = relVerts;
+        model->meshes[i].bounds = CalculateBounds(relVerts, model->meshes[i].vertexCount);
     }
 
     ResourceManager::GetInstance()->SetResourceData(guid, REL_STRUCTURE_TYPE_MODEL, sizeof(Model), model);
@@ -113,6 +114,8 @@ void *ModelImporter::Deserialize(void *data, size_t dataSize)
         {
             ReadBin(data, &model->meshes[i].indices[j], offset, sizeof(uint32_t));
         }
+
+        model->meshes[i].bounds = CalculateBounds(model->meshes[i].vertices, model->meshes[i].vertexCount);
     }
 
     return model;
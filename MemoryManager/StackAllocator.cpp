@@ -11,18 +11,24 @@ StackAllocator::StackAllocator(uint32_t stack_size_bytes)
     current_marker = stack_base;
 }
 
-void *StackAllocator::Allocate(uint32_t size_bytes)
+StackAllocator::~StackAllocator()
 {
-    //Make sure we have enough memory to service the request
-    if(stack_top - current_marker < size_bytes)
-    {
-        Logger::Log("[StackAllocator] Cannot service memory request.");
-        return nullptr;
-    }
+    delete[] reinterpret_cast<char *>(stack_base);
+}
 
-    Marker allocated_base = current_marker;
+void *StackAllocator::Allocate(uint32_t size_bytes)
+{
+    Marker allocated_base = current_marker.load(std::memory_order_relaxed);
 
-    current_marker += size_bytes;
+    do
+    {
+        //Make sure we have enough memory to service the request
+        if(stack_top - allocated_base < size_bytes)
+        {
+            Logger::Log("[StackAllocator] Cannot service memory request.");
+            return nullptr;
+        }
+    } while (!current_marker.compare_exchange_weak(allocated_base, allocated_base + size_bytes, std::memory_order_relaxed));
 
     return reinterpret_cast<void *>(allocated_base);
 }
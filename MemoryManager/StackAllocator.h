@@ -6,6 +6,7 @@
 #define RELIC_2_0_STACKALLOCATOR_H
 
 #include <cstdint>
+#include <atomic>
 #include <Debugging/Logger.h>
 
 class StackAllocator
@@ -18,7 +19,13 @@ public:
     /// \param stack_size_bytes - The number of bytes to allocate.
     explicit StackAllocator(uint32_t stack_size_bytes);
 
-    /// Allocate a desired number of bytes from the stack.
+    ~StackAllocator();
+
+    StackAllocator(const StackAllocator &) = delete;
+    StackAllocator &operator=(const StackAllocator &) = delete;
+
+    /// Allocate a desired number of bytes from the stack. Safe to call from several threads at once, everything else
+    /// expects no allocations to be in flight.
     /// \param size_bytes - Number of bytes to allocate.
     /// \return Pointer to the allocated memory.
     void *Allocate(uint32_t size_bytes);
@@ -50,7 +57,7 @@ private:
     Marker stack_top;
 
     //Marker to the currently allocated portion of the stack.
-    Marker current_marker;
+    std::atomic<Marker> current_marker;
 };
 
 
@@ -0,0 +1,364 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "TLSFAllocator.h"
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// Index of the highest set bit, value must not be 0.
+static uint32_t HighestBit(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return index;
+#else
+    return 31 - __builtin_clz(value);
+#endif
+}
+
+/// Index of the lowest set bit, value must not be 0.
+static uint32_t LowestBit(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+TLSFAllocator::TLSFAllocator(uint32_t size)
+{
+    Reset(size);
+}
+
+void TLSFAllocator::Reset(uint32_t size)
+{
+    nodes.clear();
+    unusedNodes.clear();
+
+    firstLevelBitmap = 0;
+    std::fill(std::begin(secondLevelBitmaps), std::end(secondLevelBitmaps), 0);
+    for (auto &lists : freeLists)
+    {
+        std::fill(std::begin(lists), std::end(lists), NULL_NODE);
+    }
+
+    head = NULL_NODE;
+    tail = NULL_NODE;
+    this->size = 0;
+    used = 0;
+    allocationCount = 0;
+
+    Grow(size);
+}
+
+void TLSFAllocator::Grow(uint32_t size)
+{
+    if (size <= this->size) return;
+
+    uint32_t extra = size - this->size;
+
+    //Extend the free range at the end if there is one, so it isn't split in two.
+    if (tail != NULL_NODE && nodes[tail].free)
+    {
+        RemoveFree(tail);
+        nodes[tail].size += extra;
+        InsertFree(tail);
+    }
+    else
+    {
+        uint32_t node = CreateNode(this->size, extra);
+        nodes[node].previous = tail;
+
+        if (tail != NULL_NODE) nodes[tail].next = node;
+        else head = node;
+
+        tail = node;
+        InsertFree(node);
+    }
+
+    this->size = size;
+}
+
+uint32_t TLSFAllocator::Allocate(uint32_t size)
+{
+    size = std::max<uint32_t>(size, 1);
+
+    uint32_t firstLevel, secondLevel;
+    uint32_t node = NULL_NODE;
+
+    if (FindFreeList(size, firstLevel, secondLevel))
+    {
+        node = freeLists[firstLevel][secondLevel];
+    }
+    else
+    {
+        //Nothing in the larger classes, but the list this size falls in may still have a range that fits.
+        Mapping(size, firstLevel, secondLevel);
+        for (uint32_t i = freeLists[firstLevel][secondLevel]; i != NULL_NODE && node == NULL_NODE; i = nodes[i].nextFree)
+        {
+            if (nodes[i].size >= size) node = i;
+        }
+    }
+
+    if (node == NULL_NODE) return INVALID_ALLOCATION;
+
+    RemoveFree(node);
+
+    //Return what isn't needed to the free lists.
+    if (nodes[node].size > size)
+    {
+        uint32_t rest = CreateNode(nodes[node].offset + size, nodes[node].size - size);
+        nodes[rest].previous = node;
+        nodes[rest].next = nodes[node].next;
+
+        if (nodes[node].next != NULL_NODE) nodes[nodes[node].next].previous = rest;
+        else tail = rest;
+
+        nodes[node].next = rest;
+        nodes[node].size = size;
+        InsertFree(rest);
+    }
+
+    nodes[node].free = false;
+    used += size;
+    allocationCount++;
+
+    return node;
+}
+
+void TLSFAllocator::Free(uint32_t allocation)
+{
+    if (allocation >= nodes.size() || nodes[allocation].free) return;
+
+    used -= nodes[allocation].size;
+    allocationCount--;
+    nodes[allocation].free = true;
+
+    //Merge with the free ranges on either side.
+    uint32_t next = nodes[allocation].next;
+    if (next != NULL_NODE && nodes[next].free)
+    {
+        RemoveFree(next);
+        nodes[allocation].size += nodes[next].size;
+        nodes[allocation].next = nodes[next].next;
+
+        if (nodes[next].next != NULL_NODE) nodes[nodes[next].next].previous = allocation;
+        else tail = allocation;
+
+        ReleaseNode(next);
+    }
+
+    uint32_t previous = nodes[allocation].previous;
+    if (previous != NULL_NODE && nodes[previous].free)
+    {
+        RemoveFree(previous);
+        nodes[previous].size += nodes[allocation].size;
+        nodes[previous].next = nodes[allocation].next;
+
+        if (nodes[allocation].next != NULL_NODE) nodes[nodes[allocation].next].previous = previous;
+        else tail = previous;
+
+        ReleaseNode(allocation);
+        allocation = previous;
+    }
+
+    InsertFree(allocation);
+}
+
+void TLSFAllocator::Compact(std::vector<Move> &moves)
+{
+    moves.clear();
+
+    uint32_t offset = 0;
+    uint32_t previous = NULL_NODE;
+    uint32_t node = head;
+    head = NULL_NODE;
+
+    while (node != NULL_NODE)
+    {
+        uint32_t next = nodes[node].next;
+
+        if (nodes[node].free)
+        {
+            RemoveFree(node);
+            ReleaseNode(node);
+        }
+        else
+        {
+            if (nodes[node].offset != offset) moves.push_back({node, nodes[node].offset, offset, nodes[node].size});
+
+            nodes[node].offset = offset;
+            nodes[node].previous = previous;
+            offset += nodes[node].size;
+
+            if (previous != NULL_NODE) nodes[previous].next = node;
+            else head = node;
+
+            previous = node;
+        }
+
+        node = next;
+    }
+
+    if (previous != NULL_NODE) nodes[previous].next = NULL_NODE;
+    tail = previous;
+
+    //Everything that's left is a single range at the end.
+    uint32_t total = size;
+    size = offset;
+    Grow(total);
+}
+
+uint32_t TLSFAllocator::Offset(uint32_t allocation) const
+{
+    return nodes[allocation].offset;
+}
+
+uint32_t TLSFAllocator::AllocationSize(uint32_t allocation) const
+{
+    return nodes[allocation].size;
+}
+
+uint32_t TLSFAllocator::Size() const
+{
+    return size;
+}
+
+uint32_t TLSFAllocator::Used() const
+{
+    return used;
+}
+
+uint32_t TLSFAllocator::AllocationCount() const
+{
+    return allocationCount;
+}
+
+uint32_t TLSFAllocator::LargestFreeRange() const
+{
+    if (firstLevelBitmap == 0) return 0;
+
+    //Ranges in a list can be up to one step apart in size, so check the whole of the highest one.
+    uint32_t firstLevel = HighestBit(firstLevelBitmap);
+    uint32_t secondLevel = HighestBit(secondLevelBitmaps[firstLevel]);
+
+    uint32_t largest = 0;
+    for (uint32_t node = freeLists[firstLevel][secondLevel]; node != NULL_NODE; node = nodes[node].nextFree)
+    {
+        largest = std::max(largest, nodes[node].size);
+    }
+
+    return largest;
+}
+
+float TLSFAllocator::Fragmentation() const
+{
+    uint32_t free = size - used;
+    if (free == 0) return 0.0f;
+
+    return 1.0f - (float) LargestFreeRange() / (float) free;
+}
+
+void TLSFAllocator::Mapping(uint32_t size, uint32_t &firstLevel, uint32_t &secondLevel)
+{
+    if (size < SECOND_LEVEL_COUNT)
+    {
+        firstLevel = 0;
+        secondLevel = size;
+        return;
+    }
+
+    uint32_t highestBit = HighestBit(size);
+    firstLevel = highestBit - SECOND_LEVEL_BITS + 1;
+    secondLevel = (size >> (highestBit - SECOND_LEVEL_BITS)) - SECOND_LEVEL_COUNT;
+}
+
+bool TLSFAllocator::FindFreeList(uint32_t size, uint32_t &firstLevel, uint32_t &secondLevel) const
+{
+    //Round up to the next list, so every range in the list that's found is large enough.
+    uint64_t rounded = size;
+    if (size >= SECOND_LEVEL_COUNT) rounded += (1ull << (HighestBit(size) - SECOND_LEVEL_BITS)) - 1;
+    if (rounded > UINT32_MAX) return false;
+
+    Mapping((uint32_t) rounded, firstLevel, secondLevel);
+
+    uint32_t secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+    if (secondLevelMap == 0)
+    {
+        uint32_t firstLevelMap = firstLevel + 1 < 32 ? firstLevelBitmap & (~0u << (firstLevel + 1)) : 0;
+        if (firstLevelMap == 0) return false;
+
+        firstLevel = LowestBit(firstLevelMap);
+        secondLevelMap = secondLevelBitmaps[firstLevel];
+    }
+
+    secondLevel = LowestBit(secondLevelMap);
+    return true;
+}
+
+uint32_t TLSFAllocator::CreateNode(uint32_t offset, uint32_t size)
+{
+    uint32_t node;
+    if (!unusedNodes.empty())
+    {
+        node = unusedNodes.back();
+        unusedNodes.pop_back();
+    }
+    else
+    {
+        node = (uint32_t) nodes.size();
+        nodes.emplace_back();
+    }
+
+    nodes[node] = {offset, size, NULL_NODE, NULL_NODE, NULL_NODE, NULL_NODE, false};
+    return node;
+}
+
+void TLSFAllocator::ReleaseNode(uint32_t node)
+{
+    nodes[node].free = true;
+    unusedNodes.push_back(node);
+}
+
+void TLSFAllocator::InsertFree(uint32_t node)
+{
+    uint32_t firstLevel, secondLevel;
+    Mapping(nodes[node].size, firstLevel, secondLevel);
+
+    uint32_t &list = freeLists[firstLevel][secondLevel];
+    nodes[node].free = true;
+    nodes[node].previousFree = NULL_NODE;
+    nodes[node].nextFree = list;
+
+    if (list != NULL_NODE) nodes[list].previousFree = node;
+    list = node;
+
+    firstLevelBitmap |= 1u << firstLevel;
+    secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+}
+
+void TLSFAllocator::RemoveFree(uint32_t node)
+{
+    uint32_t firstLevel, secondLevel;
+    Mapping(nodes[node].size, firstLevel, secondLevel);
+
+    Node &entry = nodes[node];
+    if (entry.previousFree != NULL_NODE) nodes[entry.previousFree].nextFree = entry.nextFree;
+    else freeLists[firstLevel][secondLevel] = entry.nextFree;
+
+    if (entry.nextFree != NULL_NODE) nodes[entry.nextFree].previousFree = entry.previousFree;
+
+    if (freeLists[firstLevel][secondLevel] == NULL_NODE)
+    {
+        secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+        if (secondLevelBitmaps[firstLevel] == 0) firstLevelBitmap &= ~(1u << firstLevel);
+    }
+}
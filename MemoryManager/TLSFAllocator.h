@@ -0,0 +1,116 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_TLSFALLOCATOR_H
+#define RELIC_TLSFALLOCATOR_H
+
+#include <cstdint>
+#include <vector>
+
+/// Two level segregated fit allocator for ranges of a resource it doesn't own, like a GPU buffer. Hands out offsets in
+/// whatever unit the caller uses, and never touches the memory itself.
+///
+/// Free ranges are kept in lists by size class: a power of two, split into 16 linear steps. Finding a range that fits
+/// and freeing one, including merging it with its free neighbours, both take constant time. A request is rounded up
+/// to the next size class when searching, so it wastes at most 1/16th of the range it lands in.
+class TLSFAllocator
+{
+public:
+    static constexpr uint32_t INVALID_ALLOCATION = UINT32_MAX;
+
+    /// Where an allocation moved to during Compact.
+    struct Move
+    {
+        uint32_t allocation;
+        uint32_t from;
+        uint32_t to;
+        uint32_t size;
+    };
+
+    /// \param size Size of the range to allocate from.
+    explicit TLSFAllocator(uint32_t size = 0);
+
+    /// Forget every allocation and start over with a range of a new size.
+    void Reset(uint32_t size);
+
+    /// Extend the end of the range. Existing allocations keep their offsets.
+    void Grow(uint32_t size);
+
+    /// \param size Size of the allocation, 0 is treated as 1.
+    /// \return Id of the allocation, INVALID_ALLOCATION if there is no free range large enough.
+    uint32_t Allocate(uint32_t size);
+
+    void Free(uint32_t allocation);
+
+    /// Move every allocation to the start of the range, in the order they're in now, leaving a single free range at
+    /// the end. Allocation ids stay the same.
+    /// \param moves Receives every allocation that moved, in ascending order of offset.
+    void Compact(std::vector<Move> &moves);
+
+    [[nodiscard]] uint32_t Offset(uint32_t allocation) const;
+
+    [[nodiscard]] uint32_t AllocationSize(uint32_t allocation) const;
+
+    /// Size of the whole range.
+    [[nodiscard]] uint32_t Size() const;
+
+    [[nodiscard]] uint32_t Used() const;
+
+    [[nodiscard]] uint32_t AllocationCount() const;
+
+    [[nodiscard]] uint32_t LargestFreeRange() const;
+
+    /// How much of the free space can't be used by a single allocation: 0 when it's all in one range, close to 1 when
+    /// it's spread over many small ones.
+    [[nodiscard]] float Fragmentation() const;
+
+private:
+    static constexpr uint32_t NULL_NODE = UINT32_MAX;
+
+    //Each power of two is split into 2^SECOND_LEVEL_BITS lists. Sizes below 2^SECOND_LEVEL_BITS all go in the first.
+    static constexpr uint32_t SECOND_LEVEL_BITS = 4;
+    static constexpr uint32_t SECOND_LEVEL_COUNT = 1u << SECOND_LEVEL_BITS;
+    static constexpr uint32_t FIRST_LEVEL_COUNT = 32 - SECOND_LEVEL_BITS + 1;
+
+    /// A range that's either free or allocated. Ranges are linked to their neighbours in the resource, and free ones
+    /// to the other free ranges in their list.
+    struct Node
+    {
+        uint32_t offset;
+        uint32_t size;
+        uint32_t previous;
+        uint32_t next;
+        uint32_t previousFree;
+        uint32_t nextFree;
+        bool free;
+    };
+
+    static void Mapping(uint32_t size, uint32_t &firstLevel, uint32_t &secondLevel);
+
+    /// Smallest free list that only holds ranges of at least size, or false if there isn't one with anything in it.
+    bool FindFreeList(uint32_t size, uint32_t &firstLevel, uint32_t &secondLevel) const;
+
+    uint32_t CreateNode(uint32_t offset, uint32_t size);
+    void ReleaseNode(uint32_t node);
+
+    void InsertFree(uint32_t node);
+    void RemoveFree(uint32_t node);
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> unusedNodes;
+
+    uint32_t firstLevelBitmap = 0;
+    uint32_t secondLevelBitmaps[FIRST_LEVEL_COUNT] = {};
+    uint32_t freeLists[FIRST_LEVEL_COUNT][SECOND_LEVEL_COUNT] = {};
+
+    //First and last range in the resource.
+    uint32_t head = NULL_NODE;
+    uint32_t tail = NULL_NODE;
+
+    uint32_t size = 0;
+    uint32_t used = 0;
+    uint32_t allocationCount = 0;
+};
+
+#endif //RELIC_TLSFALLOCATOR_H
@@ -3,6 +3,7 @@
 //
 
 #include "ResourceManager.h"
+#include <Graphics/Model.h>
 
 #include <utility>
 
@@ -28,6 +29,7 @@ void ResourceManager::SetResourceData(uint_fast32_t guid, RelicType type, size_t
     if (write) manager.WriteRPACK();
 
     resources.insert_or_assign(guid, data);
+    if (type == REL_STRUCTURE_TYPE_MODEL) RegisterModel(guid, static_cast<Model *>(data));
 }
 
 bool ResourceManager::IsResourceLoaded(uint_fast32_t guid)
@@ -72,7 +74,37 @@ void *ResourceManager::GetResourceData(uint_fast32_t guid, bool forceReload)
     Logger::Log("%s", std::to_string(resourceSize).c_str());
     Logger::Log("%s", std::to_string(type).c_str());
 
-    return importer->Deserialize(data, resourceSize);
+    void *resource = importer->Deserialize(data, resourceSize);
+    if (type == REL_STRUCTURE_TYPE_MODEL && resource != nullptr) RegisterModel(guid, static_cast<Model *>(resource));
+
+    return resource;
+}
+
+void ResourceManager::RegisterModel(GUID guid, Model *model)
+{
+    model->guid = guid;
+
+    for (size_t i = 0; i < model->meshCount; i++)
+    {
+        Mesh &mesh = model->meshes[i];
+        mesh.guid = GetMeshGUID(guid, static_cast<uint32_t>(i));
+        meshes.insert_or_assign(mesh.guid, &mesh);
+    }
+}
+
+void ResourceManager::UnregisterModel(Model *model)
+{
+    for (size_t i = 0; i < model->meshCount; i++)
+    {
+        auto mesh = meshes.find(model->meshes[i].guid);
+        if (mesh != meshes.end() && mesh->second == &model->meshes[i]) meshes.erase(mesh);
+    }
+}
+
+Mesh *ResourceManager::GetMesh(GUID guid)
+{
+    auto mesh = meshes.find(guid);
+    return mesh != meshes.end() ? mesh->second : nullptr;
 }
 
 ResourceManager::~ResourceManager()
@@ -8,16 +8,23 @@
 #include <cstdint>
 #include <cstdio>
 #include <map>
+#include <unordered_map>
 #include <Core/RelicStruct.h>
 #include <Importers/IImporter.h>
 #include "Compression/CompressionManager.h"
 
+struct Mesh;
+struct Model;
+
 class ResourceManager
 {
 private:
     CompressionManager manager;
     std::map<uint_fast32_t, void *> resources;
 
+    //Meshes of every loaded model, so they can be found by GUID without knowing the model they belong to.
+    std::unordered_map<GUID, Mesh *> meshes;
+
     static ResourceManager *instance;
 public:
     template<typename T>
@@ -29,6 +36,21 @@ public:
 
     bool IsResourceLoaded(uint_fast32_t guid);
 
+    /// Assign GUIDs to a model and its meshes, and make its meshes available through GetMesh. Called for every model
+    /// that is imported or loaded.
+    /// \param guid GUID of the model.
+    /// \param model The model.
+    void RegisterModel(GUID guid, Model *model);
+
+    /// Stop GetMesh from returning the meshes of a model, for models that are about to be freed.
+    /// \param model A model passed to RegisterModel.
+    void UnregisterModel(Model *model);
+
+    /// Find a mesh of a loaded model.
+    /// \param guid GUID of the mesh, see GetMeshGUID.
+    /// \return The mesh, or nullptr if no loaded model contains it.
+    Mesh *GetMesh(GUID guid);
+
     void SetResourceData(uint_fast32_t guid, RelicType type, size_t size, void *data, bool write = true);
 
     void SetRPACK(std::string rpack, bool deleteResources = false);
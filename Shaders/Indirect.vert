@@ -0,0 +1,48 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 fragCoord;
+
+layout(set = 0, binding = 0) uniform Camera
+{
+    mat4 viewProjection;
+} camera;
+
+struct Material
+{
+    uint texture;
+    uint drawList;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Materials
+{
+    Material materials[];
+};
+
+struct Object
+{
+    mat4 model;
+    vec4 center;
+    vec4 extents;
+    uint mesh;
+    uint material;
+};
+
+//Draws written by the culling pass have the object as their first instance.
+layout(std430, set = 2, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragTexture;
+
+void main()
+{
+    Object object = objects[gl_InstanceIndex];
+    gl_Position = camera.viewProjection * object.model * vec4(inPosition, 1.0);
+    fragTexCoord = fragCoord;
+    fragTexture = materials[object.material].texture;
+}
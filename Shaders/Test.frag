@@ -1,14 +1,17 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) out vec4 color;
 
 layout(location = 0) in vec2 fragCoord;
+layout(location = 1) flat in uint fragTexture;
 
-layout(set = 1, binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2D textures[];
 
 void main()
 {
-    color = texture(texSampler, fragCoord);
+    //Instances of one draw can have different materials.
+    color = texture(textures[nonuniformEXT(fragTexture)], fragCoord);
 //    color = vec4(fragCoord, 0.0, 1.0);
 }
\ No newline at end of file
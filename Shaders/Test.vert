@@ -4,16 +4,31 @@
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 normal;
 layout(location = 2) in vec2 fragCoord;
+layout(location = 3) in mat4 instanceModel;
+layout(location = 7) in uint instanceMaterial;
 
-layout( push_constant ) uniform PushConstants
+layout(set = 0, binding = 0) uniform Camera
 {
-    mat4 mvp;
-} pushConstants;
+    mat4 viewProjection;
+} camera;
+
+struct Material
+{
+    uint texture;
+    uint drawList;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Materials
+{
+    Material materials[];
+};
 
 layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragTexture;
 
 void main()
 {
-    gl_Position = pushConstants.mvp * vec4(inPosition, 1.0);
+    gl_Position = camera.viewProjection * instanceModel * vec4(inPosition, 1.0);
     fragTexCoord = fragCoord;
+    fragTexture = materials[instanceMaterial].texture;
 }
\ No newline at end of file
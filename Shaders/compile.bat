@@ -1,2 +1,4 @@
 glslc Test.vert -o vert.spv
-glslc Test.frag -o frag.spv
\ No newline at end of file
+glslc Test.frag -o frag.spv
+glslc Indirect.vert -o indirect_vert.spv
+glslc Cull.comp -o cull.spv
\ No newline at end of file
@@ -0,0 +1,523 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "BVH.h"
+#include <Concurrency/Jobs/JobSystem.h>
+
+//Marks nodes on the free list, whose right child is the next free node.
+static constexpr int32_t FREE_NODE = -2;
+
+BVH::BVH(float margin) : margin(margin)
+{
+}
+
+uint32_t BVH::Insert(const Bounds &bounds, uint32_t userData)
+{
+    uint32_t proxy;
+    if (!freeProxies.empty())
+    {
+        proxy = freeProxies.back();
+        freeProxies.pop_back();
+    }
+    else
+    {
+        proxy = (uint32_t) proxies.size();
+        proxies.emplace_back();
+    }
+
+    glm::vec3 min = bounds.center - bounds.extents;
+    glm::vec3 max = bounds.center + bounds.extents;
+
+    int32_t leaf = AllocateNode();
+    nodes[leaf] = {min, NULL_NODE, max, (int32_t) proxy};
+    proxies[proxy] = {min - glm::vec3(margin), max + glm::vec3(margin), leaf, userData};
+
+    InsertLeaf(leaf);
+    leafCount++;
+    refitsSinceCheck++;
+
+    return proxy;
+}
+
+bool BVH::Update(uint32_t proxy, const Bounds &bounds)
+{
+    Proxy &entry = proxies[proxy];
+    Node &leaf = nodes[entry.node];
+
+    //Leaves always hold the exact box, so queries don't report anything the fat box would.
+    leaf.min = bounds.center - bounds.extents;
+    leaf.max = bounds.center + bounds.extents;
+
+    if (leaf.min.x >= entry.fatMin.x && leaf.min.y >= entry.fatMin.y && leaf.min.z >= entry.fatMin.z &&
+        leaf.max.x <= entry.fatMax.x && leaf.max.y <= entry.fatMax.y && leaf.max.z <= entry.fatMax.z)
+    {
+        return false;
+    }
+
+    entry.fatMin = leaf.min - glm::vec3(margin);
+    entry.fatMax = leaf.max + glm::vec3(margin);
+
+    Refit(parents[entry.node]);
+    refitsSinceCheck++;
+
+    return true;
+}
+
+void BVH::Remove(uint32_t proxy)
+{
+    int32_t leaf = proxies[proxy].node;
+
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+
+    proxies[proxy].node = NULL_NODE;
+    freeProxies.push_back(proxy);
+    leafCount--;
+}
+
+void BVH::Clear()
+{
+    nodes.clear();
+    parents.clear();
+    proxies.clear();
+    freeProxies.clear();
+
+    root = NULL_NODE;
+    freeNode = NULL_NODE;
+    leafCount = 0;
+    rebuildCost = 0.0f;
+    refitsSinceCheck = 0;
+}
+
+void BVH::Rebuild()
+{
+    buildEntries.clear();
+    buildEntries.reserve(leafCount);
+
+    for (uint32_t proxy = 0; proxy < proxies.size(); proxy++)
+    {
+        if (proxies[proxy].node == NULL_NODE) continue;
+
+        const Node &leaf = nodes[proxies[proxy].node];
+        buildEntries.push_back({leaf.min, leaf.max, proxy});
+    }
+
+    nodes.clear();
+    parents.clear();
+    freeNode = NULL_NODE;
+    root = NULL_NODE;
+
+    if (!buildEntries.empty())
+    {
+        nodes.resize(buildEntries.size() * 2 - 1);
+        parents.resize(buildEntries.size() * 2 - 1);
+        root = 0;
+        Build(buildEntries.data(), buildEntries.size(), root, NULL_NODE);
+    }
+
+    rebuildCost = Cost();
+    refitsSinceCheck = 0;
+}
+
+bool BVH::Maintain()
+{
+    if (leafCount == 0) return false;
+    if ((float) refitsSinceCheck < std::max(1.0f, (float) leafCount * MAINTAIN_REFIT_FRACTION)) return false;
+
+    refitsSinceCheck = 0;
+
+    //Never rebuilt, everything so far was inserted one at a time.
+    if (rebuildCost > 0.0f && Cost() <= rebuildCost * MAINTAIN_COST_RATIO) return false;
+
+    Rebuild();
+    return true;
+}
+
+float BVH::Cost() const
+{
+    if (root == NULL_NODE) return 0.0f;
+
+    float rootArea = SurfaceArea(nodes[root].min, nodes[root].max);
+    if (rootArea <= 0.0f) return 0.0f;
+
+    float total = 0.0f;
+    for (const Node &node : nodes)
+    {
+        if (node.left == FREE_NODE || node.IsLeaf()) continue;
+        total += SurfaceArea(node.min, node.max);
+    }
+
+    return total / rootArea;
+}
+
+size_t BVH::Size() const
+{
+    return leafCount;
+}
+
+uint32_t BVH::Height() const
+{
+    if (root == NULL_NODE) return 0;
+
+    struct Entry
+    {
+        int32_t node;
+        uint32_t depth;
+    };
+
+    uint32_t height = 0;
+    TraversalStack<Entry> stack;
+    stack.Push({root, 1});
+
+    while (!stack.Empty())
+    {
+        Entry entry = stack.Pop();
+        height = std::max(height, entry.depth);
+
+        const Node &node = nodes[entry.node];
+        if (node.IsLeaf()) continue;
+
+        stack.Push({node.left, entry.depth + 1});
+        stack.Push({node.right, entry.depth + 1});
+    }
+
+    return height;
+}
+
+uint32_t BVH::UserData(uint32_t proxy) const
+{
+    return proxies[proxy].userData;
+}
+
+bool BVH::Nearest(const glm::vec3 &point, float maxDistance, uint32_t &userData, float &distance) const
+{
+    if (root == NULL_NODE) return false;
+
+    struct Entry
+    {
+        int32_t node;
+        float distanceSquared;
+    };
+
+    float best = maxDistance * maxDistance;
+    bool found = false;
+
+    TraversalStack<Entry> stack;
+    stack.Push({root, DistanceSquared(nodes[root], point)});
+
+    while (!stack.Empty())
+    {
+        Entry entry = stack.Pop();
+        if (entry.distanceSquared > best) continue;
+
+        const Node &node = nodes[entry.node];
+        if (node.IsLeaf())
+        {
+            best = entry.distanceSquared;
+            userData = proxies[node.right].userData;
+            found = true;
+            continue;
+        }
+
+        Entry left = {node.left, DistanceSquared(nodes[node.left], point)};
+        Entry right = {node.right, DistanceSquared(nodes[node.right], point)};
+
+        //Push the closer child last, so it's visited first and shrinks the search as early as possible.
+        bool leftFirst = left.distanceSquared <= right.distanceSquared;
+        const Entry &first = leftFirst ? left : right;
+        const Entry &second = leftFirst ? right : left;
+
+        if (second.distanceSquared <= best) stack.Push(second);
+        if (first.distanceSquared <= best) stack.Push(first);
+    }
+
+    if (found) distance = std::sqrt(best);
+    return found;
+}
+
+int32_t BVH::AllocateNode()
+{
+    if (freeNode != NULL_NODE)
+    {
+        int32_t node = freeNode;
+        freeNode = nodes[node].right;
+        parents[node] = NULL_NODE;
+        return node;
+    }
+
+    nodes.emplace_back();
+    parents.push_back(NULL_NODE);
+    return (int32_t) nodes.size() - 1;
+}
+
+void BVH::FreeNode(int32_t node)
+{
+    nodes[node].left = FREE_NODE;
+    nodes[node].right = freeNode;
+    freeNode = node;
+}
+
+void BVH::InsertLeaf(int32_t leaf)
+{
+    if (root == NULL_NODE)
+    {
+        root = leaf;
+        parents[leaf] = NULL_NODE;
+        return;
+    }
+
+    glm::vec3 leafMin, leafMax;
+    FatBox(leaf, leafMin, leafMax);
+
+    //Walk down towards the sibling that adds the least surface area, stopping when pairing with the current node is
+    //cheaper than going any further.
+    int32_t index = root;
+    while (!nodes[index].IsLeaf())
+    {
+        const Node &node = nodes[index];
+
+        float area = SurfaceArea(node.min, node.max);
+        float combined = SurfaceArea(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+
+        float cost = 2.0f * combined;
+        float inheritance = 2.0f * (combined - area);
+
+        auto descendCost = [&](int32_t child)
+        {
+            glm::vec3 childMin, childMax;
+            FatBox(child, childMin, childMax);
+
+            float childCombined = SurfaceArea(glm::min(childMin, leafMin), glm::max(childMax, leafMax));
+            if (nodes[child].IsLeaf()) return childCombined + inheritance;
+            return childCombined - SurfaceArea(childMin, childMax) + inheritance;
+        };
+
+        float leftCost = descendCost(node.left);
+        float rightCost = descendCost(node.right);
+
+        if (cost < leftCost && cost < rightCost) break;
+        index = leftCost < rightCost ? node.left : node.right;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = parents[sibling];
+    int32_t newParent = AllocateNode();
+
+    glm::vec3 siblingMin, siblingMax;
+    FatBox(sibling, siblingMin, siblingMax);
+
+    nodes[newParent] = {glm::min(siblingMin, leafMin), sibling, glm::max(siblingMax, leafMax), leaf};
+    parents[newParent] = oldParent;
+    parents[sibling] = newParent;
+    parents[leaf] = newParent;
+
+    if (oldParent == NULL_NODE)
+    {
+        root = newParent;
+        return;
+    }
+
+    if (nodes[oldParent].left == sibling) nodes[oldParent].left = newParent;
+    else nodes[oldParent].right = newParent;
+
+    Refit(oldParent);
+}
+
+void BVH::RemoveLeaf(int32_t leaf)
+{
+    if (leaf == root)
+    {
+        root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = parents[leaf];
+    int32_t grandParent = parents[parent];
+    int32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    FreeNode(parent);
+    parents[sibling] = grandParent;
+
+    if (grandParent == NULL_NODE)
+    {
+        root = sibling;
+        return;
+    }
+
+    if (nodes[grandParent].left == parent) nodes[grandParent].left = sibling;
+    else nodes[grandParent].right = sibling;
+
+    Refit(grandParent);
+}
+
+void BVH::Refit(int32_t node)
+{
+    while (node != NULL_NODE)
+    {
+        glm::vec3 leftMin, leftMax, rightMin, rightMax;
+        FatBox(nodes[node].left, leftMin, leftMax);
+        FatBox(nodes[node].right, rightMin, rightMax);
+
+        glm::vec3 min = glm::min(leftMin, rightMin);
+        glm::vec3 max = glm::max(leftMax, rightMax);
+
+        Node &current = nodes[node];
+        if (current.min.x == min.x && current.min.y == min.y && current.min.z == min.z &&
+            current.max.x == max.x && current.max.y == max.y && current.max.z == max.z)
+        {
+            return;
+        }
+
+        current.min = min;
+        current.max = max;
+        node = parents[node];
+    }
+}
+
+void BVH::FatBox(int32_t node, glm::vec3 &min, glm::vec3 &max) const
+{
+    if (nodes[node].IsLeaf())
+    {
+        const Proxy &proxy = proxies[nodes[node].right];
+        min = proxy.fatMin;
+        max = proxy.fatMax;
+        return;
+    }
+
+    min = nodes[node].min;
+    max = nodes[node].max;
+}
+
+void BVH::Build(BuildEntry *entries, size_t count, int32_t index, int32_t parent)
+{
+    parents[index] = parent;
+
+    if (count == 1)
+    {
+        //Fat boxes are recentered on the current position, rather than wherever they were last moved to.
+        Proxy &proxy = proxies[entries[0].proxy];
+        proxy.fatMin = entries[0].min - glm::vec3(margin);
+        proxy.fatMax = entries[0].max + glm::vec3(margin);
+        proxy.node = index;
+
+        nodes[index] = {entries[0].min, NULL_NODE, entries[0].max, (int32_t) entries[0].proxy};
+        return;
+    }
+
+    auto centroidOf = [](const BuildEntry &entry)
+    {
+        return (entry.min + entry.max) * 0.5f;
+    };
+
+    glm::vec3 centroidMin = centroidOf(entries[0]);
+    glm::vec3 centroidMax = centroidMin;
+    for (size_t i = 1; i < count; i++)
+    {
+        centroidMin = glm::min(centroidMin, centroidOf(entries[i]));
+        centroidMax = glm::max(centroidMax, centroidOf(entries[i]));
+    }
+
+    glm::vec3 size = centroidMax - centroidMin;
+    int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+    float extent = size[axis];
+
+    size_t split = count / 2;
+
+    if (extent > 0.0f)
+    {
+        struct Bin
+        {
+            glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+            size_t count = 0;
+        };
+
+        Bin bins[SAH_BINS];
+        float scale = (float) SAH_BINS / extent;
+        auto binOf = [&](const BuildEntry &entry)
+        {
+            auto bin = (uint32_t) ((centroidOf(entry)[axis] - centroidMin[axis]) * scale);
+            return std::min(bin, SAH_BINS - 1);
+        };
+
+        //Every box grows by the same margin, which doesn't change which split is best by much.
+        for (size_t i = 0; i < count; i++)
+        {
+            Bin &bin = bins[binOf(entries[i])];
+            bin.min = glm::min(bin.min, entries[i].min);
+            bin.max = glm::max(bin.max, entries[i].max);
+            bin.count++;
+        }
+
+        //Cost of the right side of every split, swept from the right.
+        float rightCosts[SAH_BINS];
+        Bin rightBin;
+        for (uint32_t i = SAH_BINS - 1; i > 0; i--)
+        {
+            rightBin.min = glm::min(rightBin.min, bins[i].min);
+            rightBin.max = glm::max(rightBin.max, bins[i].max);
+            rightBin.count += bins[i].count;
+            rightCosts[i] = rightBin.count > 0 ? SurfaceArea(rightBin.min, rightBin.max) * (float) rightBin.count
+                                               : 0.0f;
+        }
+
+        Bin leftBin;
+        float bestCost = std::numeric_limits<float>::max();
+        uint32_t bestSplit = 0;
+        for (uint32_t i = 0; i + 1 < SAH_BINS; i++)
+        {
+            leftBin.min = glm::min(leftBin.min, bins[i].min);
+            leftBin.max = glm::max(leftBin.max, bins[i].max);
+            leftBin.count += bins[i].count;
+
+            if (leftBin.count == 0 || leftBin.count == count) continue;
+
+            float cost = SurfaceArea(leftBin.min, leftBin.max) * (float) leftBin.count + rightCosts[i + 1];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestSplit = i + 1;
+            }
+        }
+
+        if (bestSplit > 0)
+        {
+            BuildEntry *middle = std::partition(entries, entries + count, [&](const BuildEntry &entry)
+            {
+                return binOf(entry) < bestSplit;
+            });
+            split = middle - entries;
+        }
+    }
+
+    //Everything in one spot, or all in a single bin. Any split is as good as another.
+    if (split == 0 || split == count) split = count / 2;
+
+    //Nodes are laid out depth first, so the left child always directly follows its parent.
+    int32_t left = index + 1;
+    int32_t right = index + (int32_t) (2 * split);
+
+    JobSystem *jobSystem = JobSystem::GetInstance();
+    if (jobSystem != nullptr && jobSystem->ThreadCount() > 1 && count >= PARALLEL_BUILD_MIN)
+    {
+        JobCounter counter;
+        jobSystem->Run([this, entries, split, left, index]()
+                       {
+                           Build(entries, split, left, index);
+                       }, &counter);
+        Build(entries + split, count - split, right, index);
+        jobSystem->Wait(counter);
+    }
+    else
+    {
+        Build(entries, split, left, index);
+        Build(entries + split, count - split, right, index);
+    }
+
+    glm::vec3 leftMin, leftMax, rightMin, rightMax;
+    FatBox(left, leftMin, leftMax);
+    FatBox(right, rightMin, rightMax);
+
+    nodes[index] = {glm::min(leftMin, rightMin), left, glm::max(leftMax, rightMax), right};
+}
@@ -0,0 +1,376 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_BVH_H
+#define RELIC_BVH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include <glm/vec3.hpp>
+#include <Graphics/Model.h>
+#include <Graphics/FrustumCulling.h>
+
+/// Dynamic bounding volume hierarchy over axis aligned boxes, with one box per leaf.
+///
+/// Every box is registered as a proxy, whose id stays the same until it's removed. Internal nodes are built around
+/// slightly enlarged ("fat") copies of the boxes, so a box that moves a little doesn't touch the tree at all, and one
+/// that leaves its fat box only refits its ancestors. Refitting makes the tree worse over time, Maintain rebuilds it
+/// from scratch with the surface area heuristic once it has degraded enough.
+///
+/// Nodes live in a single array. After a rebuild they are laid out depth first, so the left child of a node is always
+/// the next one in memory. Queries can run from several threads at once, as long as nothing modifies the tree.
+class BVH
+{
+public:
+    static constexpr uint32_t INVALID_PROXY = UINT32_MAX;
+
+    /// \param margin Distance boxes are enlarged by in every direction, before they're put in the tree.
+    explicit BVH(float margin = 0.1f);
+
+    /// Add a box.
+    /// \param bounds The box, the sphere is ignored.
+    /// \param userData Value passed to query callbacks for this box.
+    /// \return Proxy id of the box.
+    uint32_t Insert(const Bounds &bounds, uint32_t userData);
+
+    /// Move a box.
+    /// \param proxy Proxy id returned by Insert.
+    /// \param bounds The new box.
+    /// \return True if the box left its fat box and the tree had to be refit.
+    bool Update(uint32_t proxy, const Bounds &bounds);
+
+    void Remove(uint32_t proxy);
+
+    void Clear();
+
+    /// Rebuild the whole tree with the surface area heuristic.
+    void Rebuild();
+
+    /// Rebuild the tree if it has become noticeably worse than it was after the last rebuild. Cheap unless a good part
+    /// of the boxes have moved since the last check.
+    /// \return True if the tree was rebuilt.
+    bool Maintain();
+
+    /// Surface area heuristic cost of the tree, relative to the area of the root. Lower is better.
+    [[nodiscard]] float Cost() const;
+
+    /// Number of boxes in the tree.
+    [[nodiscard]] size_t Size() const;
+
+    [[nodiscard]] uint32_t Height() const;
+
+    [[nodiscard]] uint32_t UserData(uint32_t proxy) const;
+
+    /// Find every box that is at least partially inside a frustum.
+    /// \param function Callable taking (uint32_t userData).
+    template<typename F>
+    void QueryFrustum(const Frustum &frustum, F &&function) const;
+
+    /// Find every box that overlaps another one.
+    /// \param function Callable taking (uint32_t userData).
+    template<typename F>
+    void QueryOverlap(const Bounds &bounds, F &&function) const;
+
+    /// Find boxes hit by a ray, roughly front to back.
+    /// \param origin Start of the ray.
+    /// \param direction Direction of the ray, distances are in multiples of its length.
+    /// \param maxDistance Length of the ray.
+    /// \param function Callable taking (uint32_t userData, float distance), where distance is where the ray enters the
+    /// box. Returns the new length of the ray: the distance of an exact hit to only look for closer ones, maxDistance
+    /// to keep going, or 0 to stop.
+    template<typename F>
+    void Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, F &&function) const;
+
+    /// Find the box closest to a point.
+    /// \param point The point.
+    /// \param maxDistance Boxes further away than this are ignored.
+    /// \param userData Receives the user data of the closest box.
+    /// \param distance Receives the distance to the closest box, 0 if the point is inside it.
+    /// \return False if no box was within maxDistance.
+    bool Nearest(const glm::vec3 &point, float maxDistance, uint32_t &userData, float &distance) const;
+
+private:
+    static constexpr int32_t NULL_NODE = -1;
+
+    //Rebuilding is only considered once this fraction of the boxes left their fat box since the last check.
+    static constexpr float MAINTAIN_REFIT_FRACTION = 0.1f;
+
+    //And only done if the cost grew by this much.
+    static constexpr float MAINTAIN_COST_RATIO = 1.25f;
+
+    static constexpr uint32_t SAH_BINS = 16;
+
+    /// 32 bytes, two to a cache line. Leaves have no left child and keep their proxy id in place of the right one.
+    struct Node
+    {
+        glm::vec3 min;
+        int32_t left;
+        glm::vec3 max;
+        int32_t right;
+
+        [[nodiscard]] bool IsLeaf() const
+        {
+            return left == NULL_NODE;
+        }
+    };
+
+    struct Proxy
+    {
+        glm::vec3 fatMin;
+        glm::vec3 fatMax;
+        int32_t node;
+        uint32_t userData;
+    };
+
+    //Subtrees with fewer leaves than this are built on the calling thread during a rebuild.
+    static constexpr size_t PARALLEL_BUILD_MIN = 16384;
+
+    /// Leaf waiting to be placed during a rebuild.
+    struct BuildEntry
+    {
+        glm::vec3 min;
+        glm::vec3 max;
+        uint32_t proxy;
+    };
+
+    /// Stack for walking the tree without allocating, unless it's unusually deep.
+    template<typename T>
+    class TraversalStack
+    {
+    public:
+        void Push(const T &value)
+        {
+            if (count < INLINE_SIZE) items[count] = value;
+            else overflow.push_back(value);
+            count++;
+        }
+
+        T Pop()
+        {
+            count--;
+            if (count < INLINE_SIZE) return items[count];
+
+            T value = overflow.back();
+            overflow.pop_back();
+            return value;
+        }
+
+        [[nodiscard]] bool Empty() const
+        {
+            return count == 0;
+        }
+
+    private:
+        static constexpr size_t INLINE_SIZE = 128;
+
+        T items[INLINE_SIZE];
+        std::vector<T> overflow;
+        size_t count = 0;
+    };
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+
+    /// Recalculate the boxes of a node and its ancestors, stopping early once one doesn't change.
+    void Refit(int32_t node);
+
+    /// Box the parent of a node has to contain, the fat box for leaves.
+    void FatBox(int32_t node, glm::vec3 &min, glm::vec3 &max) const;
+
+    /// Build the subtree for a range of leaves at a given node. A subtree of n leaves always takes up 2n - 1 nodes, so
+    /// where every subtree goes is known up front and they can be built in parallel.
+    void Build(BuildEntry *entries, size_t count, int32_t index, int32_t parent);
+
+    static float SurfaceArea(const glm::vec3 &min, const glm::vec3 &max)
+    {
+        glm::vec3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    static bool Overlaps(const Node &node, const glm::vec3 &min, const glm::vec3 &max)
+    {
+        return node.min.x <= max.x && node.max.x >= min.x &&
+               node.min.y <= max.y && node.max.y >= min.y &&
+               node.min.z <= max.z && node.max.z >= min.z;
+    }
+
+    /// Distance along a ray to where it enters a node, infinity if it misses.
+    static float RayDistance(const Node &node, const glm::vec3 &origin, const glm::vec3 &inverseDirection,
+                             float maxDistance)
+    {
+        float enter = 0.0f;
+        float exit = maxDistance;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float t0 = (node.min[axis] - origin[axis]) * inverseDirection[axis];
+            float t1 = (node.max[axis] - origin[axis]) * inverseDirection[axis];
+            if (t0 > t1) std::swap(t0, t1);
+
+            //Written so that NaNs, from a ray lying in a slab boundary, leave the interval alone.
+            enter = t0 > enter ? t0 : enter;
+            exit = t1 < exit ? t1 : exit;
+        }
+
+        return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+    }
+
+    static float DistanceSquared(const Node &node, const glm::vec3 &point)
+    {
+        float total = 0.0f;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float offset = std::max(std::max(node.min[axis] - point[axis], point[axis] - node.max[axis]), 0.0f);
+            total += offset * offset;
+        }
+        return total;
+    }
+
+    float margin;
+
+    std::vector<Node> nodes;
+    std::vector<int32_t> parents;
+    int32_t root = NULL_NODE;
+    int32_t freeNode = NULL_NODE;
+
+    std::vector<Proxy> proxies;
+    std::vector<uint32_t> freeProxies;
+    size_t leafCount = 0;
+
+    float rebuildCost = 0.0f;
+    size_t refitsSinceCheck = 0;
+
+    std::vector<BuildEntry> buildEntries;
+};
+
+template<typename F>
+void BVH::QueryFrustum(const Frustum &frustum, F &&function) const
+{
+    if (root == NULL_NODE) return;
+
+    //Each entry carries the planes its node still has to be tested against, a node entirely inside a plane doesn't
+    //need its children tested against it either.
+    struct Entry
+    {
+        int32_t node;
+        uint32_t planes;
+    };
+
+    TraversalStack<Entry> stack;
+    stack.Push({root, (1u << 6u) - 1u});
+
+    while (!stack.Empty())
+    {
+        Entry entry = stack.Pop();
+        const Node &node = nodes[entry.node];
+
+        glm::vec3 center = (node.min + node.max) * 0.5f;
+        glm::vec3 extents = (node.max - node.min) * 0.5f;
+
+        bool outside = false;
+        for (uint32_t plane = 0; plane < 6 && !outside; plane++)
+        {
+            if ((entry.planes & (1u << plane)) == 0) continue;
+
+            const glm::vec4 &p = frustum.planes[plane];
+            float distance = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+            float radius = std::abs(p.x) * extents.x + std::abs(p.y) * extents.y + std::abs(p.z) * extents.z;
+
+            if (distance + radius < 0.0f) outside = true;
+            else if (distance - radius >= 0.0f) entry.planes &= ~(1u << plane);
+        }
+
+        if (outside) continue;
+
+        if (node.IsLeaf())
+        {
+            function(proxies[node.right].userData);
+            continue;
+        }
+
+        stack.Push({node.right, entry.planes});
+        stack.Push({node.left, entry.planes});
+    }
+}
+
+template<typename F>
+void BVH::QueryOverlap(const Bounds &bounds, F &&function) const
+{
+    if (root == NULL_NODE) return;
+
+    glm::vec3 min = bounds.center - bounds.extents;
+    glm::vec3 max = bounds.center + bounds.extents;
+
+    TraversalStack<int32_t> stack;
+    stack.Push(root);
+
+    while (!stack.Empty())
+    {
+        const Node &node = nodes[stack.Pop()];
+        if (!Overlaps(node, min, max)) continue;
+
+        if (node.IsLeaf())
+        {
+            function(proxies[node.right].userData);
+            continue;
+        }
+
+        stack.Push(node.right);
+        stack.Push(node.left);
+    }
+}
+
+template<typename F>
+void BVH::Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, F &&function) const
+{
+    if (root == NULL_NODE) return;
+
+    glm::vec3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+    struct Entry
+    {
+        int32_t node;
+        float distance;
+    };
+
+    TraversalStack<Entry> stack;
+    float rootDistance = RayDistance(nodes[root], origin, inverseDirection, maxDistance);
+    if (rootDistance <= maxDistance) stack.Push({root, rootDistance});
+
+    while (!stack.Empty())
+    {
+        Entry entry = stack.Pop();
+
+        //The ray may have been shortened since this node was pushed.
+        if (entry.distance > maxDistance) continue;
+
+        const Node &node = nodes[entry.node];
+        if (node.IsLeaf())
+        {
+            maxDistance = std::min(maxDistance, function(proxies[node.right].userData, entry.distance));
+            if (maxDistance <= 0.0f) return;
+            continue;
+        }
+
+        float leftDistance = RayDistance(nodes[node.left], origin, inverseDirection, maxDistance);
+        float rightDistance = RayDistance(nodes[node.right], origin, inverseDirection, maxDistance);
+
+        //Push the closer child last, so it's visited first.
+        bool leftFirst = leftDistance <= rightDistance;
+        Entry first = leftFirst ? Entry{node.left, leftDistance} : Entry{node.right, rightDistance};
+        Entry second = leftFirst ? Entry{node.right, rightDistance} : Entry{node.left, leftDistance};
+
+        if (second.distance <= maxDistance) stack.Push(second);
+        if (first.distance <= maxDistance) stack.Push(first);
+    }
+}
+
+#endif //RELIC_BVH_H
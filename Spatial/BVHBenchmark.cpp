@@ -0,0 +1,153 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include <string>
+#include <chrono>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include "BVH.h"
+#include <Debugging/Benchmark.h>
+#include <Debugging/Logger.h>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static const uint32_t BVH_OBJECT_COUNTS[] = {10000, 100000, 1000000};
+static const uint32_t BVH_QUERY_COUNT = 10000;
+
+//Fraction of the objects moved per simulated frame.
+static const float BVH_MOVING_FRACTION = 0.1f;
+
+static std::string Rate(uint32_t count, double seconds)
+{
+    return std::to_string(count / seconds / 1e6) + "M/s";
+}
+
+/// Insert, move and query a set of objects spread evenly through a cube that grows with the object count, so the
+/// density (and with it the number of results per query) stays the same.
+static void MeasureObjectCount(uint32_t objectCount)
+{
+    float worldSize = std::cbrt((float) objectCount) * 10.0f;
+
+    std::mt19937 random(objectCount);
+    std::uniform_real_distribution<float> position(-worldSize, worldSize);
+    std::uniform_real_distribution<float> extent(0.5f, 2.0f);
+    std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Bounds> objects(objectCount);
+    for (Bounds &bounds : objects)
+    {
+        bounds = {glm::vec3(position(random), position(random), position(random)),
+                  glm::vec3(extent(random), extent(random), extent(random)), 0.0f};
+    }
+
+    Logger::Log("%i objects:", objectCount);
+
+    BVH bvh;
+    std::vector<uint32_t> proxies(objectCount);
+
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < objectCount; i++) proxies[i] = bvh.Insert(objects[i], i);
+    Logger::Log("  Insert: %s, height %i", Rate(objectCount, Benchmark::SecondsSince(start)).c_str(), bvh.Height());
+
+    start = Clock::now();
+    bvh.Rebuild();
+    Logger::Log("  SAH rebuild: %sms, height %i, cost %s",
+                std::to_string(Benchmark::SecondsSince(start) * 1000.0).c_str(),
+                bvh.Height(), std::to_string(bvh.Cost()).c_str());
+
+    //A few frames of a part of the objects wandering around, with Maintain deciding when to rebuild.
+    auto movingCount = (uint32_t) ((float) objectCount * BVH_MOVING_FRACTION);
+    uint32_t updates = 0;
+    uint32_t rebuilds = 0;
+
+    start = Clock::now();
+    for (uint32_t frame = 0; frame < 30; frame++)
+    {
+        for (uint32_t i = 0; i < movingCount; i++)
+        {
+            Bounds &bounds = objects[i];
+            bounds.center += glm::vec3(step(random), step(random), step(random));
+            bvh.Update(proxies[i], bounds);
+        }
+        updates += movingCount;
+        rebuilds += bvh.Maintain() ? 1 : 0;
+    }
+    Logger::Log("  Update: %s including %i rebuilds, cost %s", Rate(updates, Benchmark::SecondsSince(start)).c_str(),
+                rebuilds, std::to_string(bvh.Cost()).c_str());
+
+    //Small queries, like looking for anything close to an entity.
+    uint64_t results = 0;
+    start = Clock::now();
+    for (uint32_t i = 0; i < BVH_QUERY_COUNT; i++)
+    {
+        Bounds query = {glm::vec3(position(random), position(random), position(random)), glm::vec3(5.0f), 0.0f};
+        bvh.QueryOverlap(query, [&results](uint32_t)
+        { results++; });
+    }
+    Logger::Log("  Overlap: %s queries, %s results each", Rate(BVH_QUERY_COUNT, Benchmark::SecondsSince(start)).c_str(),
+                std::to_string((double) results / BVH_QUERY_COUNT).c_str());
+
+    results = 0;
+    start = Clock::now();
+    for (uint32_t i = 0; i < BVH_QUERY_COUNT; i++)
+    {
+        glm::vec3 origin(position(random), position(random), position(random));
+        glm::vec3 direction = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+
+        //Closest hit, treating the boxes as exact.
+        bvh.Raycast(origin, direction, worldSize, [&results](uint32_t, float distance)
+        {
+            results++;
+            return distance;
+        });
+    }
+    Logger::Log("  Ray: %s queries, %s boxes hit each", Rate(BVH_QUERY_COUNT, Benchmark::SecondsSince(start)).c_str(),
+                std::to_string((double) results / BVH_QUERY_COUNT).c_str());
+
+    results = 0;
+    start = Clock::now();
+    for (uint32_t i = 0; i < BVH_QUERY_COUNT; i++)
+    {
+        uint32_t userData;
+        float distance;
+        glm::vec3 point(position(random), position(random), position(random));
+        results += bvh.Nearest(point, worldSize, userData, distance) ? 1 : 0;
+    }
+    Logger::Log("  Nearest: %s queries", Rate(BVH_QUERY_COUNT, Benchmark::SecondsSince(start)).c_str());
+
+    //A camera in the middle looking down one axis, sees roughly a tenth of the objects.
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, worldSize);
+    Frustum frustum = ExtractFrustum(proj * view);
+
+    results = 0;
+    start = Clock::now();
+    bvh.QueryFrustum(frustum, [&results](uint32_t)
+    { results++; });
+    double treeSeconds = Benchmark::SecondsSince(start);
+
+    CullingBatch batch;
+    batch.Resize(objectCount);
+    for (uint32_t i = 0; i < objectCount; i++) batch.Set(i, objects[i]);
+
+    std::vector<uint32_t> visible;
+    start = Clock::now();
+    batch.Cull(frustum, visible);
+    double batchSeconds = Benchmark::SecondsSince(start);
+
+    Logger::Log("  Frustum: %sms for %i objects, flat SIMD cull %sms for %i",
+                std::to_string(treeSeconds * 1000.0).c_str(), (int) results,
+                std::to_string(batchSeconds * 1000.0).c_str(), (int) visible.size());
+}
+
+static void RunBVHBenchmark()
+{
+    for (uint32_t objectCount : BVH_OBJECT_COUNTS)
+    {
+        MeasureObjectCount(objectCount);
+    }
+}
+
+static BenchmarkRegistrar registrar("bvh", &RunBVHBenchmark);
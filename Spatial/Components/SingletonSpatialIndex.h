@@ -0,0 +1,25 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_SINGLETONSPATIALINDEX_H
+#define RELIC_SINGLETONSPATIALINDEX_H
+
+#include <Libraries/entt/entt.hpp>
+#include <Spatial/BVH.h>
+
+/// Spatial index over the world bounds of every entity that has them, maintained by the SpatialIndex system. Use it
+/// instead of scanning the registry for anything that only cares about part of the world, e.g. picking or finding
+/// nearby entities. Up to date once SpatialIndex has run for the frame, read only everywhere else.
+struct SingletonSpatialIndex
+{
+    //User data of every box is the entity it belongs to, see Entity.
+    BVH bvh;
+
+    static entt::entity Entity(uint32_t userData)
+    {
+        return static_cast<entt::entity>(userData);
+    }
+};
+
+#endif //RELIC_SINGLETONSPATIALINDEX_H
@@ -0,0 +1,16 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_SPATIALPROXYCOMPONENT_H
+#define RELIC_SPATIALPROXYCOMPONENT_H
+
+#include <cstdint>
+
+/// Links an entity to its box in the spatial index. Added and removed by the SpatialIndex system.
+struct SpatialProxyComponent
+{
+    uint32_t proxy;
+};
+
+#endif //RELIC_SPATIALPROXYCOMPONENT_H
@@ -0,0 +1,83 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#include "SpatialIndex.h"
+#include <Core/World.h>
+#include <Core/Components/WorldBoundsComponent.h>
+#include <Spatial/Components/SpatialProxyComponent.h>
+
+SpatialIndex::SpatialIndex()
+{
+    NeedsTick = false;
+    NeedsFrameTick = true;
+
+    Reads<WorldBoundsComponent>();
+    Writes<SpatialProxyComponent>();
+    Writes<SingletonSpatialIndex>();
+}
+
+void SpatialIndex::Tick(World &world)
+{
+}
+
+void SpatialIndex::FrameTick(World &world)
+{
+    auto registry = world.Registry();
+    auto bounds = registry->view<const WorldBoundsComponent>();
+
+    //Bounds that are still dirty haven't been calculated yet, they're picked up on a later frame.
+    added.clear();
+    for (auto entity : registry->view<const WorldBoundsComponent>(entt::exclude<SpatialProxyComponent>))
+    {
+        if (!bounds.get(entity).dirty) added.push_back(entity);
+    }
+
+    for (auto entity : added)
+    {
+        uint32_t proxy = index.bvh.Insert(bounds.get(entity).bounds, entt::to_integral(entity));
+        registry->emplace<SpatialProxyComponent>(entity, proxy);
+    }
+
+    auto tracked = registry->view<const WorldBoundsComponent, const SpatialProxyComponent>();
+    for (auto entity : tracked)
+    {
+        const WorldBoundsComponent &worldBounds = tracked.get<const WorldBoundsComponent>(entity);
+        if (!worldBounds.changed) continue;
+
+        index.bvh.Update(tracked.get<const SpatialProxyComponent>(entity).proxy, worldBounds.bounds);
+    }
+
+    index.bvh.Maintain();
+}
+
+void SpatialIndex::OnBoundsDestruction(entt::registry &registry, entt::entity entity)
+{
+    registry.remove_if_exists<SpatialProxyComponent>(entity);
+}
+
+void SpatialIndex::OnProxyDestruction(entt::registry &registry, entt::entity entity)
+{
+    index.bvh.Remove(registry.get<SpatialProxyComponent>(entity).proxy);
+}
+
+void SpatialIndex::Init(World &world)
+{
+    auto registry = world.Registry();
+
+    registry->set<SingletonSpatialIndex *>(&index);
+    registry->on_destroy<WorldBoundsComponent>().connect<&SpatialIndex::OnBoundsDestruction>(this);
+    registry->on_destroy<SpatialProxyComponent>().connect<&SpatialIndex::OnProxyDestruction>(this);
+}
+
+void SpatialIndex::Shutdown(World &world)
+{
+    auto registry = world.Registry();
+
+    registry->on_destroy<WorldBoundsComponent>().disconnect<&SpatialIndex::OnBoundsDestruction>(this);
+    registry->on_destroy<SpatialProxyComponent>().disconnect<&SpatialIndex::OnProxyDestruction>(this);
+    registry->clear<SpatialProxyComponent>();
+    registry->unset<SingletonSpatialIndex *>();
+
+    index.bvh.Clear();
+}
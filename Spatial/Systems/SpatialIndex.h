@@ -0,0 +1,32 @@
+//
+// Created by mikag on 17/10/2026.
+//
+
+#ifndef RELIC_SPATIALINDEX_H
+#define RELIC_SPATIALINDEX_H
+
+#include <Core/ISystem.h>
+#include <Spatial/Components/SingletonSpatialIndex.h>
+
+/// Keeps SingletonSpatialIndex in sync with WorldBoundsComponent. Entities are added once their bounds have been
+/// calculated, moved when their bounds change and removed along with their bounds. The tree is rebuilt whenever it has
+/// degraded too far. Registered right after WorldBounds.
+class SpatialIndex : public ISystem
+{
+public:
+    SpatialIndex();
+
+    void Tick(World &world) override;
+    void FrameTick(World &world) override;
+    void Init(World &world) override;
+    void Shutdown(World &world) override;
+
+private:
+    void OnBoundsDestruction(entt::registry &registry, entt::entity entity);
+    void OnProxyDestruction(entt::registry &registry, entt::entity entity);
+
+    SingletonSpatialIndex index;
+    std::vector<entt::entity> added;
+};
+
+#endif //RELIC_SPATIALINDEX_H
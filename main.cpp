@@ -1,8 +1,38 @@
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
 #include <Core/Relic.h>
+#include <Debugging/Benchmark.h>
 
-int main()
+int main(int argc, char **argv)
 {
-    Relic relic;
-    relic.Start();
+    RelicOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+        {
+            return Benchmark::Run(argv[i + 1]) ? 0 : 1;
+        }
+
+        if (strcmp(argv[i], "--headless") == 0)
+        {
+            options.headless = true;
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+        {
+            options.tickRate = (float) atof(argv[++i]);
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            options.maxTicks = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--gpu-culling") == 0)
+        {
+            options.gpuCulling = true;
+        } else if (strcmp(argv[i], "--test-meshes") == 0 && i + 1 < argc)
+        {
+            options.testMeshes = (uint32_t) strtoul(argv[++i], nullptr, 10);
+        }
+    }
+
+    Relic relic(options);
+    return relic.Start();
 }
\ No newline at end of file